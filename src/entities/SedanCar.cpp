@@ -8,16 +8,24 @@
  */
 SedanCar::SedanCar(float startDist, float velocity, vec3 color, int maxCells,
                    float maxV, float probSlow)
+    : SedanCar(VEHICLE_SEDAN, startDist, velocity, color, maxCells, maxV,
+               probSlow) {}
+
+/**
+ * Constructor per jenis kendaraan
+ *
+ * Ambil length dan skala maxV/probSlow dari VehicleSpec.
+ */
+SedanCar::SedanCar(VehicleType type, float startDist, float velocity,
+                   vec3 color, int maxCells, float maxV, float probSlow)
     : Vehicle(startDist, velocity, color), storedMaxCells(maxCells),
-      storedMaxV(maxV) {
-  movementStrat = std::make_unique<NaSchMovement>(maxCells, maxV, probSlow);
-
-  // Init segments untuk physics simulation
-  int numSegments = 15;
-  for (int i = 0; i < numSegments; i++) {
-    // Awalnya semua numpuk di startDist, atau berjejer ke belakang
-    segmentDistances.push_back(startDist - (i * 2.0f));
-  }
+      storedMaxV(maxV * getVehicleSpec(type).maxVScale) {
+  const VehicleSpec &spec = getVehicleSpec(type);
+  this->type = type;
+  this->length = spec.length;
+
+  movementStrat = std::make_unique<NaSchMovement>(
+      maxCells, maxV * spec.maxVScale, probSlow * spec.probSlowScale);
 }
 
 /**
@@ -89,10 +97,25 @@ void SedanCar::setGrid(const int *gridPtr, int gridSize) {
   }
 }
 
-void SedanCar::updateBody(const std::vector<glm::vec2> &newPoints) {
-  if (newPoints.empty())
+void SedanCar::setLeaderDistance(int cells) {
+  NaSchMovement *naschStrat = dynamic_cast<NaSchMovement *>(movementStrat.get());
+  if (naschStrat) {
+    naschStrat->setLeaderDistance(cells);
+  }
+}
+
+void SedanCar::setRandom(const CounterRng *rng, uint64_t step, uint32_t index) {
+  NaSchMovement *naschStrat = dynamic_cast<NaSchMovement *>(movementStrat.get());
+  if (naschStrat) {
+    naschStrat->setRandom(rng, step, index);
+  }
+}
+
+void SedanCar::updateBody(const glm::vec2 *newPoints, size_t count) {
+  if (count == 0)
     return;
-  bodyPoints = newPoints;
+  // assign() memakai ulang kapasitas bodyPoints (jumlah segmen tetap)
+  bodyPoints.assign(newPoints, newPoints + count);
 }
 
 /**
@@ -111,10 +134,7 @@ void SedanCar::drawBody() {
 
   // Ambil velocity
   float v = getVelocity();
-
-  // Size berdasarkan velocity (lambat = besar, cepat = kecil)
-  // maxV disimpan di storedMaxV
-  float size = ofMap(v, 0, storedMaxV, 20, 10);
+  float size = getDrawSize();
 
   // Warna: merah jika macet (v ≈ 0), warna mobil jika jalan
   vec3 col = getColor();
@@ -133,3 +153,10 @@ void SedanCar::drawBody() {
   }
 
 }
+
+float SedanCar::getDrawSize() const {
+  // Size berdasarkan velocity (lambat = besar, cepat = kecil)
+  // maxV disimpan di storedMaxV
+  // Skala ukuran per jenis kendaraan (motor kecil, bus besar)
+  return ofMap(getVelocity(), 0, storedMaxV, 20, 10) * getVehicleSpec(type).drawScale;
+}
@@ -16,9 +16,9 @@
  * - Template Method: update() dan draw() di-override
  *
  * Catatan:
- * - Nama "SedanCar" karena nanti bisa ada jenis lain:
- *   - Motorcycle, Truck, Bus, SportsCar, dll
- * - Semua jenis vehicle akan inherit dari Vehicle
+ * - Nama "SedanCar" karena ada jenis lain (lihat VehicleTypes.h):
+ *   - Motorcycle, Truck, Bus, Bicycle
+ * - Jenis lain inherit dari SedanCar dan hanya beda data (VehicleSpec)
  */
 class SedanCar : public Vehicle {
 public:
@@ -90,12 +90,39 @@ public:
    */
   void setGrid(const int *gridPtr, int gridSize) override;
 
-  void updateBody(const std::vector<glm::vec2> &newPoints);
+  // Jarak ke cell terisi di depan, pengganti grid (di-pass ke strategy)
+  void setLeaderDistance(int cells) override;
 
-  // Getter for physics simulation
-  std::vector<float> &getSegmentDistances() { return segmentDistances; }
+  // Random generator track + step + indeks kendaraan (di-pass ke strategy)
+  void setRandom(const CounterRng *rng, uint64_t step, uint32_t index) override;
+
+  // Salin body point baru (boleh dari scratch FrameArena)
+  void updateBody(const glm::vec2 *newPoints, size_t count);
+
+  // Kapasitas body point di depan (kendaraan pool hybrid belum pernah update)
+  void reserveBody(size_t count) { bodyPoints.reserve(count); }
+
+  // Body points hasil physics (distance segment ada di TrackInstance::bodies)
+  const std::vector<vec2> &getBodyPoints() const { return bodyPoints; }
   void drawBody();
 
+  // Radius lingkaran mobil (lambat = besar, cepat = kecil, skala per jenis)
+  float getDrawSize() const;
+
+protected:
+  /**
+   * Constructor untuk jenis kendaraan lain (Motorcycle, Truck, Bus, Bicycle)
+   *
+   * Semua jenis memakai body & NaSchMovement yang sama dengan SedanCar,
+   * bedanya hanya DATA dari VehicleSpec (length, skala maxV & probSlow).
+   * Jadi update() tetap satu implementasi, tanpa dispatch per jenis.
+   *
+   * @param maxV maxV track (dikali maxVScale jenis ini)
+   * @param probSlow probSlow track (dikali probSlowScale jenis ini)
+   */
+  SedanCar(VehicleType type, float startDist, float velocity, vec3 color,
+           int maxCells, float maxV, float probSlow);
+
 private:
   // Parameter yang disimpan (optional, kalau butuh akses nanti)
   int storedMaxCells; // Disimpan untuk referensi
@@ -103,8 +130,4 @@ private:
 
   // Body system - points yang menyusun bentuk mobil
   std::vector<vec2> bodyPoints;
-
-  // PHYSICS: Simpan jarak (distance) tiap segment
-  // Index 0 = HEAD, Index N = TAIL
-  std::vector<float> segmentDistances;
 };
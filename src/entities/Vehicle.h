@@ -1,5 +1,7 @@
 ﻿#pragma once
+#include "../simulation/CounterRng.h"
 #include "../strategies/MovementStrategy.h"
+#include "VehicleSpec.h"
 #include <glm/glm.hpp>
 #include <memory>
 
@@ -19,6 +21,9 @@ using glm::vec3;
  * - Bicycle (sepeda)
  * - dll
  *
+ * Perbedaan antar jenis (panjang, maxV, probSlow) disimpan sebagai data
+ * (lihat VehicleSpec.h), bukan lewat virtual method per jenis.
+ *
  * Class ini tidak bisa langsung di-instantiate karena ada method virtual murni.
  *
  * Design Pattern: Strategy Pattern + Template Method
@@ -32,6 +37,10 @@ public:
 	Vehicle(float startDist, float velocity, vec3 col) : distance(startDist)
 		, v(velocity)
 		, color(col)
+		, lane(0)
+		, type(VEHICLE_SEDAN)
+		, length(VEHICLE_SPECS[VEHICLE_SEDAN].length)
+		, recordId(0)
 		, movementStrat(nullptr)
 	{
 	}
@@ -76,6 +85,32 @@ public:
 		color = col;
 	}
 
+	virtual int getLane() const {
+		return lane;
+	}
+
+	virtual void setLane(int l) {
+		lane = l;
+	}
+
+	// Jenis & panjang kendaraan: SENGAJA non-virtual (dibaca di hot loop grid)
+	VehicleType getType() const {
+		return type;
+	}
+
+	int getLength() const {
+		return length;
+	}
+
+	// Nomor kendaraan di rekaman trajektori (lihat recordId)
+	uint32_t getRecordId() const {
+		return recordId;
+	}
+
+	void setRecordId(uint32_t id) {
+		recordId = id;
+	}
+
 	/**
  * Set movement strategy untuk mobil ini
  *
@@ -88,6 +123,12 @@ public:
 
 	virtual void setGrid(const int* gridPtr, int gridSize){}
 
+	// Tanpa grid (SparseOccupancy): jarak ke cell terisi pertama di depan
+	virtual void setLeaderDistance(int cells){}
+
+	// Random generator track untuk step ini (randomize NaSch deterministik)
+	virtual void setRandom(const CounterRng* rng, uint64_t step, uint32_t index){}
+
 	// Set max velocity di movement strategy
 	virtual void setMaxVelocity(float maxV) {
 		if (movementStrat) {
@@ -126,6 +167,33 @@ protected:
  */
 	vec3 color;
 
+    /**
+ * lane - Indeks lajur (multi-lane track)
+ *
+ * - 0 = lajur paling kanan (lajur lambat)
+ * - numLanes - 1 = lajur paling kiri (lajur cepat)
+ * Track single-lane selalu 0.
+ */
+	int lane;
+
+    /**
+ * type & length - Jenis kendaraan dan panjangnya dalam cells
+ *
+ * Di-set oleh concrete class dari VehicleSpec.
+ * length dipakai untuk occupancy: kendaraan menempati cell
+ * (distance - length + 1) sampai distance di grid.
+ */
+	VehicleType type;
+	int length;
+
+    /**
+ * recordId - Urutan kendaraan di track saat rekaman dimulai
+ *
+ * Tetap menempel ke kendaraan selama compaction (black hole), jadi
+ * replay tahu kendaraan mana yang hilang, bukan sekadar berapa.
+ */
+	uint32_t recordId;
+
     /**
  * movementStrat - Strategy yang mengontrol movement mobil
  *
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * VehicleType - Jenis kendaraan
+ *
+ * Disimpan sebagai DATA di Vehicle (bukan lewat virtual method per jenis),
+ * jadi track dengan campuran jenis kendaraan punya biaya per kendaraan yang
+ * sama dengan track yang isinya SedanCar semua.
+ */
+enum VehicleType {
+  VEHICLE_SEDAN = 0,
+  VEHICLE_MOTORCYCLE,
+  VEHICLE_TRUCK,
+  VEHICLE_BUS,
+  VEHICLE_BICYCLE,
+  VEHICLE_TYPE_COUNT
+};
+
+/**
+ * VehicleSpec - Parameter per jenis kendaraan
+ *
+ * - length: panjang kendaraan dalam cells (occupancy di grid)
+ * - maxVScale: maxV kendaraan = maxV track * maxVScale
+ * - probSlowScale: probSlow kendaraan = probSlow track * probSlowScale
+ * - drawScale: skala ukuran lingkaran saat digambar
+ *
+ * maxV dan probSlow ditulis relatif terhadap track karena skala kecepatan
+ * tiap track sangat berbeda (outer=20, inner=5, SpiralRoad < 2).
+ */
+struct VehicleSpec {
+  const char *name;
+  int length;
+  float maxVScale;
+  float probSlowScale;
+  float drawScale;
+};
+
+// Sedan = referensi (length 45 = carSize lama di NaSchMovement::brake)
+static const VehicleSpec VEHICLE_SPECS[VEHICLE_TYPE_COUNT] = {
+    {"sedan", 45, 1.0f, 1.0f, 1.0f},
+    {"motorcycle", 20, 1.15f, 2.0f, 0.6f},
+    {"truck", 80, 0.7f, 0.5f, 1.4f},
+    {"bus", 100, 0.6f, 0.5f, 1.6f},
+    {"bicycle", 15, 0.3f, 3.0f, 0.5f},
+};
+
+inline const VehicleSpec &getVehicleSpec(VehicleType type) {
+  return VEHICLE_SPECS[type];
+}
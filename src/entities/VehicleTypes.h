@@ -0,0 +1,62 @@
+#pragma once
+#include "SedanCar.h"
+#include <memory>
+
+/**
+ * Jenis kendaraan selain SedanCar
+ *
+ * Semua jenis inherit dari SedanCar dan hanya berbeda di DATA
+ * (VehicleSpec: length, maxV, probSlow, ukuran gambar). Tidak ada
+ * override update()/draw(), jadi tidak ada virtual dispatch tambahan
+ * per jenis: biaya per kendaraan di track campuran sama dengan track
+ * yang isinya SedanCar semua.
+ *
+ * Parameter constructor sama dengan SedanCar; maxV dan probSlow adalah
+ * nilai TRACK, dikali skala dari VehicleSpec.
+ */
+class Motorcycle final : public SedanCar {
+public:
+  Motorcycle(float startDist, float velocity, vec3 color, int maxCells = 600,
+             float maxV = 20.0f, float probSlow = 0.02f)
+      : SedanCar(VEHICLE_MOTORCYCLE, startDist, velocity, color, maxCells, maxV, probSlow) {}
+};
+
+class Truck final : public SedanCar {
+public:
+  Truck(float startDist, float velocity, vec3 color, int maxCells = 600,
+        float maxV = 20.0f, float probSlow = 0.02f)
+      : SedanCar(VEHICLE_TRUCK, startDist, velocity, color, maxCells, maxV, probSlow) {}
+};
+
+class Bus final : public SedanCar {
+public:
+  Bus(float startDist, float velocity, vec3 color, int maxCells = 600,
+      float maxV = 20.0f, float probSlow = 0.02f)
+      : SedanCar(VEHICLE_BUS, startDist, velocity, color, maxCells, maxV, probSlow) {}
+};
+
+class Bicycle final : public SedanCar {
+public:
+  Bicycle(float startDist, float velocity, vec3 color, int maxCells = 600,
+          float maxV = 20.0f, float probSlow = 0.02f)
+      : SedanCar(VEHICLE_BICYCLE, startDist, velocity, color, maxCells, maxV, probSlow) {}
+};
+
+/**
+ * Factory: buat kendaraan berdasarkan VehicleType
+ */
+inline std::shared_ptr<Vehicle> makeVehicle(VehicleType type, float startDist, float velocity,
+                                            vec3 color, int maxCells, float maxV, float probSlow) {
+  switch (type) {
+  case VEHICLE_MOTORCYCLE:
+    return std::make_shared<Motorcycle>(startDist, velocity, color, maxCells, maxV, probSlow);
+  case VEHICLE_TRUCK:
+    return std::make_shared<Truck>(startDist, velocity, color, maxCells, maxV, probSlow);
+  case VEHICLE_BUS:
+    return std::make_shared<Bus>(startDist, velocity, color, maxCells, maxV, probSlow);
+  case VEHICLE_BICYCLE:
+    return std::make_shared<Bicycle>(startDist, velocity, color, maxCells, maxV, probSlow);
+  default:
+    return std::make_shared<SedanCar>(startDist, velocity, color, maxCells, maxV, probSlow);
+  }
+}
@@ -0,0 +1,163 @@
+#include "GoldenTrace.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace golden {
+
+void GoldenTrace::reset(uint64_t seed, int trackCount) {
+  this->seed = seed;
+  this->trackCount = trackCount;
+  trackHashes.clear();
+  vehicleOffset.assign(1, 0);
+  vehicles.clear();
+}
+
+void GoldenTrace::addTrack(const uint32_t* vehicleHashes, int count) {
+  trackHashes.push_back(trackHash(vehicleHashes, count));
+  vehicles.insert(vehicles.end(), vehicleHashes, vehicleHashes + count);
+  vehicleOffset.push_back(vehicles.size());
+}
+
+int GoldenTrace::getVehicleCount(uint64_t step, int track) const {
+  size_t k = step * trackCount + track;
+  return (int)(vehicleOffset[k + 1] - vehicleOffset[k]);
+}
+
+const uint32_t* GoldenTrace::getVehicleHashes(uint64_t step, int track) const {
+  return vehicles.data() + vehicleOffset[step * trackCount + track];
+}
+
+bool GoldenTrace::save(const std::string& path) const {
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+
+  GoldenHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.endianTag = ENDIAN_TAG;
+  header.seed = seed;
+  header.steps = getSteps();
+  header.trackCount = (uint32_t)trackCount;
+  header.headerSize = sizeof(GoldenHeader);
+  bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+
+  for (size_t k = 0; ok && k < trackHashes.size(); k++) {
+    uint32_t count = (uint32_t)(vehicleOffset[k + 1] - vehicleOffset[k]);
+    ok = std::fwrite(&trackHashes[k], sizeof(uint64_t), 1, f) == 1 &&
+         std::fwrite(&count, sizeof(count), 1, f) == 1 &&
+         std::fwrite(vehicles.data() + vehicleOffset[k], sizeof(uint32_t), count, f) == count;
+  }
+
+  ok = (std::fclose(f) == 0) && ok;
+  return ok;
+}
+
+bool GoldenTrace::load(const std::string& path, std::string& error) {
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) {
+    error = "tidak bisa membuka " + path;
+    return false;
+  }
+
+  GoldenHeader header;
+  if (std::fread(&header, sizeof(header), 1, f) != 1 || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.endianTag != ENDIAN_TAG || header.headerSize != sizeof(GoldenHeader)) {
+    std::fclose(f);
+    error = "bukan file golden: " + path;
+    return false;
+  }
+  if (header.version != FORMAT_VERSION) {
+    std::fclose(f);
+    error = "versi golden " + std::to_string(header.version) + " tidak didukung";
+    return false;
+  }
+
+  reset(header.seed, (int)header.trackCount);
+  std::vector<uint32_t> hashes;
+  const uint64_t records = header.steps * header.trackCount;
+  for (uint64_t k = 0; k < records; k++) {
+    uint64_t expectedHash;
+    uint32_t count;
+    if (std::fread(&expectedHash, sizeof(expectedHash), 1, f) != 1 || std::fread(&count, sizeof(count), 1, f) != 1) {
+      break;
+    }
+    hashes.resize(count);
+    if (std::fread(hashes.data(), sizeof(uint32_t), count, f) != count) break;
+
+    addTrack(hashes.data(), (int)count);
+    if (trackHashes.back() != expectedHash) break;  // Isi rusak
+  }
+  std::fclose(f);
+
+  if (trackHashes.size() != records) {
+    error = "file golden terpotong atau rusak: " + path;
+    return false;
+  }
+  return true;
+}
+
+Options parseArgs(int argc, char* argv[]) {
+  Options opt;
+  if (argc > 0) opt.executable = argv[0];
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    Options::Mode mode = Options::NONE;
+    if (arg == "--golden-record") mode = Options::RECORD;
+    if (arg == "--golden-check") mode = Options::CHECK;
+    if (arg == "--golden-bisect") mode = Options::BISECT;
+    if (arg == "--domain-worker") mode = Options::DOMAIN_WORKER;
+
+    if (mode != Options::NONE || arg == "--scenario" || arg == "--seed" || arg == "--steps" || arg == "--domains" ||
+        arg == "--rank") {
+      if (!hasValue) {
+        opt.mode = Options::INVALID;
+        opt.error = arg + " butuh nilai";
+        return opt;
+      }
+      std::string value = argv[++i];
+      if (mode == Options::DOMAIN_WORKER) {
+        opt.mode = mode;
+        opt.domainChannel = value;
+      } else if (mode != Options::NONE) {
+        opt.mode = mode;
+        opt.goldenPath = value;
+      } else if (arg == "--scenario") {
+        opt.scenarioPath = value;
+      } else if (arg == "--seed") {
+        opt.seed = std::strtoull(value.c_str(), nullptr, 10);
+      } else if (arg == "--domains") {
+        opt.domains = std::atoi(value.c_str());
+      } else if (arg == "--rank") {
+        opt.domainRank = std::atoi(value.c_str());
+      } else {
+        opt.steps = std::strtoull(value.c_str(), nullptr, 10);
+      }
+    }
+  }
+
+  if (opt.mode == Options::NONE && !opt.scenarioPath.empty()) {
+    opt.mode = Options::INVALID;
+    opt.error = "--scenario hanya untuk --golden-record / --golden-check / --golden-bisect";
+  }
+  if (opt.mode != Options::INVALID && (opt.domains < 1 || opt.domains > 64)) {
+    opt.mode = Options::INVALID;
+    opt.error = "--domains harus 1..64";
+  }
+  return opt;
+}
+
+const char* usage() {
+  return "Golden trajectory harness:\n"
+         "  --golden-record <file>   simpan hash per step sebagai golden baru\n"
+         "  --golden-check <file>    bandingkan dengan golden (exit 1 kalau beda)\n"
+         "  --golden-bisect <file>   check + step & kendaraan pertama yang beda\n"
+         "  --scenario <file>        scenario JSON (default: 3 ring bawaan)\n"
+         "  --seed <n>               seed run (record, default 1)\n"
+         "  --steps <n>              jumlah step (record, default 600)\n"
+         "  --domains <n>            pecah tiap track ke n proses (physics integer, default 1)\n";
+}
+
+}  // namespace golden
@@ -0,0 +1,133 @@
+#pragma once
+#include "../simulation/CounterRng.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * GoldenTrace - Hash state kendaraan per step untuk regression test (.tjg)
+ *
+ * Harness (ofApp::runGolden) menjalankan scenario dari seed tetap selama
+ * N step tanpa jendela, lalu mencatat per step per track:
+ * - vehicleHash[i]: hash 32 bit (distance, velocity, lajur) kendaraan i
+ * - trackHash:      gabungan semua vehicleHash (urutan traffic) + jumlahnya
+ *
+ * File golden di-commit. Optimasi NaSchMovement / grid / lane change yang
+ * mengubah perilaku langsung ketahuan: mode check membandingkan trackHash
+ * tiap step, mode bisect menunjuk step + kendaraan pertama yang berbeda.
+ *
+ * Layout (little-endian, seperti .tjs / .tjt):
+ *   [GoldenHeader]                                   48 bytes
+ *   per step, per track:
+ *     uint64 trackHash, uint32 vehicleCount, uint32 vehicleHash x vehicleCount
+ */
+namespace golden {
+
+const uint32_t FORMAT_VERSION = 1;
+const uint32_t ENDIAN_TAG = 0x01020304u;
+const char MAGIC[8] = {'T', 'J', 'G', 'O', 'L', 'D', '\r', '\n'};
+
+// Ukuran layar harness (bounds track; tidak memengaruhi distance/velocity)
+const float HARNESS_WIDTH = 1920.0f;
+const float HARNESS_HEIGHT = 1080.0f;
+
+struct GoldenHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianTag;
+  uint64_t seed;
+  uint64_t steps;
+  uint32_t trackCount;
+  uint32_t headerSize;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(GoldenHeader) == 48, "GoldenHeader layout berubah, naikkan FORMAT_VERSION");
+
+// Hash bit-exact satu kendaraan (perbedaan 1 ulp pun terdeteksi)
+inline uint32_t vehicleHash(float distance, float velocity, int lane) {
+  uint32_t d, v;
+  std::memcpy(&d, &distance, sizeof(d));
+  std::memcpy(&v, &velocity, sizeof(v));
+  uint64_t h = CounterRng::mix64(((uint64_t)d << 32) | v);
+  h = CounterRng::mix64(h ^ (uint32_t)lane);
+  return (uint32_t)(h ^ (h >> 32));
+}
+
+// Gabungan berurutan semua kendaraan satu track
+inline uint64_t trackHash(const uint32_t* vehicles, int count) {
+  uint64_t h = CounterRng::mix64((uint64_t)count);
+  for (int i = 0; i < count; i++) {
+    h = CounterRng::mix64(h ^ vehicles[i]);
+  }
+  return h;
+}
+
+// Seed track t dari seed run (tidak pernah 0 = acak)
+inline uint64_t trackSeed(uint64_t seed, int track) {
+  return CounterRng::mix64(seed + 0x9E3779B97F4A7C15ull * (uint64_t)(track + 1)) | 1;
+}
+
+class GoldenTrace {
+public:
+  void reset(uint64_t seed, int trackCount);
+
+  // Rekam satu step: panggil addTrack() trackCount kali, urut indeks track
+  void addTrack(const uint32_t* vehicleHashes, int count);
+
+  uint64_t getSeed() const { return seed; }
+  int getTrackCount() const { return trackCount; }
+  uint64_t getSteps() const { return trackCount > 0 ? trackHashes.size() / trackCount : 0; }
+
+  uint64_t getTrackHash(uint64_t step, int track) const { return trackHashes[step * trackCount + track]; }
+  int getVehicleCount(uint64_t step, int track) const;
+  const uint32_t* getVehicleHashes(uint64_t step, int track) const;
+
+  bool save(const std::string& path) const;
+  bool load(const std::string& path, std::string& error);
+
+private:
+  uint64_t seed = 0;
+  int trackCount = 0;
+  std::vector<uint64_t> trackHashes;    // step * trackCount + track
+  std::vector<uint64_t> vehicleOffset;  // Idem, awal hash kendaraan di vehicles (+1 di akhir)
+  std::vector<uint32_t> vehicles;
+};
+
+/**
+ * Argumen command line harness (lihat main.cpp)
+ *
+ *   --golden-record <file>   Jalankan & simpan hash sebagai golden baru
+ *   --golden-check <file>    Bandingkan dengan golden, stop di step pertama yang beda
+ *   --golden-bisect <file>   Seperti check + kendaraan pertama yang beda dan state-nya
+ *   --scenario <file>        Scenario JSON (default: 3 ring bawaan)
+ *   --seed <n>               Seed run (record saja; check/bisect pakai seed di file)
+ *   --steps <n>              Jumlah step (record saja)
+ *   --domains <n>            Pecah tiap track (physics integer) ke n proses (RingDomain)
+ *
+ * Internal (dijalankan DomainCluster, bukan oleh user):
+ *   --domain-worker <channel> --rank <r>
+ *
+ * Path relatif ke folder data/.
+ */
+struct Options {
+  enum Mode { NONE, RECORD, CHECK, BISECT, DOMAIN_WORKER, INVALID };
+  Mode mode = NONE;
+  std::string goldenPath;
+  std::string scenarioPath;
+  uint64_t seed = 1;
+  uint64_t steps = 600;
+  int domains = 1;
+  std::string domainChannel;  // DOMAIN_WORKER: nama shared memory koordinator
+  int domainRank = 0;         // DOMAIN_WORKER
+  std::string executable;     // argv[0], untuk menjalankan worker domain
+  std::string error;          // Untuk INVALID
+};
+
+// NONE kalau tidak ada argumen --golden-*
+Options parseArgs(int argc, char* argv[]);
+
+const char* usage();
+
+}  // namespace golden
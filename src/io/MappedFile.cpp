@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(ptr, other.ptr);
+    std::swap(length, other.length);
+#ifdef _WIN32
+    std::swap(fileHandle, other.fileHandle);
+    std::swap(mappingHandle, other.mappingHandle);
+#else
+    std::swap(fd, other.fd);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+  close();
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    return false;
+  }
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  fileHandle = file;
+  mappingHandle = mapping;
+  ptr = static_cast<const uint8_t*>(view);
+  length = (size_t)fileSize.QuadPart;
+  return true;
+}
+
+void MappedFile::close() {
+  if (ptr) UnmapViewOfFile(ptr);
+  if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+  if (fileHandle) CloseHandle((HANDLE)fileHandle);
+  ptr = nullptr;
+  length = 0;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+  close();
+
+  int file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0) return false;
+
+  struct stat st;
+  if (fstat(file, &st) != 0 || st.st_size <= 0) {
+    ::close(file);
+    return false;
+  }
+
+  void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  if (view == MAP_FAILED) {
+    ::close(file);
+    return false;
+  }
+
+  fd = file;
+  ptr = static_cast<const uint8_t*>(view);
+  length = (size_t)st.st_size;
+  return true;
+}
+
+void MappedFile::close() {
+  if (ptr) munmap(const_cast<uint8_t*>(ptr), length);
+  if (fd >= 0) ::close(fd);
+  ptr = nullptr;
+  length = 0;
+  fd = -1;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * MappedFile - File read-only yang di-map langsung ke memori (mmap)
+ *
+ * Isi file tidak di-copy ke buffer: OS yang memuat halaman saat pertama
+ * kali diakses. Cocok untuk snapshot besar yang datanya sudah dalam
+ * format siap pakai (tanpa parsing).
+ *
+ * Implementasi:
+ * - Windows: CreateFileMapping + MapViewOfFile
+ * - POSIX:   open + mmap
+ *
+ * Tidak bisa di-copy (pemilik tunggal mapping), tapi bisa di-move.
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /**
+   * Map file ke memori (read-only)
+   * @return false kalau file tidak ada, kosong, atau gagal di-map
+   */
+  bool open(const std::string& path);
+
+  // Unmap + tutup handle (aman dipanggil berkali-kali)
+  void close();
+
+  bool isOpen() const { return ptr != nullptr; }
+  const uint8_t* data() const { return ptr; }
+  size_t size() const { return length; }
+
+private:
+  const uint8_t* ptr = nullptr;
+  size_t length = 0;
+
+#ifdef _WIN32
+  void* fileHandle = nullptr;     // HANDLE
+  void* mappingHandle = nullptr;  // HANDLE
+#else
+  int fd = -1;
+#endif
+};
@@ -0,0 +1,391 @@
+#include "ScenarioFile.h"
+#include "../simulation/IntegerNaSch.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace scenario {
+
+ofRectangle TrackConfig::getBounds(float w, float h) const {
+  if (useBounds) {
+    return ofRectangle(boundsX, boundsY, boundsW, boundsH);
+  }
+  return ofRectangle(margin, margin, w - 2 * margin, h - 2 * margin);
+}
+
+bool TrackConfig::sameSimulation(const TrackConfig& o) const {
+  return roadType == o.roadType && margin == o.margin && useBounds == o.useBounds &&
+         boundsX == o.boundsX && boundsY == o.boundsY && boundsW == o.boundsW && boundsH == o.boundsH &&
+         maxCells == o.maxCells && direction == o.direction &&
+         numCars == o.numCars && spacing == o.spacing && numLanes == o.numLanes &&
+         laneWidth == o.laneWidth && fleetMix == o.fleetMix && segmentsPerCar == o.segmentsPerCar &&
+         seed == o.seed && physics == o.physics && caInterval == o.caInterval &&
+         rules == o.rules && waveSpeed == o.waveSpeed && ctmCellLength == o.ctmCellLength &&
+         microBegin == o.microBegin && microLength == o.microLength && occupancy == o.occupancy &&
+         maxV == o.maxV && spiralMaxV == o.spiralMaxV && probSlow == o.probSlow;
+}
+
+bool TrackConfig::operator==(const TrackConfig& o) const {
+  return sameSimulation(o) && name == o.name &&
+         asymmetricLaneChange == o.asymmetricLaneChange && probLaneChange == o.probLaneChange &&
+         numLinesPerCar == o.numLinesPerCar && curveIntensity == o.curveIntensity &&
+         curveAngle1 == o.curveAngle1 && curveAngle2 == o.curveAngle2 &&
+         visible == o.visible && drawFromCenter == o.drawFromCenter && gradientMode == o.gradientMode &&
+         detectorCell == o.detectorCell && perlin == o.perlin;
+}
+
+Scenario builtinScenario() {
+  Scenario s;
+
+  // Outer (besar): margin 50, paling cepat
+  TrackConfig outer;
+  outer.name = "outer";
+  outer.margin = 50.0f;
+  outer.maxV = 20.0f;
+  outer.spiralMaxV = 0.7f;
+  outer.curveAngle1 = HALF_PI / 2;
+  outer.curveAngle2 = -HALF_PI;
+  outer.direction = 1;
+  s.tracks.push_back(outer);
+
+  // Middle (sedang): arah berlawanan
+  TrackConfig middle;
+  middle.name = "middle";
+  middle.margin = 200.0f;
+  middle.maxV = 6.0f;
+  middle.spiralMaxV = 1.0f;
+  middle.curveAngle1 = HALF_PI / 4;
+  middle.curveAngle2 = -HALF_PI / 2;
+  middle.direction = -1;
+  s.tracks.push_back(middle);
+
+  // Inner (kecil): paling lambat
+  TrackConfig inner;
+  inner.name = "inner";
+  inner.margin = 350.0f;
+  inner.spacing = 45;
+  inner.maxV = 5.0f;
+  inner.spiralMaxV = 1.5f;
+  inner.curveAngle1 = HALF_PI;
+  inner.curveAngle2 = -HALF_PI / 2;
+  inner.direction = 1;
+  s.tracks.push_back(inner);
+
+  return s;
+}
+
+namespace {
+
+// "circle" / "spiral" / indeks angka
+uint32_t parseRoadType(const ofJson& v) {
+  if (v.is_number_integer()) {
+    return std::min<uint32_t>(v.get<uint32_t>(), ROAD_TYPE_COUNT - 1);
+  }
+  std::string name = v.get<std::string>();
+  for (uint32_t i = 0; i < ROAD_TYPE_COUNT; i++) {
+    if (name == ROAD_TYPE_NAMES[i]) return i;
+  }
+  throw std::invalid_argument("roadType tidak dikenal: " + name);
+}
+
+Physics parsePhysics(const std::string& name) {
+  for (uint32_t i = 0; i < PHYSICS_COUNT; i++) {
+    if (name == PHYSICS_NAMES[i]) return (Physics)i;
+  }
+  throw std::invalid_argument("physics harus float / integer / macro / hybrid: " + name);
+}
+
+Occupancy parseOccupancy(const std::string& name) {
+  for (uint32_t i = 0; i < OCCUPANCY_COUNT; i++) {
+    if (name == OCCUPANCY_NAMES[i]) return (Occupancy)i;
+  }
+  throw std::invalid_argument("occupancy harus auto / dense / sparse: " + name);
+}
+
+// Array 5 bobot, atau object {"sedan": 0.7, "truck": 0.3}. Bobot >= 0,
+// minimal satu > 0 (SpawnSequence memilih jenis dari total bobot)
+void parseFleetMix(const ofJson& v, std::array<float, VEHICLE_TYPE_COUNT>& out) {
+  out.fill(0.0f);
+  if (v.is_array()) {
+    for (size_t k = 0; k < v.size() && k < out.size(); k++) {
+      out[k] = v[k].get<float>();
+    }
+  } else if (v.is_object()) {
+    for (auto it = v.begin(); it != v.end(); ++it) {
+      bool found = false;
+      for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+        if (it.key() == VEHICLE_SPECS[k].name) {
+          out[k] = it.value().get<float>();
+          found = true;
+        }
+      }
+      if (!found) throw std::invalid_argument("jenis kendaraan tidak dikenal: " + it.key());
+    }
+  } else {
+    throw std::invalid_argument("fleetMix harus array bobot atau object {jenis: bobot}");
+  }
+
+  float total = 0.0f;
+  for (float w : out) {
+    if (!(w >= 0.0f) || std::isinf(w)) throw std::invalid_argument("fleetMix: bobot harus >= 0");
+    total += w;
+  }
+  if (!(total > 0.0f)) throw std::invalid_argument("fleetMix: minimal satu bobot harus > 0");
+}
+
+// Array bobot octave PerlinNoiseRoad
+void parseOctaves(const ofJson& v, std::vector<float>& out) {
+  if (!v.is_array() || v.empty() || v.size() > (size_t)MAX_PERLIN_OCTAVES) {
+    throw std::invalid_argument("perlinOctaves harus array 1 .. " + std::to_string(MAX_PERLIN_OCTAVES) + " bobot");
+  }
+  out.clear();
+  for (const auto& w : v) {
+    out.push_back(w.get<float>());
+    if (!(out.back() >= 0.0f)) throw std::invalid_argument("perlinOctaves: bobot harus >= 0");
+  }
+}
+
+template <typename T>
+void read(const ofJson& j, const char* key, T& field) {
+  auto it = j.find(key);
+  if (it != j.end()) field = it->template get<T>();
+}
+
+TrackConfig parseTrack(const ofJson& j) {
+  TrackConfig t;
+  read(j, "name", t.name);
+
+  if (j.contains("roadType")) t.roadType = parseRoadType(j["roadType"]);
+  read(j, "margin", t.margin);
+  if (j.contains("bounds")) {
+    const ofJson& b = j["bounds"];
+    if (!b.is_array() || b.size() != 4) throw std::invalid_argument("bounds harus [x, y, w, h]");
+    t.useBounds = true;
+    t.boundsX = b[0].get<float>();
+    t.boundsY = b[1].get<float>();
+    t.boundsW = b[2].get<float>();
+    t.boundsH = b[3].get<float>();
+  }
+  read(j, "maxCells", t.maxCells);
+  read(j, "direction", t.direction);
+  read(j, "perlinResolution", t.perlin.resolution);
+  if (j.contains("perlinOctaves")) parseOctaves(j["perlinOctaves"], t.perlin.octaves);
+  read(j, "perlinNoiseScale", t.perlin.noiseScale);
+  if (j.contains("perlinSeed")) {
+    const ofJson& v = j["perlinSeed"];
+    if (!v.is_number_unsigned() || v.get<uint64_t>() > 0xFFFFFFFFull) {
+      throw std::invalid_argument("perlinSeed harus integer 0 .. 2^32-1");
+    }
+    t.perlin.seed = v.get<uint32_t>();
+  }
+  read(j, "perlinDeform", t.perlin.deform);
+
+  read(j, "numCars", t.numCars);
+  read(j, "spacing", t.spacing);
+  read(j, "numLanes", t.numLanes);
+  read(j, "laneWidth", t.laneWidth);
+  if (j.contains("fleetMix")) parseFleetMix(j["fleetMix"], t.fleetMix);
+  read(j, "segmentsPerCar", t.segmentsPerCar);
+  read(j, "seed", t.seed);
+
+  read(j, "maxV", t.maxV);
+  read(j, "spiralMaxV", t.spiralMaxV);
+  read(j, "probSlow", t.probSlow);
+  if (j.contains("laneChangeMode")) {
+    std::string mode = j["laneChangeMode"].get<std::string>();
+    if (mode != "symmetric" && mode != "asymmetric") {
+      throw std::invalid_argument("laneChangeMode harus symmetric / asymmetric: " + mode);
+    }
+    t.asymmetricLaneChange = (mode == "asymmetric");
+  }
+  read(j, "probLaneChange", t.probLaneChange);
+  if (j.contains("physics")) t.physics = parsePhysics(j["physics"].get<std::string>());
+  read(j, "caInterval", t.caInterval);
+  read(j, "waveSpeed", t.waveSpeed);
+  read(j, "ctmCellLength", t.ctmCellLength);
+  read(j, "microBegin", t.microBegin);
+  read(j, "microLength", t.microLength);
+  if (j.contains("occupancy")) t.occupancy = parseOccupancy(j["occupancy"].get<std::string>());
+  if (j.contains("rules")) {
+    const ofJson& rules = j["rules"];
+    if (!rules.is_array()) throw std::invalid_argument("rules harus array nama aturan");
+    for (const auto& r : rules) {
+      std::string name = r.get<std::string>();
+      if (name == "vdr") {
+        t.rules.velocityDependent = true;
+      } else if (name == "slowToStart") {
+        t.rules.slowToStart = true;
+      } else if (name == "anticipation") {
+        t.rules.anticipation = true;
+      } else {
+        throw std::invalid_argument("aturan tidak dikenal (vdr / slowToStart / anticipation): " + name);
+      }
+    }
+  }
+  read(j, "probSlowStopped", t.rules.probSlowStopped);
+  read(j, "probSlowToStart", t.rules.probSlowToStart);
+  read(j, "slowToStartGap", t.rules.slowToStartGap);
+  read(j, "anticipationSafety", t.rules.anticipationSafety);
+
+  read(j, "numLinesPerCar", t.numLinesPerCar);
+  read(j, "curveIntensity", t.curveIntensity);
+  read(j, "curveAngle1", t.curveAngle1);
+  read(j, "curveAngle2", t.curveAngle2);
+  read(j, "visible", t.visible);
+  if (j.contains("drawFromCenter")) {
+    const ofJson& v = j["drawFromCenter"];
+    if (v.is_boolean()) {
+      t.drawFromCenter = v.get<bool>() ? 1 : 0;
+    } else if (v.is_string() && v.get<std::string>() == "random") {
+      t.drawFromCenter = -1;
+    } else {
+      throw std::invalid_argument("drawFromCenter harus true / false / \"random\"");
+    }
+  }
+  read(j, "gradientMode", t.gradientMode);
+  read(j, "detectorCell", t.detectorCell);
+
+  // Nilai yang membuat simulasi tidak valid
+  if (t.maxCells < 1) throw std::invalid_argument("maxCells harus >= 1");
+  if ((t.physics == PHYSICS_FLOAT || t.physics == PHYSICS_HYBRID) && t.maxCells > MAX_FLOAT_CELLS) {
+    throw std::invalid_argument("physics float / hybrid: maxCells maksimal " + std::to_string(MAX_FLOAT_CELLS) +
+                                " (distance float 32 bit), pakai integer / macro untuk road lebih panjang");
+  }
+  if (t.numCars < 0) throw std::invalid_argument("numCars harus >= 0");
+  if (t.spacing < 1) throw std::invalid_argument("spacing harus >= 1");
+  if (t.numLanes < 1) throw std::invalid_argument("numLanes harus >= 1");
+  if (!(t.laneWidth > 0.0f)) throw std::invalid_argument("laneWidth harus > 0");
+  if (t.numLinesPerCar < 0) throw std::invalid_argument("numLinesPerCar harus >= 0");
+  if (!(t.maxV > 0.0f) || !(t.spiralMaxV > 0.0f)) throw std::invalid_argument("maxV dan spiralMaxV harus > 0");
+  if (!(t.probSlow >= 0.0f && t.probSlow <= 1.0f)) throw std::invalid_argument("probSlow harus 0 .. 1");
+  if (!(t.probLaneChange >= 0.0f && t.probLaneChange <= 1.0f)) {
+    throw std::invalid_argument("probLaneChange harus 0 .. 1");
+  }
+  if (t.segmentsPerCar < 1) throw std::invalid_argument("segmentsPerCar harus >= 1");
+  if (t.direction != 1 && t.direction != -1) throw std::invalid_argument("direction harus 1 atau -1");
+  if (t.detectorCell < 0.0f || t.detectorCell >= t.maxCells) {
+    throw std::invalid_argument("detectorCell harus 0 .. maxCells");
+  }
+  if (t.perlin.resolution < 3 || t.perlin.resolution > MAX_PERLIN_RESOLUTION) {
+    throw std::invalid_argument("perlinResolution harus 3 .. " + std::to_string(MAX_PERLIN_RESOLUTION));
+  }
+  // Octave tertinggi punya 2π * noiseScale * 2^octave sel lattice
+  if (!(t.perlin.noiseScale > 0.0f) ||
+      TWO_PI * t.perlin.noiseScale * std::ldexp(1.0, (int)t.perlin.octaves.size()) > MAX_PERLIN_RESOLUTION) {
+    throw std::invalid_argument("perlinNoiseScale harus > 0 (dan tidak terlalu besar untuk jumlah octave)");
+  }
+  if (!(t.perlin.deform >= 0.0f && t.perlin.deform < 1.0f)) throw std::invalid_argument("perlinDeform harus 0 .. <1");
+  if (t.caInterval < 1) throw std::invalid_argument("caInterval harus >= 1");
+  if (t.rules.any() && t.physics != PHYSICS_INTEGER) {
+    throw std::invalid_argument("rules hanya untuk physics integer");
+  }
+  if (t.waveSpeed < 0.0f) throw std::invalid_argument("waveSpeed harus >= 0");
+  if (t.ctmCellLength < 0) throw std::invalid_argument("ctmCellLength harus >= 0");
+  if (t.microBegin < 0 || t.microBegin >= t.maxCells) throw std::invalid_argument("microBegin harus 0 .. maxCells");
+  if (t.microLength < 0 || t.microLength > t.maxCells) throw std::invalid_argument("microLength harus 0 .. maxCells");
+  if (!(t.rules.probSlowStopped >= 0.0f && t.rules.probSlowStopped <= 1.0f) ||
+      !(t.rules.probSlowToStart >= 0.0f && t.rules.probSlowToStart <= 1.0f)) {
+    throw std::invalid_argument("probSlowStopped dan probSlowToStart harus 0 .. 1");
+  }
+  if (t.rules.slowToStartGap < 0) throw std::invalid_argument("slowToStartGap harus >= 0");
+  if (t.rules.anticipationSafety < 1) {
+    throw std::invalid_argument("anticipationSafety harus >= 1 (0 bisa menabrak)");
+  }
+  if (t.physics == PHYSICS_INTEGER) {
+    // Jenis tercepat di fleetMix juga harus muat di velocity 8 bit
+    float fastest = 0.0f;
+    for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+      if (t.fleetMix[k] > 0.0f) fastest = std::max(fastest, VEHICLE_SPECS[k].maxVScale);
+    }
+    if (std::max(t.maxV, t.spiralMaxV) * fastest * t.caInterval > IntegerNaSch::MAX_VELOCITY + 0.5f) {
+      throw std::invalid_argument("physics integer: maxV * caInterval terlalu besar untuk velocity 8 bit");
+    }
+  }
+  return t;
+}
+
+}  // namespace
+
+bool parseScenario(const ofJson& json, Scenario& out, std::string& error) {
+  if (!json.is_object() || !json.contains("tracks") || !json["tracks"].is_array()) {
+    error = "scenario harus object dengan array \"tracks\"";
+    return false;
+  }
+
+  const ofJson defaults = json.contains("defaults") ? json["defaults"] : ofJson::object();
+  if (!defaults.is_object()) {
+    error = "\"defaults\" harus object";
+    return false;
+  }
+
+  Scenario parsed;
+  const ofJson& tracks = json["tracks"];
+  for (size_t i = 0; i < tracks.size(); i++) {
+    if (!tracks[i].is_object()) {
+      error = "track " + std::to_string(i) + " harus object";
+      return false;
+    }
+
+    // Field track menimpa defaults
+    ofJson merged = defaults;
+    merged.update(tracks[i]);
+
+    try {
+      parsed.tracks.push_back(parseTrack(merged));
+    } catch (const std::exception& e) {
+      error = "track " + std::to_string(i) + ": " + e.what();
+      return false;
+    }
+  }
+
+  out = std::move(parsed);
+  return true;
+}
+
+bool loadScenario(const std::string& path, Scenario& out, std::string& error) {
+  std::ifstream file(path);
+  if (!file) {
+    error = "tidak bisa membuka " + path;
+    return false;
+  }
+
+  // Tanpa exception: JSON rusak → discarded value
+  ofJson json = ofJson::parse(file, nullptr, false);
+  if (json.is_discarded()) {
+    error = "JSON tidak valid: " + path;
+    return false;
+  }
+  return parseScenario(json, out, error);
+}
+
+} // namespace scenario
+
+//--------------------------------------------------------------
+void ScenarioWatcher::watch(const std::string& file, int intervalMs) {
+  path = file;
+  pathString = file;
+  interval = std::chrono::milliseconds(intervalMs);
+  lastWrite = readWriteTime();
+  nextCheck = std::chrono::steady_clock::now() + interval;
+  active = true;
+}
+
+std::filesystem::file_time_type ScenarioWatcher::readWriteTime() const {
+  std::error_code ec;
+  auto t = std::filesystem::last_write_time(path, ec);
+  return ec ? std::filesystem::file_time_type{} : t;
+}
+
+bool ScenarioWatcher::poll() {
+  if (!active) return false;
+
+  auto now = std::chrono::steady_clock::now();
+  if (now < nextCheck) return false;
+  nextCheck = now + interval;
+
+  auto t = readWriteTime();
+  if (t == lastWrite) return false;
+  lastWrite = t;
+  return true;
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include "../entities/VehicleSpec.h"
+#include "../simulation/NaSchRules.h"
+#include "ofMain.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * ScenarioFile - Daftar track (road, ukuran, kendaraan, kecepatan, render)
+ * dari file JSON, menggantikan parameter per track yang dulu hardcoded
+ * sebagai member ofApp (numCarsOuter, maxVInner, curveAngle1Middle, dll)
+ *
+ * Format (semua field opsional, lihat nilai default di TrackConfig):
+ *
+ *   {
+ *     "defaults": { "maxCells": 1500, "laneWidth": 30, ... },
+ *     "tracks": [
+ *       { "name": "outer", "margin": 50, "numCars": 20, "maxV": 20,
+ *         "spiralMaxV": 0.7, "curveAngle1": 0.785, "direction": 1 },
+ *       { "name": "custom", "bounds": [100, 80, 600, 400], "roadType": "spiral" }
+ *     ]
+ *   }
+ *
+ * "defaults" digabung ke setiap track (field di track menang). Bounds
+ * bisa "margin" (inset dari jendela, seperti 3 ring lama) atau "bounds"
+ * [x, y, w, h] dalam pixels. Sudut dalam radian. detectorCell = posisi
+ * detector virtual untuk telemetry flow (cell, 0 .. maxCells).
+ *
+ * "physics": "integer" memakai IntegerNaSch (CA klasik, velocity integer
+ * 0 .. vmax, tanpa lane change) sebagai ganti NaSchMovement float. Satu
+ * step CA tiap "caInterval" step simulasi, di antaranya posisi
+ * di-interpolasi untuk render. maxV tetap cells per step simulasi, jadi
+ * vmax CA = maxV * caInterval (harus <= 255).
+ *
+ * "rules" (physics integer saja): daftar varian aturan NaSch, mis.
+ * ["vdr", "slowToStart", "anticipation"], parameter di field
+ * probSlowStopped, probSlowToStart, slowToStartGap, anticipationSafety
+ * (lihat simulation/NaSchRules.h).
+ *
+ * "physics": "macro" memakai CellTransmission (CTM/LWR): tidak ada
+ * kendaraan individual, numCars x numLanes kendaraan disebar sebagai
+ * density di [0, numCars * spacing), kecepatan bebas = maxV, "waveSpeed"
+ * = kecepatan gelombang macet (0 = panjang kendaraan x (1 - probSlow),
+ * cabang macet NaSch), "ctmCellLength" = cell NaSch
+ * minimal per cell CTM (0 = otomatis dari CFL). Digambar sebagai segmen
+ * road berwarna density, telemetry sama dengan model mikroskopik.
+ *
+ * "physics": "hybrid" = macro dengan satu region micro (NaSch float per
+ * kendaraan, lane change, body) mulai "microBegin" sepanjang "microLength"
+ * cell (0 = seperempat ring), dibulatkan ke batas cell CTM. Kendaraan
+ * yang keluar region jadi density, flow CTM yang masuk jadi kendaraan.
+ *
+ * "occupancy" (physics float / hybrid): "dense" = grid satu int per cell
+ * per lajur, "sparse" = SparseOccupancy (memori per kendaraan, untuk road
+ * jutaan cell), "auto" (default) = sparse kalau numLanes * maxCells
+ * >= SparseOccupancy::AUTO_MIN_CELLS. Hasil simulasi sama persis.
+ *
+ * Physics float / hybrid menyimpan distance sebagai float 32 bit, jadi
+ * maxCells dibatasi MAX_FLOAT_CELLS; road lebih panjang pakai integer /
+ * macro.
+ *
+ * Bentuk PerlinNoiseRoad (roadType "perlin", dipakai juga saat road
+ * diganti ke perlin lewat tombol): "perlinResolution" vertex di sekeliling
+ * track, "perlinOctaves" = bobot per octave (jumlah octave = panjang
+ * array), "perlinNoiseScale", "perlinSeed", "perlinDeform" (0 .. <1).
+ * Hanya mengubah geometri road, jadi hot reload cukup generate ulang road.
+ *
+ * roadType disimpan sebagai indeks ofApp::RoadType (sama seperti
+ * SnapshotTrack::roadType) supaya io/ tidak bergantung pada ofApp.h.
+ */
+namespace scenario {
+
+// Urutan = ofApp::RoadType
+const char* const ROAD_TYPE_NAMES[] = {"circle", "curved", "perlin", "spiral"};
+const uint32_t ROAD_TYPE_COUNT = 4;
+
+// Model pergerakan track ("physics")
+enum Physics : uint32_t {
+  PHYSICS_FLOAT = 0,  // NaSchMovement per kendaraan (akselerasi 0.02)
+  PHYSICS_INTEGER,    // IntegerNaSch (CA klasik)
+  PHYSICS_MACRO,      // CellTransmission (density per cell, tanpa kendaraan)
+  PHYSICS_HYBRID      // CellTransmission + region NaSchMovement (HybridRegion)
+};
+const char* const PHYSICS_NAMES[] = {"float", "integer", "macro", "hybrid"};
+const uint32_t PHYSICS_COUNT = 4;
+
+// maxCells maksimal physics float / hybrid: di atas 2^24 jarak antar float
+// lebih dari satu cell, distance + velocity (< beberapa cell, akselerasi
+// 0.02) dibulatkan → kendaraan diam atau melompat
+const int MAX_FLOAT_CELLS = 1 << 24;
+
+// Struktur lookup kendaraan di depan / samping ("occupancy")
+enum Occupancy : uint32_t {
+  OCCUPANCY_AUTO = 0,  // Sparse untuk road panjang
+  OCCUPANCY_DENSE,     // TrackInstance::grid
+  OCCUPANCY_SPARSE     // SparseOccupancy
+};
+const char* const OCCUPANCY_NAMES[] = {"auto", "dense", "sparse"};
+const uint32_t OCCUPANCY_COUNT = 3;
+
+// Parameter generator PerlinNoiseRoad (default = default PerlinNoiseRoad)
+struct PerlinConfig {
+  int resolution = 360;                 // Vertex di sekeliling track (3 .. MAX_PERLIN_RESOLUTION)
+  std::vector<float> octaves = {0.3f};  // Bobot per octave (>= 0), 1 .. MAX_PERLIN_OCTAVES
+  float noiseScale = 2.0f;              // Frekuensi octave 0 (> 0)
+  uint32_t seed = 0x5EED7A11u;          // Seed gradient noise (bentuk track)
+  float deform = 0.2f;                  // Variasi radius relatif (0 .. <1, 1 = radius bisa 0)
+
+  bool operator==(const PerlinConfig& o) const {
+    return resolution == o.resolution && octaves == o.octaves && noiseScale == o.noiseScale &&
+           seed == o.seed && deform == o.deform;
+  }
+  bool operator!=(const PerlinConfig& o) const { return !(*this == o); }
+};
+const int MAX_PERLIN_RESOLUTION = 1 << 22;
+const int MAX_PERLIN_OCTAVES = 16;
+
+struct TrackConfig {
+  std::string name;
+
+  // Road + ukuran
+  uint32_t roadType = 0;
+  float margin = 50.0f;          // Dipakai kalau useBounds == false
+  bool useBounds = false;
+  float boundsX = 0.0f, boundsY = 0.0f, boundsW = 0.0f, boundsH = 0.0f;
+  int maxCells = 1500;
+  int direction = 1;             // 1 = counter-clockwise, -1 = clockwise
+  PerlinConfig perlin;           // Bentuk road "perlin"
+
+  // Kendaraan
+  int numCars = 20;              // Per lajur
+  int spacing = 50;              // Jarak spawn antar kendaraan (cells)
+  int numLanes = 1;
+  float laneWidth = 30.0f;
+  std::array<float, VEHICLE_TYPE_COUNT> fleetMix = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  int segmentsPerCar = 15;
+  uint64_t seed = 0;             // 0 = acak tiap run; selain 0 simulasi bisa diulang persis
+
+  // NaSch + lane change
+  float maxV = 20.0f;
+  float spiralMaxV = 1.0f;
+  float probSlow = 0.03f;
+  bool asymmetricLaneChange = false;
+  float probLaneChange = 0.5f;
+  Physics physics = PHYSICS_FLOAT;
+  int caInterval = 1;            // Step simulasi per step CA (physics integer)
+  float waveSpeed = 0.0f;        // Physics macro: gelombang macet (0 = dari panjang kendaraan)
+  int ctmCellLength = 0;         // Physics macro: cell NaSch minimal per cell CTM (0 = otomatis)
+  int microBegin = 0;            // Physics hybrid: awal region micro (cell)
+  int microLength = 0;           // Physics hybrid: panjang region micro (0 = maxCells / 4)
+  Occupancy occupancy = OCCUPANCY_AUTO;
+  NaSchRules rules;              // Varian aturan (physics integer)
+
+  // Render
+  int numLinesPerCar = 5;
+  float curveIntensity = 0.0f;
+  float curveAngle1 = 0.0f;
+  float curveAngle2 = 0.0f;
+  bool visible = true;
+  int drawFromCenter = -1;       // -1 = acak saat spawn ("random"), 0 = car→center (false), 1 = center→car (true)
+  bool gradientMode = false;
+
+  // Telemetry
+  float detectorCell = 0.0f;     // Cell detector flow (0 .. maxCells)
+
+  // Bounds di layar w x h
+  ofRectangle getBounds(float w, float h) const;
+
+  // Sama persis (track tidak perlu disentuh saat reload)
+  bool operator==(const TrackConfig& o) const;
+  bool operator!=(const TrackConfig& o) const { return !(*this == o); }
+
+  // Beda hanya di field render / lane change / bentuk perlin → cukup
+  // update di tempat, kendaraan tidak dibuat ulang
+  bool sameSimulation(const TrackConfig& o) const;
+};
+
+struct Scenario {
+  std::vector<TrackConfig> tracks;
+};
+
+// 3 ring konsentris bawaan (dipakai kalau file scenario tidak ada)
+Scenario builtinScenario();
+
+// Parse file JSON. Return false (scenario tidak diubah) kalau gagal,
+// pesan error di error
+bool loadScenario(const std::string& path, Scenario& out, std::string& error);
+
+// Parse dari JSON yang sudah di-load
+bool parseScenario(const ofJson& json, Scenario& out, std::string& error);
+
+} // namespace scenario
+
+/**
+ * ScenarioWatcher - Deteksi file scenario berubah (hot reload)
+ *
+ * poll() hanya membaca waktu modifikasi file, dan hanya kalau interval
+ * sudah lewat, jadi aman dipanggil tiap iterasi loop simulasi. Path
+ * disimpan sekali, jadi poll() tidak alokasi.
+ */
+class ScenarioWatcher {
+public:
+  void watch(const std::string& path, int intervalMs = 500);
+  void stop() { active = false; }
+
+  // true sekali setiap kali file berubah sejak poll() sebelumnya
+  bool poll();
+
+  const std::string& getPath() const { return pathString; }
+
+private:
+  std::filesystem::path path;
+  std::string pathString;
+  std::filesystem::file_time_type lastWrite{};
+  bool active = false;
+  std::chrono::milliseconds interval{500};
+  std::chrono::steady_clock::time_point nextCheck{};
+
+  std::filesystem::file_time_type readWriteTime() const;
+};
@@ -0,0 +1,173 @@
+#include "SharedStateExporter.h"
+#include "../util/ChildProcess.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+static_assert(sizeof(tj_state_header) == 256, "tj_state_header harus 256 bytes");
+static_assert(sizeof(tj_state_slot) == 64, "tj_state_slot harus 64 bytes");
+static_assert(sizeof(tj_state_track) == 72, "tj_state_track harus 72 bytes");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+              "Field atomic di SharedStateFormat.h butuh atomic 64 bit lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "Field atomic di SharedStateFormat.h butuh atomic 32 bit lock-free");
+
+namespace {
+
+// Field atomic di header C (uint32_t / uint64_t biasa): std::atomic dibuat
+// di alamat yang sama saat start(), setelah itu diakses lewat sini
+template <typename T>
+std::atomic<T>& atomicAt(T& field) {
+  return *reinterpret_cast<std::atomic<T>*>(&field);
+}
+
+uint64_t alignUp(uint64_t bytes) {
+  return (bytes + TJ_STATE_ALIGN - 1) & ~(uint64_t)(TJ_STATE_ALIGN - 1);
+}
+
+}  // namespace
+
+SharedStateExporter::~SharedStateExporter() {
+  stop();
+}
+
+size_t SharedStateExporter::trackBytes(size_t vehicleCount, size_t bodyPointCount) {
+  return (size_t)(alignUp(vehicleCount * sizeof(float)) * 2 +      // distance, velocity
+                  alignUp(vehicleCount) +                           // lane
+                  alignUp(vehicleCount * 3 * sizeof(float)) +       // color
+                  alignUp((vehicleCount + 1) * sizeof(uint32_t)) +  // body begin
+                  alignUp(bodyPointCount * 2 * sizeof(float)));     // body point
+}
+
+bool SharedStateExporter::start(const std::string& name, size_t bytes) {
+  stop();
+
+  slotBytes = (std::max(bytes, sizeof(tj_state_slot)) + 63) & ~(size_t)63;
+  const size_t regionBytes = sizeof(tj_state_header) + TJ_STATE_SLOT_COUNT * slotBytes;
+  if (!memory.create(name, regionBytes)) {
+    // Nama tertinggal dari proses yang tidak sempat stop()
+    SharedMemory::remove(name);
+    if (!memory.create(name, regionBytes)) return false;
+  }
+
+  // Region baru berisi nol; magic ditulis terakhir supaya reader yang
+  // membuka lebih awal tidak memakai header setengah jadi
+  tj_state_header* h = header();
+  h->version = TJ_STATE_VERSION;
+  h->region_bytes = regionBytes;
+  for (uint32_t i = 0; i < TJ_STATE_SLOT_COUNT; i++) {
+    h->slot_offset[i] = sizeof(tj_state_header) + i * slotBytes;
+    new (&reinterpret_cast<tj_state_slot*>(memory.data() + h->slot_offset[i])->sequence) std::atomic<uint64_t>(0);
+  }
+  h->slot_bytes = slotBytes;
+  h->writer_pid = ChildProcess::currentProcessId();
+  new (&h->latest) std::atomic<uint32_t>(TJ_STATE_NO_SLOT);
+  new (&h->closed) std::atomic<uint32_t>(0);
+  new (&h->publish_count) std::atomic<uint64_t>(0);
+  new (&h->magic) std::atomic<uint32_t>(0);
+  atomicAt(h->magic).store(TJ_STATE_MAGIC, std::memory_order_release);
+
+  published = 0;
+  truncatedSteps = 0;
+  slot = nullptr;
+  track = nullptr;
+  return true;
+}
+
+void SharedStateExporter::stop() {
+  if (!memory.isOpen()) return;
+
+  // Reader yang masih me-map region tetap bisa membaca step terakhir
+  atomicAt(header()->closed).store(1, std::memory_order_release);
+  memory.close();
+  slot = nullptr;
+  track = nullptr;
+}
+
+void SharedStateExporter::beginStep(uint64_t step, uint32_t count) {
+  if (!memory.isOpen()) return;
+
+  // Tulis slot yang bukan latest: reader slot latest punya satu step penuh
+  tj_state_header* h = header();
+  const uint32_t latest = atomicAt(h->latest).load(std::memory_order_relaxed);
+  writing = (latest == TJ_STATE_NO_SLOT) ? 0 : (latest + 1) % TJ_STATE_SLOT_COUNT;
+  slot = reinterpret_cast<tj_state_slot*>(memory.data() + h->slot_offset[writing]);
+
+  // Seqlock: ganjil sebelum isi slot berubah
+  std::atomic<uint64_t>& seq = atomicAt(slot->sequence);
+  sequence = seq.load(std::memory_order_relaxed) + 1;
+  seq.store(sequence, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->step = step;
+  slot->track_offset = alignUp(sizeof(tj_state_slot));
+  trackCount = count;
+  trackIndex = 0;
+  track = nullptr;
+  truncated = false;
+  cursor = alignUp(slot->track_offset + (uint64_t)count * sizeof(tj_state_track));
+  if (cursor > slotBytes) {
+    trackCount = 0;
+    cursor = slot->track_offset;
+    truncated = true;
+  }
+}
+
+bool SharedStateExporter::beginTrack(uint32_t vehicleCount, uint32_t bodyPointCount, uint32_t laneCount,
+                                     uint32_t physics, uint32_t maxCells) {
+  if (!slot || trackIndex >= trackCount) return false;
+
+  tj_state_track* tracks = reinterpret_cast<tj_state_track*>(reinterpret_cast<uint8_t*>(slot) + slot->track_offset);
+  track = tracks + trackIndex++;
+  std::memset(track, 0, sizeof(tj_state_track));
+  track->lane_count = laneCount;
+  track->physics = physics;
+  track->max_cells = maxCells;
+
+  if (cursor + trackBytes(vehicleCount, bodyPointCount) > slotBytes) {
+    truncated = true;
+    return false;
+  }
+
+  const uint64_t v = vehicleCount;
+  track->vehicle_count = vehicleCount;
+  track->body_point_count = bodyPointCount;
+  track->distance_offset = cursor;
+  cursor += alignUp(v * sizeof(float));
+  track->velocity_offset = cursor;
+  cursor += alignUp(v * sizeof(float));
+  track->lane_offset = cursor;
+  cursor += alignUp(v);
+  track->color_offset = cursor;
+  cursor += alignUp(v * 3 * sizeof(float));
+  track->body_begin_offset = cursor;
+  cursor += alignUp((v + 1) * sizeof(uint32_t));
+  track->body_point_offset = cursor;
+  cursor += alignUp((uint64_t)bodyPointCount * 2 * sizeof(float));
+  return true;
+}
+
+void SharedStateExporter::endStep() {
+  if (!slot) return;
+
+  // Track yang tidak ditulis pemanggil: kosong
+  tj_state_track* tracks = reinterpret_cast<tj_state_track*>(reinterpret_cast<uint8_t*>(slot) + slot->track_offset);
+  for (; trackIndex < trackCount; trackIndex++) {
+    std::memset(tracks + trackIndex, 0, sizeof(tj_state_track));
+  }
+  slot->track_count = trackCount;
+  slot->flags = truncated ? TJ_STATE_FLAG_TRUNCATED : 0;
+  slot->used_bytes = cursor;
+
+  // Seqlock genap (isi slot selesai), lalu slot ini jadi yang terbaru
+  tj_state_header* h = header();
+  atomicAt(slot->sequence).store(sequence + 1, std::memory_order_release);
+  atomicAt(h->latest).store(writing, std::memory_order_release);
+  published++;
+  atomicAt(h->publish_count).store(published, std::memory_order_release);
+  if (truncated) truncatedSteps++;
+
+  slot = nullptr;
+  track = nullptr;
+}
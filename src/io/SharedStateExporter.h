@@ -0,0 +1,89 @@
+#pragma once
+#include "../util/SharedMemory.h"
+#include "SharedStateFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * SharedStateExporter - Publikasi array kendaraan tiap step ke shared memory
+ *
+ * Writer untuk layout SharedStateFormat.h (seqlock + dua slot): reader di
+ * proses lain (visualizer, analytics) membaca langsung dari mapping tanpa
+ * copy dan tanpa pernah memblok simulasi. Array ditulis langsung di slot
+ * (distances(), colors(), ...), jadi step biasa tanpa alokasi heap.
+ *
+ * Per step, dari thread simulasi:
+ *   beginStep(step, trackCount);
+ *   for track: if (beginTrack(...)) { isi distances() .. bodyPoints() }
+ *   endStep();
+ *
+ * Ukuran slot tetap sejak start(); track yang tidak muat lagi diekspor
+ * tanpa kendaraan dan slot diberi TJ_STATE_FLAG_TRUNCATED (getTruncatedSteps()).
+ */
+class SharedStateExporter {
+public:
+  SharedStateExporter() = default;
+  ~SharedStateExporter();
+
+  SharedStateExporter(const SharedStateExporter&) = delete;
+  SharedStateExporter& operator=(const SharedStateExporter&) = delete;
+
+  // Byte satu track di slot (header track tidak termasuk)
+  static size_t trackBytes(size_t vehicleCount, size_t bodyPointCount);
+
+  /**
+   * Buat region (nama tanpa '/', lihat TJ_STATE_NAME). Region lama dengan
+   * nama sama (proses sebelumnya crash) dihapus dulu
+   * @param slotBytes Kapasitas satu slot, termasuk header slot + track
+   */
+  bool start(const std::string& name, size_t slotBytes);
+
+  // Tandai closed untuk reader, hapus nama region
+  void stop();
+
+  bool isRunning() const { return memory.isOpen(); }
+
+  void beginStep(uint64_t step, uint32_t trackCount);
+
+  // false = slot penuh (track diekspor tanpa kendaraan, pointer array nullptr)
+  bool beginTrack(uint32_t vehicleCount, uint32_t bodyPointCount, uint32_t laneCount, uint32_t physics,
+                  uint32_t maxCells);
+
+  // Array track saat ini (setelah beginTrack() == true)
+  float* distances() const { return array<float>(track->distance_offset); }
+  float* velocities() const { return array<float>(track->velocity_offset); }
+  uint8_t* lanes() const { return array<uint8_t>(track->lane_offset); }
+  float* colors() const { return array<float>(track->color_offset); }         // RGB per kendaraan
+  uint32_t* bodyBegins() const { return array<uint32_t>(track->body_begin_offset); }
+  float* bodyPoints() const { return array<float>(track->body_point_offset); }  // x y per point
+
+  void endStep();
+
+  size_t getSlotBytes() const { return slotBytes; }
+  uint64_t getPublishedSteps() const { return published; }
+  uint64_t getTruncatedSteps() const { return truncatedSteps; }
+
+private:
+  SharedMemory memory;
+  size_t slotBytes = 0;
+  uint64_t published = 0;
+  uint64_t truncatedSteps = 0;
+
+  // Step yang sedang ditulis
+  uint32_t writing = 0;
+  tj_state_slot* slot = nullptr;
+  tj_state_track* track = nullptr;
+  uint32_t trackCount = 0;
+  uint32_t trackIndex = 0;
+  uint64_t cursor = 0;  // Byte berikutnya di slot
+  uint64_t sequence = 0;
+  bool truncated = false;
+
+  tj_state_header* header() const { return reinterpret_cast<tj_state_header*>(memory.data()); }
+
+  template <typename T>
+  T* array(uint64_t offset) const {
+    return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(slot) + offset);
+  }
+};
@@ -0,0 +1,146 @@
+#ifndef TRAFFIC_JALANAN_SHARED_STATE_FORMAT_H
+#define TRAFFIC_JALANAN_SHARED_STATE_FORMAT_H
+/**
+ * SharedStateFormat - Layout region shared memory state export ('M')
+ *
+ * Header C99 murni: boleh di-copy apa adanya ke tool lain (visualizer,
+ * analytics) tanpa kode Traffic-Jalanan lainnya.
+ *
+ *   [tj_state_header]                  256 bytes, di offset 0
+ *   [slot 0][slot 1]                   slot_bytes masing-masing, di slot_offset[]
+ *
+ * Slot:
+ *   [tj_state_slot]                    64 bytes
+ *   [tj_state_track x track_count]     di track_offset
+ *   [array per track]                  offset dari awal slot, kelipatan 16
+ *
+ * Protokol (seqlock + double buffer): writer (thread simulasi) menulis
+ * slot yang BUKAN latest, sequence slot ganjil selama ditulis, lalu genap
+ * dan latest menunjuk slot itu. Writer tidak pernah menunggu reader;
+ * reader membaca langsung dari mapping (tanpa copy) dan memvalidasi
+ * dengan sequence setelah selesai:
+ *
+ *   int fd = shm_open(TJ_STATE_NAME, O_RDONLY, 0);
+ *   struct stat st;
+ *   fstat(fd, &st);
+ *   const uint8_t* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+ *
+ *   uint64_t seq;
+ *   const tj_state_slot* s = tj_state_begin_read(base, &seq);
+ *   if (s) {
+ *     const tj_state_track* t = tj_state_tracks(s);
+ *     const float* d = (const float*)tj_state_array(s, t[0].distance_offset);
+ *     ... pakai d[0 .. t[0].vehicle_count) ...
+ *     if (!tj_state_end_read(s, seq)) { hasil dibuang: slot ditimpa, ulangi }
+ *   }
+ *
+ * Slot hanya ditimpa dua step kemudian, jadi reader yang selesai dalam
+ * satu step hampir tidak pernah mengulang. Offset dan count di dalam slot
+ * juga baru boleh dipercaya setelah tj_state_end_read() (selalu cek batas
+ * terhadap slot_bytes sebelum dereference).
+ *
+ * Semua angka little-endian native; float = IEEE 754 32 bit.
+ */
+#include <stdint.h>
+
+#define TJ_STATE_NAME "/trafficjam-state" /* POSIX shm_open; Windows: "Local\\trafficjam-state" */
+#define TJ_STATE_MAGIC 0x54534a54u        /* "TJST" */
+#define TJ_STATE_VERSION 1u
+#define TJ_STATE_SLOT_COUNT 2u
+#define TJ_STATE_NO_SLOT 0xffffffffu      /* latest sebelum step pertama */
+#define TJ_STATE_ALIGN 16u
+
+/* tj_state_slot.flags */
+#define TJ_STATE_FLAG_TRUNCATED 1u        /* Slot penuh: sebagian track vehicle_count = 0 */
+
+/* tj_state_track.physics (sama dengan "physics" di scenario) */
+#define TJ_STATE_PHYSICS_FLOAT 0u
+#define TJ_STATE_PHYSICS_INTEGER 1u
+#define TJ_STATE_PHYSICS_MACRO 2u         /* Tanpa kendaraan: vehicle_count = 0 */
+#define TJ_STATE_PHYSICS_HYBRID 3u        /* Hanya kendaraan di region micro */
+
+typedef struct tj_state_header {
+  uint32_t magic;                          /* Ditulis terakhir saat region dibuat */
+  uint32_t version;
+  uint64_t region_bytes;
+  uint64_t slot_offset[TJ_STATE_SLOT_COUNT];
+  uint64_t slot_bytes;
+  uint64_t writer_pid;
+  uint32_t latest;                         /* Atomic: slot terakhir yang lengkap */
+  uint32_t closed;                         /* Atomic: 1 = writer berhenti (region tidak di-update lagi) */
+  uint64_t publish_count;                  /* Atomic: jumlah step yang sudah dipublikasikan */
+  uint8_t reserved[192];
+} tj_state_header;
+
+typedef struct tj_state_slot {
+  uint64_t sequence;                       /* Atomic seqlock: ganjil = sedang ditulis */
+  uint64_t step;                           /* Nomor step simulasi */
+  uint32_t track_count;
+  uint32_t flags;
+  uint64_t used_bytes;
+  uint64_t track_offset;                   /* tj_state_track[track_count] */
+  uint64_t reserved[3];
+} tj_state_slot;
+
+typedef struct tj_state_track {
+  uint32_t vehicle_count;
+  uint32_t body_point_count;
+  uint32_t lane_count;
+  uint32_t physics;                        /* TJ_STATE_PHYSICS_* */
+  uint32_t max_cells;                      /* Panjang lajur (cells) */
+  uint32_t reserved;
+  uint64_t distance_offset;                /* float[vehicle_count], cells sepanjang lajur */
+  uint64_t velocity_offset;                /* float[vehicle_count], cells per step */
+  uint64_t lane_offset;                    /* uint8_t[vehicle_count] */
+  uint64_t color_offset;                   /* float[3 * vehicle_count], RGB 0..1 */
+  uint64_t body_begin_offset;              /* uint32_t[vehicle_count + 1]: body kendaraan i = [b[i], b[i + 1]) */
+  uint64_t body_point_offset;              /* float[2 * body_point_count], x y layar (pixels) */
+} tj_state_track;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TJ_STATE_LOAD_ACQUIRE_U32(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TJ_STATE_LOAD_ACQUIRE_U64(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TJ_STATE_LOAD_RELAXED_U64(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define TJ_STATE_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+/* x86 / x64: load biasa sudah acquire, cukup cegah reorder compiler */
+#define TJ_STATE_LOAD_ACQUIRE_U32(p) (*(const volatile uint32_t*)(p))
+#define TJ_STATE_LOAD_ACQUIRE_U64(p) (*(const volatile uint64_t*)(p))
+#define TJ_STATE_LOAD_RELAXED_U64(p) (*(const volatile uint64_t*)(p))
+#define TJ_STATE_FENCE_ACQUIRE() _ReadWriteBarrier()
+#else
+#error "SharedStateFormat.h: butuh GCC / Clang, atau MSVC x86 / x64"
+#endif
+
+/**
+ * Mulai membaca slot terbaru. NULL kalau region belum siap / belum ada
+ * step / writer sedang menulis slot itu (coba lagi)
+ */
+static inline const tj_state_slot* tj_state_begin_read(const void* base, uint64_t* sequence) {
+  const tj_state_header* h = (const tj_state_header*)base;
+  if (TJ_STATE_LOAD_ACQUIRE_U32(&h->magic) != TJ_STATE_MAGIC || h->version != TJ_STATE_VERSION) return 0;
+
+  const uint32_t latest = TJ_STATE_LOAD_ACQUIRE_U32(&h->latest);
+  if (latest >= TJ_STATE_SLOT_COUNT) return 0;
+
+  const tj_state_slot* s = (const tj_state_slot*)((const uint8_t*)base + h->slot_offset[latest]);
+  *sequence = TJ_STATE_LOAD_ACQUIRE_U64(&s->sequence);
+  return (*sequence & 1u) ? 0 : s;
+}
+
+/* 1 = semua yang dibaca sejak tj_state_begin_read() konsisten, 0 = ulangi */
+static inline int tj_state_end_read(const tj_state_slot* s, uint64_t sequence) {
+  TJ_STATE_FENCE_ACQUIRE();
+  return TJ_STATE_LOAD_RELAXED_U64(&s->sequence) == sequence;
+}
+
+static inline const tj_state_track* tj_state_tracks(const tj_state_slot* s) {
+  return (const tj_state_track*)((const uint8_t*)s + s->track_offset);
+}
+
+static inline const void* tj_state_array(const tj_state_slot* s, uint64_t offset) {
+  return (const uint8_t*)s + offset;
+}
+
+#endif /* TRAFFIC_JALANAN_SHARED_STATE_FORMAT_H */
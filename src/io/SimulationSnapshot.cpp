@@ -0,0 +1,163 @@
+#include "SimulationSnapshot.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const uint64_t ARRAY_ALIGN = 16;
+
+inline uint64_t alignUp(uint64_t offset) {
+  return (offset + ARRAY_ALIGN - 1) & ~(ARRAY_ALIGN - 1);
+}
+
+// Range [offset, offset + bytes) harus di dalam file dan ter-align
+inline bool rangeValid(uint64_t offset, uint64_t bytes, uint64_t fileSize) {
+  return offset % ARRAY_ALIGN == 0 && offset <= fileSize && bytes <= fileSize - offset;
+}
+
+} // namespace
+
+bool snapshot::isLittleEndianHost() {
+  const uint16_t probe = 1;
+  uint8_t first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+//--------------------------------------------------------------
+SnapshotWriter::SnapshotWriter(uint64_t globalStep, uint32_t roadType,
+                               const std::vector<snapshot::SnapshotTrack>& tracks) {
+  using namespace snapshot;
+
+  // 1. Layout: header, tabel track, lalu array tiap track (align 16)
+  std::vector<SnapshotTrack> records(tracks);
+  uint64_t offset = alignUp(sizeof(SnapshotHeader) + records.size() * sizeof(SnapshotTrack));
+
+  for (SnapshotTrack& t : records) {
+    const uint64_t n = t.vehicleCount;
+    t.distanceOffset = offset;  offset = alignUp(offset + n * sizeof(float));
+    t.velocityOffset = offset;  offset = alignUp(offset + n * sizeof(float));
+    t.colorOffset = offset;     offset = alignUp(offset + n * 3 * sizeof(float));
+    t.laneOffset = offset;      offset = alignUp(offset + n);
+    t.typeOffset = offset;      offset = alignUp(offset + n);
+    t.segmentOffset = offset;   offset = alignUp(offset + n * t.segmentsPerVehicle * sizeof(float));
+    t.cellOffset = offset;      offset = alignUp(offset + (uint64_t)t.cellCount * sizeof(float));
+  }
+
+  // 2. Satu buffer untuk seluruh file (padding otomatis nol)
+  buffer.assign((size_t)offset, 0);
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.endianTag = ENDIAN_TAG;
+  header.headerSize = sizeof(SnapshotHeader);
+  header.trackSize = sizeof(SnapshotTrack);
+  header.trackCount = (uint32_t)records.size();
+  header.roadType = roadType;
+  header.globalStep = globalStep;
+  header.fileSize = offset;
+  header.tracksOffset = sizeof(SnapshotHeader);
+
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  if (!records.empty()) {
+    std::memcpy(buffer.data() + header.tracksOffset, records.data(), records.size() * sizeof(SnapshotTrack));
+  }
+
+  // 3. Pointer array untuk diisi caller
+  uint8_t* base = buffer.data();
+  arrays.resize(records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    const SnapshotTrack& t = records[i];
+    arrays[i].distance = reinterpret_cast<float*>(base + t.distanceOffset);
+    arrays[i].velocity = reinterpret_cast<float*>(base + t.velocityOffset);
+    arrays[i].color = reinterpret_cast<float*>(base + t.colorOffset);
+    arrays[i].lane = base + t.laneOffset;
+    arrays[i].type = base + t.typeOffset;
+    arrays[i].segments = reinterpret_cast<float*>(base + t.segmentOffset);
+    arrays[i].cells = reinterpret_cast<float*>(base + t.cellOffset);
+  }
+}
+
+bool SnapshotWriter::save(const std::string& path) const {
+  if (!snapshot::isLittleEndianHost()) return false;
+
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+
+  // Satu write untuk seluruh snapshot
+  size_t written = std::fwrite(buffer.data(), 1, buffer.size(), f);
+  bool ok = (written == buffer.size());
+  ok = (std::fclose(f) == 0) && ok;
+  return ok;
+}
+
+//--------------------------------------------------------------
+bool SnapshotReader::load(const std::string& path) {
+  using namespace snapshot;
+  close();
+
+  if (!isLittleEndianHost() || !file.open(path)) return false;
+
+  const uint8_t* base = file.data();
+  const uint64_t size = file.size();
+  if (size < sizeof(SnapshotHeader)) {
+    close();
+    return false;
+  }
+
+  const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(base);
+  bool headerOk = std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                  h->version == FORMAT_VERSION &&
+                  h->endianTag == ENDIAN_TAG &&
+                  h->headerSize == sizeof(SnapshotHeader) &&
+                  h->trackSize == sizeof(SnapshotTrack) &&
+                  h->fileSize == size &&
+                  h->tracksOffset == sizeof(SnapshotHeader) &&
+                  (uint64_t)h->trackCount * sizeof(SnapshotTrack) <= size - h->tracksOffset;
+  if (!headerOk) {
+    close();
+    return false;
+  }
+
+  const SnapshotTrack* t = reinterpret_cast<const SnapshotTrack*>(base + h->tracksOffset);
+
+  // Validasi semua range array sebelum pointer dipakai
+  arrays.resize(h->trackCount);
+  for (uint32_t i = 0; i < h->trackCount; i++) {
+    const uint64_t n = t[i].vehicleCount;
+    const uint64_t segs = t[i].segmentsPerVehicle;
+    bool ok = n <= size && segs <= 1024 &&
+              rangeValid(t[i].distanceOffset, n * sizeof(float), size) &&
+              rangeValid(t[i].velocityOffset, n * sizeof(float), size) &&
+              rangeValid(t[i].colorOffset, n * 3 * sizeof(float), size) &&
+              rangeValid(t[i].laneOffset, n, size) &&
+              rangeValid(t[i].typeOffset, n, size) &&
+              rangeValid(t[i].segmentOffset, n * segs * sizeof(float), size) &&
+              rangeValid(t[i].cellOffset, (uint64_t)t[i].cellCount * sizeof(float), size);
+    if (!ok) {
+      close();
+      return false;
+    }
+
+    arrays[i].distance = reinterpret_cast<const float*>(base + t[i].distanceOffset);
+    arrays[i].velocity = reinterpret_cast<const float*>(base + t[i].velocityOffset);
+    arrays[i].color = reinterpret_cast<const float*>(base + t[i].colorOffset);
+    arrays[i].lane = base + t[i].laneOffset;
+    arrays[i].type = base + t[i].typeOffset;
+    arrays[i].segments = reinterpret_cast<const float*>(base + t[i].segmentOffset);
+    arrays[i].cells = reinterpret_cast<const float*>(base + t[i].cellOffset);
+  }
+
+  header = h;
+  tracks = t;
+  return true;
+}
+
+void SnapshotReader::close() {
+  header = nullptr;
+  tracks = nullptr;
+  arrays.clear();
+  file.close();
+}
@@ -0,0 +1,217 @@
+#pragma once
+#include "../entities/VehicleSpec.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * SimulationSnapshot - Format binary untuk save/restore state simulasi
+ *
+ * Layout file (little-endian, semua offset absolut dari awal file):
+ *
+ *   [SnapshotHeader]                      64 bytes
+ *   [SnapshotTrack x trackCount]          240 bytes per track
+ *   [array per track, tiap array align 16 bytes]
+ *     distance[n]   float   posisi kepala (cells)
+ *     velocity[n]   float
+ *     color[n * 3]  float   RGB 0-1
+ *     lane[n]       uint8
+ *     type[n]       uint8   VehicleType
+ *     segment[n * segmentsPerVehicle]  float  body segment distances
+ *     cell[cellCount]  float   kendaraan per cell CTM (physics macro / hybrid)
+ *
+ * Array disimpan SoA dengan tipe yang sama persis dengan di memori, jadi
+ * SnapshotReader cukup mmap file + validasi header, lalu pointer array
+ * langsung menunjuk ke halaman file (tanpa parsing / copy).
+ *
+ * Host big-endian tidak didukung (writer menolak, reader menolak file
+ * dengan endianTag yang terbalik). Semua target build (x64, ARM64) LE.
+ *
+ * Versi format naik setiap kali layout struct di bawah berubah.
+ */
+namespace snapshot {
+
+const uint32_t FORMAT_VERSION = 4;
+const uint32_t ENDIAN_TAG = 0x01020304u;  // Di file LE tersimpan 04 03 02 01
+const char MAGIC[8] = {'T', 'J', 'S', 'N', 'A', 'P', '\r', '\n'};
+
+// Bit untuk SnapshotTrack::flags
+enum TrackFlags : uint32_t {
+  FLAG_VISIBLE = 1u << 0,
+  FLAG_DRAW_FROM_CENTER = 1u << 1,
+  FLAG_GRADIENT_MODE = 1u << 2,
+  FLAG_INTEGER_PHYSICS = 1u << 3,  // IntegerNaSch (lihat caInterval)
+  FLAG_MACRO_PHYSICS = 1u << 4,    // CellTransmission (lihat cellCount)
+  FLAG_HYBRID_PHYSICS = 1u << 5    // CellTransmission + region micro
+};
+
+// Bit untuk SnapshotTrack::ruleFlags (NaSchRules, physics integer)
+enum RuleFlags : uint32_t {
+  RULE_VDR = 1u << 0,
+  RULE_SLOW_TO_START = 1u << 1,
+  RULE_ANTICIPATION = 1u << 2
+};
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianTag;
+  uint32_t headerSize;   // sizeof(SnapshotHeader)
+  uint32_t trackSize;    // sizeof(SnapshotTrack)
+  uint32_t trackCount;
+  uint32_t roadType;     // RoadType global saat disimpan
+  uint64_t globalStep;   // Step simulasi global (semua track)
+  uint64_t fileSize;     // Untuk deteksi file terpotong
+  uint64_t tracksOffset;
+  uint64_t reserved;
+};
+
+struct SnapshotTrack {
+  // Road
+  uint32_t roadType;
+  int32_t direction;
+  int32_t maxCells;
+  int32_t numLanes;
+  float boundsX, boundsY, boundsW, boundsH;
+  float laneWidth;
+
+  // Parameter NaSch
+  float maxV;
+  float spiralMaxV;
+  float probSlow;
+
+  // Visual
+  int32_t numLinesPerCar;
+  float curveIntensity;
+  float curveAngle1;
+  float curveAngle2;
+  uint32_t flags;  // TrackFlags
+
+  // Lane change
+  uint32_t laneMode;
+  float probLaneChange;
+
+  // Komposisi jenis kendaraan (untuk spawn ulang setelah reset)
+  float fleetMix[VEHICLE_TYPE_COUNT];
+
+  // RNG berbasis counter: seed + nomor step sudah cukup untuk melanjutkan
+  uint64_t rngSeed;
+  uint64_t stepCount;
+
+  // Kendaraan
+  uint64_t vehicleCount;
+  uint32_t segmentsPerVehicle;
+  uint32_t caInterval;  // Step simulasi per step CA (physics integer)
+
+  // Offset array (diisi SnapshotWriter)
+  uint64_t distanceOffset;
+  uint64_t velocityOffset;
+  uint64_t colorOffset;
+  uint64_t laneOffset;
+  uint64_t typeOffset;
+  uint64_t segmentOffset;
+
+  // Varian aturan CA (NaSchRules)
+  uint32_t ruleFlags;  // RuleFlags
+  float probSlowStopped;
+  float probSlowToStart;
+  int32_t slowToStartGap;
+  int32_t anticipationSafety;
+
+  // Physics macro (CellTransmission)
+  uint32_t cellCount;
+  float waveSpeed;
+  int32_t ctmCellLength;
+  uint64_t cellOffset;
+
+  // Physics hybrid: region micro (cell CTM) + state handoff di batasnya
+  uint32_t microFirstCell;
+  uint32_t microCellCount;
+  float entryCredit;
+  float exitCredit;
+  uint32_t handoffSerial;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader layout berubah, naikkan FORMAT_VERSION");
+static_assert(sizeof(SnapshotTrack) == 240, "SnapshotTrack layout berubah, naikkan FORMAT_VERSION");
+
+// Pointer ke array satu track (mutable untuk writer, const untuk reader)
+template <typename F, typename B>
+struct TrackArrays {
+  F* distance = nullptr;
+  F* velocity = nullptr;
+  F* color = nullptr;  // 3 float per kendaraan
+  B* lane = nullptr;
+  B* type = nullptr;
+  F* segments = nullptr;  // segmentsPerVehicle float per kendaraan
+  F* cells = nullptr;     // cellCount float (physics macro)
+};
+
+bool isLittleEndianHost();
+
+} // namespace snapshot
+
+/**
+ * SnapshotWriter - Susun seluruh snapshot di SATU buffer, tulis sekali
+ *
+ * Pemakaian:
+ * 1. Isi SnapshotTrack per track (termasuk vehicleCount & segmentsPerVehicle)
+ * 2. SnapshotWriter writer(globalStep, roadType, tracks)  → layout + alokasi
+ * 3. Isi array lewat writer.getArrays(i) (langsung ke buffer file)
+ * 4. writer.save(path)  → satu fwrite
+ */
+class SnapshotWriter {
+public:
+  using Arrays = snapshot::TrackArrays<float, uint8_t>;
+
+  SnapshotWriter(uint64_t globalStep, uint32_t roadType,
+                 const std::vector<snapshot::SnapshotTrack>& tracks);
+
+  int getTrackCount() const { return (int)arrays.size(); }
+  const Arrays& getArrays(int track) const { return arrays[track]; }
+
+  // Tulis buffer ke file (satu kali write). false kalau gagal / host big-endian
+  bool save(const std::string& path) const;
+
+  size_t getByteSize() const { return buffer.size(); }
+
+private:
+  std::vector<uint8_t> buffer;
+  std::vector<Arrays> arrays;
+};
+
+/**
+ * SnapshotReader - Buka snapshot via mmap, tanpa parsing
+ *
+ * load() hanya memvalidasi header dan range offset. Semua pointer dari
+ * getTrack()/getArrays() menunjuk langsung ke file yang di-map dan valid
+ * sampai close() atau reader di-destroy.
+ */
+class SnapshotReader {
+public:
+  using Arrays = snapshot::TrackArrays<const float, const uint8_t>;
+
+  /**
+   * @return false kalau file tidak ada, magic/versi/endian tidak cocok,
+   *         atau ukuran/offset tidak valid (file rusak atau terpotong)
+   */
+  bool load(const std::string& path);
+  void close();
+
+  bool isLoaded() const { return header != nullptr; }
+  uint64_t getGlobalStep() const { return header->globalStep; }
+  uint32_t getRoadType() const { return header->roadType; }
+  int getTrackCount() const { return (int)header->trackCount; }
+
+  const snapshot::SnapshotTrack& getTrack(int track) const { return tracks[track]; }
+  const Arrays& getArrays(int track) const { return arrays[track]; }
+
+private:
+  MappedFile file;
+  const snapshot::SnapshotHeader* header = nullptr;
+  const snapshot::SnapshotTrack* tracks = nullptr;
+  std::vector<Arrays> arrays;
+};
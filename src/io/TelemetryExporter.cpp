@@ -0,0 +1,184 @@
+#include "TelemetryExporter.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace {
+
+const size_t SAMPLE_QUEUE = 16384;  // Cukup untuk > 1 detik @ 60 step, 200 track
+const size_t STEP_QUEUE = 1024;
+const uint32_t MAX_TRACKS = 4096;   // Indeks track di atas ini dianggap rusak
+
+}  // namespace
+
+TelemetryExporter::TelemetryExporter()
+    : samples(SAMPLE_QUEUE), steps(STEP_QUEUE), exporting(false), running(false),
+      droppedSamples(0), exports(0), csv(nullptr) {}
+
+TelemetryExporter::~TelemetryExporter() { stop(); }
+
+bool TelemetryExporter::start(const std::string& csvPath, const std::string& promFile, int intervalMs) {
+  stop();
+
+  csv = std::fopen(csvPath.c_str(), "w");
+  if (!csv) return false;
+  std::fprintf(csv, "step,track,cars,density,flow,mean_velocity,velocity_variance,stopped_fraction\n");
+
+  promPath = promFile;
+  promTmpPath = promFile + ".tmp";
+  interval = std::chrono::milliseconds(std::max(10, intervalMs));
+  history.clear();
+  stepWindow.reset(HISTORY);
+  droppedSamples = 0;
+  exports = 0;
+
+  running.store(true, std::memory_order_release);
+  exporting = true;
+  worker = std::thread(&TelemetryExporter::workerLoop, this);
+  return true;
+}
+
+void TelemetryExporter::stop() {
+  if (!exporting) return;
+
+  // Exporter thread menguras antrian + export terakhir sebelum keluar
+  running.store(false, std::memory_order_release);
+  if (worker.joinable()) worker.join();
+
+  std::fclose(csv);
+  csv = nullptr;
+  exporting = false;
+}
+
+void TelemetryExporter::submit(const TrackSample& sample) {
+  if (!exporting) return;
+  if (!samples.push(sample)) {
+    droppedSamples.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void TelemetryExporter::submitStep(const StepTiming& timing) {
+  if (!exporting) return;
+  steps.push(timing);  // Penuh: window throughput cukup tanpa step ini
+}
+
+void TelemetryExporter::workerLoop() {
+  auto nextExport = std::chrono::steady_clock::now() + interval;
+
+  for (;;) {
+    // Producer sudah berhenti push sebelum running = false (lihat stop()),
+    // jadi drain() setelahnya mengambil semua sampel yang tersisa
+    const bool last = !running.load(std::memory_order_acquire);
+    drain();
+
+    auto now = std::chrono::steady_clock::now();
+    if (last || now >= nextExport) {
+      std::fflush(csv);
+      writePrometheus();
+      exports.fetch_add(1, std::memory_order_relaxed);
+      nextExport = now + interval;
+    }
+    if (last) break;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+}
+
+void TelemetryExporter::drain() {
+  TrackSample s;
+  while (samples.pop(s)) {
+    if (s.track >= MAX_TRACKS) continue;
+    if (s.track >= history.size()) history.resize(s.track + 1);
+
+    TrackHistory& h = history[s.track];
+    h.window.push(s);
+    h.flowTotal += s.flow;
+
+    std::fprintf(csv, "%llu,%u,%d,%.6g,%.6g,%.6g,%.6g,%.6g\n", (unsigned long long)s.step, s.track, s.cars,
+                 s.density, s.flow, s.meanVelocity, s.velocityVariance, s.stoppedFraction);
+  }
+
+  StepTiming t;
+  while (steps.pop(t)) {
+    stepWindow.push(t);
+  }
+}
+
+void TelemetryExporter::writePrometheus() {
+  FILE* f = std::fopen(promTmpPath.c_str(), "w");
+  if (!f) return;
+
+  // Satu metrik = HELP + TYPE + satu baris per track
+  auto perTrack = [&](const char* name, const char* type, const char* help, auto value) {
+    std::fprintf(f, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    for (size_t t = 0; t < history.size(); t++) {
+      if (history[t].window.empty()) continue;
+      std::fprintf(f, "%s{track=\"%zu\"} %.9g\n", name, t, (double)value(history[t]));
+    }
+  };
+
+  // Agregat window (HISTORY step terakhir) per track
+  auto windowMean = [](const TrackHistory& h, float TrackSample::*field) {
+    RunningStats s;
+    for (size_t i = 0; i < h.window.size(); i++) s.add(h.window[i].*field);
+    return s.mean;
+  };
+
+  // Velocity semua kendaraan di window: gabung mean / variance per step (Chan)
+  auto pooledVelocity = [](const TrackHistory& h) {
+    RunningStats s;
+    for (size_t i = 0; i < h.window.size(); i++) {
+      const TrackSample& x = h.window[i];
+      s.merge((uint64_t)x.cars, x.meanVelocity, (double)x.velocityVariance * x.cars);
+    }
+    return s;
+  };
+
+  perTrack("traffic_vehicles", "gauge", "Kendaraan di track (step terakhir)",
+           [](const TrackHistory& h) { return h.window.back().cars; });
+  perTrack("traffic_density", "gauge", "Kendaraan per cell, rata-rata window",
+           [&](const TrackHistory& h) { return windowMean(h, &TrackSample::density); });
+  perTrack("traffic_flow_per_step", "gauge", "Kendaraan melewati detector per step, rata-rata window",
+           [](const TrackHistory& h) {
+             double sum = 0.0;
+             for (size_t i = 0; i < h.window.size(); i++) sum += h.window[i].flow;
+             return sum / (double)h.window.size();
+           });
+  perTrack("traffic_flow_total", "counter", "Kendaraan melewati detector sejak export dimulai",
+           [](const TrackHistory& h) { return h.flowTotal; });
+  perTrack("traffic_velocity_mean", "gauge", "Velocity kendaraan (cells per step), window",
+           [&](const TrackHistory& h) { return pooledVelocity(h).mean; });
+  perTrack("traffic_velocity_variance", "gauge", "Variance velocity kendaraan, window",
+           [&](const TrackHistory& h) { return pooledVelocity(h).variance(); });
+  perTrack("traffic_stopped_fraction", "gauge", "Fraksi kendaraan berhenti, rata-rata window",
+           [&](const TrackHistory& h) { return windowMean(h, &TrackSample::stoppedFraction); });
+
+  // Throughput simulasi
+  if (!stepWindow.empty()) {
+    RunningStats stepTime;
+    for (size_t i = 0; i < stepWindow.size(); i++) stepTime.add(stepWindow[i].seconds);
+
+    const StepTiming& first = stepWindow[0];
+    const StepTiming& last = stepWindow.back();
+    double wall = last.time - first.time;
+    double perSecond = (wall > 0.0) ? (double)(stepWindow.size() - 1) / wall : 0.0;
+
+    std::fprintf(f, "# HELP sim_steps_total Step simulasi sejak export dimulai\n# TYPE sim_steps_total counter\n");
+    std::fprintf(f, "sim_steps_total %llu\n", (unsigned long long)stepWindow.getPushed());
+    std::fprintf(f, "# HELP sim_steps_per_second Step simulasi per detik, window\n# TYPE sim_steps_per_second gauge\n");
+    std::fprintf(f, "sim_steps_per_second %.9g\n", perSecond);
+    std::fprintf(f, "# HELP sim_step_seconds_mean Lama satu step, window\n# TYPE sim_step_seconds_mean gauge\n");
+    std::fprintf(f, "sim_step_seconds_mean %.9g\n", stepTime.mean);
+    std::fprintf(f, "# HELP sim_step_seconds_variance Variance lama step, window\n# TYPE sim_step_seconds_variance gauge\n");
+    std::fprintf(f, "sim_step_seconds_variance %.9g\n", stepTime.variance());
+  }
+
+  std::fprintf(f, "# HELP telemetry_dropped_samples_total Sampel dibuang karena antrian penuh\n"
+                  "# TYPE telemetry_dropped_samples_total counter\n");
+  std::fprintf(f, "telemetry_dropped_samples_total %llu\n",
+               (unsigned long long)droppedSamples.load(std::memory_order_relaxed));
+  std::fclose(f);
+
+  // Ganti file lama sekaligus
+  std::error_code ec;
+  std::filesystem::rename(promTmpPath, promPath, ec);
+}
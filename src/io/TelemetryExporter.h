@@ -0,0 +1,99 @@
+#pragma once
+#include "../simulation/TrafficStats.h"
+#include "../util/RingBuffer.h"
+#include "../util/SpscQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * StepTiming - Durasi satu simulationStep() (throughput simulasi)
+ */
+struct StepTiming {
+  uint64_t step = 0;
+  float seconds = 0.0f;  // Lama step (semua track)
+  double time = 0.0;     // Waktu selesai step (steady clock, detik)
+};
+
+/**
+ * TelemetryExporter - Kirim TrackSample tiap step ke CSV + Prometheus textfile
+ *
+ * Alur:
+ * 1. Thread simulasi: submit() / submitStep() per step → SpscQueue
+ *    (lock-free, tanpa alokasi; antrian penuh = sampel di-drop & dihitung)
+ * 2. Exporter thread: kuras antrian, tulis baris CSV per sampel, simpan
+ *    sampel ke RingBuffer per track (HISTORY step terakhir)
+ * 3. Tiap interval: flush CSV + tulis ulang file Prometheus dari window
+ *    di ring buffer (tulis ke .tmp lalu rename, supaya node_exporter
+ *    tidak pernah membaca file setengah jadi)
+ *
+ * Metrik Prometheus (label track = indeks track):
+ *   traffic_vehicles, traffic_density, traffic_flow_per_step,
+ *   traffic_flow_total, traffic_velocity_mean, traffic_velocity_variance,
+ *   traffic_stopped_fraction, sim_steps_total, sim_steps_per_second,
+ *   sim_step_seconds_mean, sim_step_seconds_variance,
+ *   telemetry_dropped_samples_total
+ *
+ * start() / stop() / submit*() dipanggil dari thread yang sama (thread
+ * simulasi), kecuali stop() terakhir saat thread simulasi sudah berhenti.
+ */
+class TelemetryExporter {
+public:
+  static const size_t HISTORY = 600;  // Step per track di window (± 10 detik @ 60 fps)
+
+  TelemetryExporter();
+  ~TelemetryExporter();
+
+  TelemetryExporter(const TelemetryExporter&) = delete;
+  TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+  /**
+   * Buka CSV (ditimpa, header ditulis ulang) + mulai exporter thread
+   * @param intervalMs Jarak antar flush CSV / tulis Prometheus
+   */
+  bool start(const std::string& csvPath, const std::string& promPath, int intervalMs = 1000);
+
+  // Kuras antrian, export terakhir, tutup file
+  void stop();
+
+  bool isRunning() const { return exporting; }
+
+  // Thread simulasi: satu sampel track / satu step
+  void submit(const TrackSample& sample);
+  void submitStep(const StepTiming& timing);
+
+  uint64_t getDroppedSamples() const { return droppedSamples.load(std::memory_order_relaxed); }
+  uint64_t getExports() const { return exports.load(std::memory_order_relaxed); }
+
+private:
+  // ===== Dipakai thread simulasi =====
+  SpscQueue<TrackSample> samples;
+  SpscQueue<StepTiming> steps;
+  bool exporting;
+
+  std::thread worker;
+  std::atomic<bool> running;
+  std::atomic<uint64_t> droppedSamples;
+  std::atomic<uint64_t> exports;
+
+  // ===== Dipakai exporter thread saja =====
+  struct TrackHistory {
+    RingBuffer<TrackSample> window{HISTORY};
+    double flowTotal = 0.0;  // Pecahan dari track CTM
+  };
+
+  FILE* csv;
+  std::string promPath;
+  std::string promTmpPath;
+  std::chrono::milliseconds interval{1000};
+  std::vector<TrackHistory> history;  // Indeks = TrackSample::track
+  RingBuffer<StepTiming> stepWindow{HISTORY};
+
+  void workerLoop();
+  void drain();
+  void writePrometheus();
+};
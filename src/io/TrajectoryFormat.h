@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * TrajectoryFormat - Layout file rekaman trajektori (.tjt)
+ *
+ *   [TrajectoryHeader]                      64 bytes
+ *   [chunk 0][chunk 1]...                   tiap chunk = kelipatan chunkSize
+ *   [TrajectoryIndexEntry x chunkCount]
+ *   [TrajectoryFooter]                      32 bytes (di akhir file)
+ *
+ * Chunk:
+ *   [TrajectoryChunkHeader] 24 bytes + payload, di-pad nol sampai chunkSize
+ *   (satu step yang lebih besar dari chunkSize memakai beberapa chunkSize)
+ *
+ * Payload = deretan step, tiap step:
+ *   varint  stepDelta        (step - step sebelumnya di chunk, step pertama = 0)
+ *   per track:
+ *     varint  vehicleCount
+ *     varint  runCount, per run: varint idGap, varint runLength
+ *     per kendaraan: zigzag varint dVelocity, zigzag varint residualDistance
+ *     lane: absolut → per kendaraan varint lane
+ *           delta   → varint changeCount, per perubahan: varint indexGap, varint lane
+ *
+ * Id kendaraan = urutan kendaraan di track saat rekaman dimulai, naik
+ * terus (black hole hanya menghapus, urutan sisanya tetap). Disimpan
+ * sebagai run id berurutan: run pertama mulai di idGap, run berikutnya
+ * di akhir run sebelumnya + idGap. Tanpa kendaraan hilang = satu run.
+ * indexGap perubahan lane relatif ke indeks perubahan sebelumnya + 1.
+ *
+ * Distance & velocity dikuantisasi ke 1/QUANT_SCALE cell, lalu:
+ * - dVelocity        = v - vSebelumnya
+ * - residualDistance = d - (dSebelumnya + v)   (prediksi aturan Move NaSch)
+ * Hampir semua kendaraan residual-nya 0 (kecuali saat wrap satu putaran),
+ * jadi satu kendaraan biasanya cukup 2 byte per step.
+ * Delta di-reset ke 0 (nilai absolut) di awal tiap chunk dan saat id
+ * kendaraan track berubah, jadi SETIAP chunk bisa di-decode sendiri →
+ * seek cukup lompat ke chunk lewat index lalu decode maju.
+ *
+ * Kalau footer tidak ada (aplikasi crash saat merekam), index bisa
+ * dibangun ulang dengan scan header chunk (semua chunk mulai di kelipatan
+ * chunkSize setelah header file).
+ */
+namespace trajectory {
+
+const uint32_t FORMAT_VERSION = 2;  // 2: id + lane kendaraan
+const uint32_t ENDIAN_TAG = 0x01020304u;
+const char MAGIC[8] = {'T', 'J', 'T', 'R', 'A', 'J', '\r', '\n'};
+const char FOOTER_MAGIC[8] = {'T', 'J', 'T', 'I', 'N', 'D', 'E', 'X'};
+const uint32_t CHUNK_MAGIC = 0x4B434A54u;  // "TJCK"
+
+const float QUANT_SCALE = 1024.0f;            // Resolusi 1/1024 cell
+const uint32_t DEFAULT_CHUNK_SIZE = 1024 * 1024;  // Granularitas seek vs overhead keyframe
+
+struct TrajectoryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endianTag;
+  uint32_t headerSize;
+  uint32_t chunkSize;
+  uint32_t trackCount;
+  float quantScale;
+  uint64_t reserved[4];
+};
+
+struct TrajectoryChunkHeader {
+  uint32_t magic;         // CHUNK_MAGIC
+  uint32_t payloadBytes;
+  uint32_t stepCount;
+  uint32_t reserved;
+  uint64_t firstStep;
+};
+
+struct TrajectoryIndexEntry {
+  uint64_t firstStep;
+  uint64_t offset;      // Offset chunk dari awal file
+  uint32_t stepCount;
+  uint32_t reserved;
+  uint64_t lastStep;
+};
+
+struct TrajectoryFooter {
+  uint64_t indexOffset;
+  uint64_t chunkCount;
+  uint64_t totalSteps;
+  char magic[8];
+};
+
+static_assert(sizeof(TrajectoryHeader) == 64, "TrajectoryHeader layout berubah, naikkan FORMAT_VERSION");
+static_assert(sizeof(TrajectoryChunkHeader) == 24, "TrajectoryChunkHeader layout berubah, naikkan FORMAT_VERSION");
+static_assert(sizeof(TrajectoryIndexEntry) == 32, "TrajectoryIndexEntry layout berubah, naikkan FORMAT_VERSION");
+static_assert(sizeof(TrajectoryFooter) == 32, "TrajectoryFooter layout berubah, naikkan FORMAT_VERSION");
+
+} // namespace trajectory
@@ -0,0 +1,265 @@
+#include "TrajectoryPlayer.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace trajectory;
+
+bool TrajectoryPlayer::open(const std::string& path) {
+  close();
+  if (!file.open(path)) return false;
+
+  if (file.size() < sizeof(TrajectoryHeader)) {
+    close();
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  bool headerOk = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                  header.version == FORMAT_VERSION &&
+                  header.endianTag == ENDIAN_TAG &&
+                  header.headerSize == sizeof(TrajectoryHeader) &&
+                  header.chunkSize >= 4096 && header.quantScale > 0.0f;
+  if (!headerOk) {
+    close();
+    return false;
+  }
+
+  // Footer tidak ada / rusak (rekaman terputus) → scan header chunk
+  if (!readIndexFromFooter()) {
+    rebuildIndexByScan();
+  }
+  if (index.empty()) {
+    close();
+    return false;
+  }
+
+  qDist.assign(header.trackCount, {});
+  qVel.assign(header.trackCount, {});
+  dist.assign(header.trackCount, {});
+  vel.assign(header.trackCount, {});
+  ids.assign(header.trackCount, {});
+  prevIds.assign(header.trackCount, {});
+  lanes.assign(header.trackCount, {});
+
+  return rewind();
+}
+
+void TrajectoryPlayer::close() {
+  file.close();
+  index.clear();
+  qDist.clear();
+  qVel.clear();
+  dist.clear();
+  vel.clear();
+  ids.clear();
+  prevIds.clear();
+  lanes.clear();
+  cursor = chunkEnd = nullptr;
+  stepsLeft = 0;
+  currentStep = 0;
+}
+
+uint64_t TrajectoryPlayer::getFirstStep() const {
+  return index.empty() ? 0 : index.front().firstStep;
+}
+
+uint64_t TrajectoryPlayer::getLastStep() const {
+  return index.empty() ? 0 : index.back().lastStep;
+}
+
+//--------------------------------------------------------------
+bool TrajectoryPlayer::readIndexFromFooter() {
+  const uint64_t size = file.size();
+  if (size < sizeof(TrajectoryHeader) + sizeof(TrajectoryFooter)) return false;
+
+  TrajectoryFooter footer;
+  std::memcpy(&footer, file.data() + size - sizeof(footer), sizeof(footer));
+  if (std::memcmp(footer.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0) return false;
+
+  const uint64_t indexBytes = footer.chunkCount * sizeof(TrajectoryIndexEntry);
+  if (footer.chunkCount > size || footer.indexOffset + indexBytes != size - sizeof(footer)) return false;
+
+  index.resize((size_t)footer.chunkCount);
+  if (indexBytes > 0) {
+    std::memcpy(index.data(), file.data() + footer.indexOffset, (size_t)indexBytes);
+  }
+
+  // Semua chunk harus ada di dalam file
+  for (const TrajectoryIndexEntry& e : index) {
+    if (e.offset + sizeof(TrajectoryChunkHeader) > footer.indexOffset) {
+      index.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+void TrajectoryPlayer::rebuildIndexByScan() {
+  index.clear();
+  const uint64_t size = file.size();
+  const uint64_t chunkSize = header.chunkSize;
+
+  uint64_t offset = sizeof(TrajectoryHeader);
+  while (offset + sizeof(TrajectoryChunkHeader) <= size) {
+    TrajectoryChunkHeader ch;
+    std::memcpy(&ch, file.data() + offset, sizeof(ch));
+    if (ch.magic != CHUNK_MAGIC || ch.stepCount == 0) break;
+
+    uint64_t total = (sizeof(ch) + ch.payloadBytes + chunkSize - 1) / chunkSize * chunkSize;
+    if (offset + sizeof(ch) + ch.payloadBytes > size) break;  // Chunk terpotong
+
+    TrajectoryIndexEntry e;
+    std::memset(&e, 0, sizeof(e));
+    e.firstStep = ch.firstStep;
+    e.offset = offset;
+    e.stepCount = ch.stepCount;
+    e.lastStep = ch.firstStep;  // Tidak diketahui tanpa decode, cukup untuk seek
+    index.push_back(e);
+
+    offset += total;
+  }
+
+  // lastStep chunk = sebelum chunk berikutnya mulai
+  for (size_t i = 0; i + 1 < index.size(); i++) {
+    index[i].lastStep = std::max(index[i].firstStep, index[i + 1].firstStep - 1);
+  }
+}
+
+//--------------------------------------------------------------
+bool TrajectoryPlayer::enterChunk(size_t chunk) {
+  if (chunk >= index.size()) return false;
+
+  const uint8_t* base = file.data() + index[chunk].offset;
+  TrajectoryChunkHeader ch;
+  std::memcpy(&ch, base, sizeof(ch));
+  if (ch.magic != CHUNK_MAGIC ||
+      index[chunk].offset + sizeof(ch) + ch.payloadBytes > file.size()) {
+    return false;
+  }
+
+  chunkIndex = chunk;
+  cursor = base + sizeof(ch);
+  chunkEnd = cursor + ch.payloadBytes;
+  stepsLeft = ch.stepCount;
+  atKeyframe = true;
+  currentStep = ch.firstStep;
+  return true;
+}
+
+bool TrajectoryPlayer::decodeStep() {
+  const float invScale = 1.0f / header.quantScale;
+  const uint8_t* p = cursor;
+  uint64_t value;
+
+  if (!(p = varint::decode(p, chunkEnd, value))) return false;
+  const uint64_t step = atKeyframe ? currentStep : currentStep + value;
+
+  for (uint32_t t = 0; t < header.trackCount; t++) {
+    if (!(p = varint::decode(p, chunkEnd, value))) return false;
+
+    // Minimal 2 byte per kendaraan, tolak jumlah yang tidak masuk akal
+    const size_t n = (size_t)value;
+    if (n > (size_t)(chunkEnd - p) / 2) return false;
+
+    // Run id kendaraan (naik terus, total harus = n)
+    std::swap(prevIds[t], ids[t]);
+    ids[t].resize(n);
+    uint32_t* id = ids[t].data();
+    uint64_t runs;
+    if (!(p = varint::decode(p, chunkEnd, runs)) || runs > n) return false;
+    size_t filled = 0;
+    uint64_t runEnd = 0;
+    for (uint64_t r = 0; r < runs; r++) {
+      uint64_t gap, length;
+      if (!(p = varint::decode(p, chunkEnd, gap))) return false;
+      if (!(p = varint::decode(p, chunkEnd, length))) return false;
+      if (length == 0 || length > n - filled || runEnd + gap + length > UINT32_MAX) return false;
+      for (uint64_t k = 0; k < length; k++) id[filled++] = (uint32_t)(runEnd + gap + k);
+      runEnd += gap + length;
+    }
+    if (filled != n) return false;
+
+    const bool absolute = atKeyframe || prevIds[t] != ids[t];
+    qDist[t].resize(n);
+    qVel[t].resize(n);
+    dist[t].resize(n);
+    vel[t].resize(n);
+
+    int64_t* qd = qDist[t].data();
+    int64_t* qv = qVel[t].data();
+    for (size_t i = 0; i < n; i++) {
+      uint64_t dv, dd;
+      if (!(p = varint::decode(p, chunkEnd, dv))) return false;
+      if (!(p = varint::decode(p, chunkEnd, dd))) return false;
+
+      // Velocity dulu: distance diprediksi dari distance lama + velocity baru
+      qv[i] = (absolute ? 0 : qv[i]) + varint::unzigzag(dv);
+      qd[i] = (absolute ? 0 : qd[i] + qv[i]) + varint::unzigzag(dd);
+    }
+
+    // Lane: absolut, atau perubahan dari step sebelumnya
+    lanes[t].resize(n);
+    uint8_t* lane = lanes[t].data();
+    if (absolute) {
+      for (size_t i = 0; i < n; i++) {
+        if (!(p = varint::decode(p, chunkEnd, value)) || value > UINT8_MAX) return false;
+        lane[i] = (uint8_t)value;
+      }
+    } else {
+      uint64_t changes;
+      if (!(p = varint::decode(p, chunkEnd, changes)) || changes > n) return false;
+      size_t next = 0;
+      for (uint64_t c = 0; c < changes; c++) {
+        uint64_t gap, l;
+        if (!(p = varint::decode(p, chunkEnd, gap))) return false;
+        if (!(p = varint::decode(p, chunkEnd, l)) || gap >= n - next || l > UINT8_MAX) return false;
+        next += (size_t)gap;
+        lane[next++] = (uint8_t)l;
+      }
+    }
+
+    // Dequantize terpisah (loop kontigu, bisa di-vectorize)
+    float* d = dist[t].data();
+    float* v = vel[t].data();
+    for (size_t i = 0; i < n; i++) {
+      d[i] = (float)qd[i] * invScale;
+      v[i] = (float)qv[i] * invScale;
+    }
+  }
+
+  cursor = p;
+  stepsLeft--;
+  atKeyframe = false;
+  currentStep = step;
+  return true;
+}
+
+bool TrajectoryPlayer::next() {
+  if (!isOpen()) return false;
+
+  if (stepsLeft == 0) {
+    if (!enterChunk(chunkIndex + 1)) return false;
+  }
+  return decodeStep();
+}
+
+bool TrajectoryPlayer::seek(uint64_t step) {
+  if (!isOpen()) return false;
+
+  // Chunk terakhir dengan firstStep <= step
+  auto it = std::upper_bound(index.begin(), index.end(), step,
+                             [](uint64_t s, const TrajectoryIndexEntry& e) { return s < e.firstStep; });
+  size_t chunk = (it == index.begin()) ? 0 : (size_t)(it - index.begin()) - 1;
+
+  if (!enterChunk(chunk) || !decodeStep()) return false;
+
+  // Decode maju di dalam chunk sampai step target
+  while (stepsLeft > 0 && currentStep < step) {
+    const uint8_t* savedCursor = cursor;
+    uint64_t delta;
+    if (!varint::decode(savedCursor, chunkEnd, delta) || currentStep + delta > step) break;
+    if (!decodeStep()) return false;
+  }
+  return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "MappedFile.h"
+#include "TrajectoryFormat.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * TrajectoryPlayer - Baca rekaman .tjt step demi step (replay)
+ *
+ * File di-map (MappedFile), jadi next() hanya decode varint dari memori.
+ * seek() memakai index chunk (binary search firstStep), lalu decode maju
+ * dari awal chunk tersebut karena tiap chunk diawali keyframe.
+ *
+ * Setelah next()/seek() berhasil, getDistances()/getVelocities()/getIds()/
+ * getLanes() berisi state semua kendaraan di getCurrentStep().
+ */
+class TrajectoryPlayer {
+public:
+  bool open(const std::string& path);
+  void close();
+  bool isOpen() const { return file.isOpen(); }
+
+  int getTrackCount() const { return (int)dist.size(); }
+  size_t getChunkCount() const { return index.size(); }
+  uint64_t getFirstStep() const;
+  uint64_t getLastStep() const;
+  uint64_t getCurrentStep() const { return currentStep; }
+
+  // Decode step berikutnya. false kalau rekaman sudah habis
+  bool next();
+
+  // Posisikan di step terakhir yang <= step (clamp ke awal rekaman)
+  bool seek(uint64_t step);
+
+  // Kembali ke step pertama rekaman
+  bool rewind() { return seek(getFirstStep()); }
+
+  int getVehicleCount(int track) const { return (int)dist[track].size(); }
+  const float* getDistances(int track) const { return dist[track].data(); }
+  const float* getVelocities(int track) const { return vel[track].data(); }
+  const uint32_t* getIds(int track) const { return ids[track].data(); }  // Naik, lihat Vehicle::getRecordId()
+  const uint8_t* getLanes(int track) const { return lanes[track].data(); }
+
+private:
+  MappedFile file;
+  trajectory::TrajectoryHeader header;
+  std::vector<trajectory::TrajectoryIndexEntry> index;
+
+  // Posisi decode
+  size_t chunkIndex = 0;
+  const uint8_t* cursor = nullptr;
+  const uint8_t* chunkEnd = nullptr;
+  uint32_t stepsLeft = 0;
+  bool atKeyframe = false;
+  uint64_t currentStep = 0;
+
+  // State terkuantisasi (basis delta) + hasil float per track
+  std::vector<std::vector<int64_t>> qDist, qVel;
+  std::vector<std::vector<float>> dist, vel;
+  std::vector<std::vector<uint32_t>> ids, prevIds;
+  std::vector<std::vector<uint8_t>> lanes;
+
+  bool readIndexFromFooter();
+  void rebuildIndexByScan();
+  bool enterChunk(size_t chunk);
+  bool decodeStep();
+};
@@ -0,0 +1,307 @@
+#include "TrajectoryRecorder.h"
+#include "Varint.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace trajectory;
+
+namespace {
+
+inline int64_t quantize(float value) {
+  return (int64_t)std::llround((double)value * QUANT_SCALE);
+}
+
+} // namespace
+
+TrajectoryRecorder::TrajectoryRecorder()
+    : filledFrames(MAX_FRAMES_IN_FLIGHT), freeFrames(MAX_FRAMES_IN_FLIGHT),
+      recording(false), running(false), recordedSteps(0), droppedSteps(0),
+      bytesWritten(0), file(nullptr), trackCount(0), chunkSize(DEFAULT_CHUNK_SIZE),
+      fileOffset(0), chunkUsed(0), chunkSteps(0), chunkFirstStep(0), lastStep(0) {}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+  stop();
+}
+
+bool TrajectoryRecorder::start(const std::string& path, int trackCount, uint32_t chunkSize) {
+  stop();
+
+  file = std::fopen(path.c_str(), "wb");
+  if (!file) return false;
+
+  this->trackCount = trackCount;
+  this->chunkSize = std::max<uint32_t>(4096, (chunkSize + 4095) & ~4095u);
+
+  TrajectoryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.endianTag = ENDIAN_TAG;
+  header.headerSize = sizeof(TrajectoryHeader);
+  header.chunkSize = this->chunkSize;
+  header.trackCount = (uint32_t)trackCount;
+  header.quantScale = QUANT_SCALE;
+
+  fileOffset = 0;
+  bytesWritten = 0;
+  writeBytes(&header, sizeof(header));
+
+  chunk.assign(this->chunkSize, 0);
+  chunkUsed = sizeof(TrajectoryChunkHeader);
+  chunkSteps = 0;
+  prevDist.assign(trackCount, {});
+  prevVel.assign(trackCount, {});
+  curDist.assign(trackCount, {});
+  curVel.assign(trackCount, {});
+  prevId.assign(trackCount, {});
+  curId.assign(trackCount, {});
+  prevLane.assign(trackCount, {});
+  curLane.assign(trackCount, {});
+  index.clear();
+
+  recordedSteps = 0;
+  droppedSteps = 0;
+  recording = true;
+  running = true;
+  writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+  return true;
+}
+
+void TrajectoryRecorder::stop() {
+  if (!recording) return;
+
+  // Writer thread menghabiskan antrian dulu sebelum keluar
+  running.store(false, std::memory_order_release);
+  if (writer.joinable()) writer.join();
+
+  // Frame yang tersisa kembali ke pool untuk rekaman berikutnya
+  TrajectoryFrame* frame;
+  while (filledFrames.pop(frame)) freeFrames.push(frame);
+
+  recording = false;
+}
+
+TrajectoryFrame* TrajectoryRecorder::acquireFrame(uint64_t step) {
+  if (!recording) return nullptr;
+
+  TrajectoryFrame* frame = nullptr;
+  if (!freeFrames.pop(frame)) {
+    // Pool masih bisa tumbuh (hanya di awal rekaman)
+    if ((int)framePool.size() < MAX_FRAMES_IN_FLIGHT) {
+      framePool.push_back(std::make_unique<TrajectoryFrame>());
+      frame = framePool.back().get();
+    } else {
+      droppedSteps.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+  }
+
+  frame->reset(step);
+  return frame;
+}
+
+void TrajectoryRecorder::submitFrame(TrajectoryFrame* frame) {
+  if (!frame) return;
+
+  // Kapasitas antrian = ukuran pool, jadi push tidak pernah gagal
+  if (!filledFrames.push(frame)) {
+    freeFrames.push(frame);
+    droppedSteps.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+//--------------------------------------------------------------
+void TrajectoryRecorder::writerLoop() {
+  for (;;) {
+    TrajectoryFrame* frame;
+    if (filledFrames.pop(frame)) {
+      encodeFrame(*frame);
+      freeFrames.push(frame);
+      recordedSteps.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    // Producer sudah berhenti push sebelum running = false, jadi kalau
+    // antrian kosong setelah itu, semua frame sudah di-encode
+    if (!running.load(std::memory_order_acquire) && filledFrames.empty()) break;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  flushChunk();
+
+  // Index chunk + footer di akhir file
+  TrajectoryFooter footer;
+  std::memset(&footer, 0, sizeof(footer));
+  footer.indexOffset = fileOffset;
+  footer.chunkCount = index.size();
+  footer.totalSteps = recordedSteps.load(std::memory_order_relaxed);
+  std::memcpy(footer.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+
+  if (!index.empty()) {
+    writeBytes(index.data(), index.size() * sizeof(TrajectoryIndexEntry));
+  }
+  writeBytes(&footer, sizeof(footer));
+
+  std::fclose(file);
+  file = nullptr;
+}
+
+void TrajectoryRecorder::encodeFrame(const TrajectoryFrame& frame) {
+  // 1. Kuantisasi sekali ke buffer "cur" per track
+  size_t offset = 0;
+  for (int t = 0; t < trackCount; t++) {
+    uint32_t n = (t < (int)frame.trackCounts.size()) ? frame.trackCounts[t] : 0;
+    curDist[t].resize(n);
+    curVel[t].resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+      curDist[t][i] = quantize(frame.distance[offset + i]);
+      curVel[t][i] = quantize(frame.velocity[offset + i]);
+    }
+    curId[t].assign(frame.id.begin() + offset, frame.id.begin() + offset + n);
+    curLane[t].assign(frame.lane.begin() + offset, frame.lane.begin() + offset + n);
+    offset += n;
+  }
+
+  // 2. Encode relatif ke step sebelumnya; kalau tidak muat di chunk ini,
+  //    tutup chunk dan encode ulang sebagai keyframe di chunk baru
+  bool keyframe = (chunkSteps == 0);
+  size_t bytes = encodeStep(keyframe ? 0 : frame.step - lastStep, keyframe);
+
+  if (!keyframe && chunkUsed + bytes > chunkSize) {
+    flushChunk();
+    keyframe = true;
+    bytes = encodeStep(0, true);
+  }
+
+  if (keyframe) {
+    chunkFirstStep = frame.step;
+  }
+
+  // Satu step lebih besar dari chunkSize → chunk ini jadi beberapa chunkSize
+  if (chunkUsed + bytes > chunk.size()) {
+    chunk.resize(chunkUsed + bytes);
+  }
+  std::memcpy(chunk.data() + chunkUsed, scratch.data(), bytes);
+  chunkUsed += bytes;
+  chunkSteps++;
+  lastStep = frame.step;
+
+  // 3. cur jadi basis delta step berikutnya
+  std::swap(prevDist, curDist);
+  std::swap(prevVel, curVel);
+  std::swap(prevId, curId);
+  std::swap(prevLane, curLane);
+}
+
+size_t TrajectoryRecorder::encodeStep(uint64_t stepDelta, bool keyframe) {
+  size_t vehicles = 0;
+  for (int t = 0; t < trackCount; t++) vehicles += curDist[t].size();
+
+  // Batas atas: semua varint 10 byte (run id + perubahan lane paling banyak 2 per kendaraan)
+  scratch.resize(varint::MAX_BYTES * (1 + 3 * trackCount + 6 * vehicles));
+  uint8_t* out = scratch.data();
+
+  out += varint::encode(stepDelta, out);
+
+  for (int t = 0; t < trackCount; t++) {
+    const size_t n = curDist[t].size();
+    out += varint::encode(n, out);
+
+    const int64_t* d = curDist[t].data();
+    const int64_t* v = curVel[t].data();
+    const uint32_t* id = curId[t].data();
+    const uint8_t* lane = curLane[t].data();
+
+    // Id sebagai run berurutan (tanpa black hole = satu run)
+    size_t runs = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (i == 0 || id[i] != id[i - 1] + 1) runs++;
+    }
+    out += varint::encode(runs, out);
+    uint32_t runEnd = 0;
+    for (size_t i = 0; i < n;) {
+      size_t j = i + 1;
+      while (j < n && id[j] == id[j - 1] + 1) j++;
+      out += varint::encode(id[i] - runEnd, out);
+      out += varint::encode(j - i, out);
+      runEnd = id[j - 1] + 1;
+      i = j;
+    }
+
+    // Kendaraan berubah (mis. black hole) → nilai absolut
+    const bool absolute = keyframe || prevId[t] != curId[t];
+    if (absolute) {
+      for (size_t i = 0; i < n; i++) {
+        out += varint::encode(varint::zigzag(v[i]), out);
+        out += varint::encode(varint::zigzag(d[i]), out);
+      }
+    } else {
+      const int64_t* pd = prevDist[t].data();
+      const int64_t* pv = prevVel[t].data();
+      for (size_t i = 0; i < n; i++) {
+        out += varint::encode(varint::zigzag(v[i] - pv[i]), out);
+        out += varint::encode(varint::zigzag(d[i] - (pd[i] + v[i])), out);
+      }
+    }
+
+    // Lane: absolut, atau hanya kendaraan yang pindah lajur
+    if (absolute) {
+      for (size_t i = 0; i < n; i++) out += varint::encode(lane[i], out);
+    } else {
+      const uint8_t* pl = prevLane[t].data();
+      size_t changes = 0;
+      for (size_t i = 0; i < n; i++) changes += (lane[i] != pl[i]);
+      out += varint::encode(changes, out);
+      size_t next = 0;
+      for (size_t i = 0; i < n; i++) {
+        if (lane[i] == pl[i]) continue;
+        out += varint::encode(i - next, out);
+        out += varint::encode(lane[i], out);
+        next = i + 1;
+      }
+    }
+  }
+
+  return (size_t)(out - scratch.data());
+}
+
+void TrajectoryRecorder::flushChunk() {
+  if (chunkSteps == 0) return;
+
+  TrajectoryChunkHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic = CHUNK_MAGIC;
+  header.payloadBytes = (uint32_t)(chunkUsed - sizeof(TrajectoryChunkHeader));
+  header.stepCount = chunkSteps;
+  header.firstStep = chunkFirstStep;
+  std::memcpy(chunk.data(), &header, sizeof(header));
+
+  // Pad nol sampai kelipatan chunkSize
+  size_t total = (chunkUsed + chunkSize - 1) / chunkSize * chunkSize;
+  if (chunk.size() < total) chunk.resize(total);
+  std::memset(chunk.data() + chunkUsed, 0, total - chunkUsed);
+
+  TrajectoryIndexEntry entry;
+  std::memset(&entry, 0, sizeof(entry));
+  entry.firstStep = chunkFirstStep;
+  entry.offset = fileOffset;
+  entry.stepCount = chunkSteps;
+  entry.lastStep = lastStep;
+  index.push_back(entry);
+
+  writeBytes(chunk.data(), total);
+
+  // Chunk raksasa (satu step > chunkSize) tidak perlu dipertahankan
+  chunk.resize(chunkSize);
+  chunkUsed = sizeof(TrajectoryChunkHeader);
+  chunkSteps = 0;
+}
+
+void TrajectoryRecorder::writeBytes(const void* data, size_t size) {
+  size_t written = std::fwrite(data, 1, size, file);
+  fileOffset += written;
+  bytesWritten.fetch_add(written, std::memory_order_relaxed);
+}
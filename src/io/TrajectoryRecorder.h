@@ -0,0 +1,132 @@
+#pragma once
+#include "../util/SpscQueue.h"
+#include "TrajectoryFormat.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * TrajectoryFrame - Salinan distance, velocity, id & lane semua track untuk satu step
+ *
+ * Diisi di main thread (murah: hanya push_back float), di-encode di
+ * writer thread. Frame di-pool dan dipakai ulang, jadi setelah beberapa
+ * frame pertama tidak ada alokasi lagi.
+ */
+struct TrajectoryFrame {
+  uint64_t step = 0;
+  std::vector<uint32_t> trackCounts;  // Jumlah kendaraan per track
+  std::vector<float> distance;        // Semua track berurutan
+  std::vector<float> velocity;
+  std::vector<uint32_t> id;           // Vehicle::getRecordId(), naik per track
+  std::vector<uint8_t> lane;
+
+  void reset(uint64_t s) {
+    step = s;
+    trackCounts.clear();
+    distance.clear();
+    velocity.clear();
+    id.clear();
+    lane.clear();
+  }
+
+  void beginTrack() { trackCounts.push_back(0); }
+
+  void add(float d, float v, uint32_t vehicleId, int vehicleLane) {
+    distance.push_back(d);
+    velocity.push_back(v);
+    id.push_back(vehicleId);
+    lane.push_back((uint8_t)vehicleLane);
+    trackCounts.back()++;
+  }
+};
+
+/**
+ * TrajectoryRecorder - Rekam distance, velocity, id & lane per step ke file .tjt
+ *
+ * Alur (lihat TrajectoryFormat.h untuk layout file):
+ * 1. Main thread: acquireFrame() → isi → submitFrame()
+ * 2. Frame lewat SpscQueue (lock-free) ke writer thread
+ * 3. Writer thread: kuantisasi + delta + varint ke buffer chunk,
+ *    tulis chunk penuh ke disk, kembalikan frame ke pool
+ * 4. stop(): flush chunk terakhir, tulis index chunk + footer
+ *
+ * Main thread TIDAK pernah menunggu disk. Kalau writer tertinggal
+ * sampai semua frame di pool terpakai, step tersebut di-drop (dihitung
+ * di getDroppedSteps()), bukan memblok update().
+ */
+class TrajectoryRecorder {
+public:
+  static const int MAX_FRAMES_IN_FLIGHT = 64;
+
+  TrajectoryRecorder();
+  ~TrajectoryRecorder();
+
+  TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+  TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+  /**
+   * Buka file + mulai writer thread
+   * @param chunkSize Ukuran chunk (bytes), dibulatkan ke kelipatan 4 KiB
+   */
+  bool start(const std::string& path, int trackCount,
+             uint32_t chunkSize = trajectory::DEFAULT_CHUNK_SIZE);
+
+  // Selesaikan semua frame di antrian, tulis index + footer, tutup file
+  void stop();
+
+  bool isRecording() const { return recording; }
+
+  // Main thread: frame kosong untuk step ini (nullptr = writer tertinggal, step di-drop)
+  TrajectoryFrame* acquireFrame(uint64_t step);
+
+  // Main thread: serahkan frame yang sudah diisi ke writer thread
+  void submitFrame(TrajectoryFrame* frame);
+
+  uint64_t getRecordedSteps() const { return recordedSteps.load(std::memory_order_relaxed); }
+  uint64_t getDroppedSteps() const { return droppedSteps.load(std::memory_order_relaxed); }
+  uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+
+private:
+  // ===== Dipakai main thread =====
+  std::vector<std::unique_ptr<TrajectoryFrame>> framePool;  // Pemilik semua frame
+  SpscQueue<TrajectoryFrame*> filledFrames;  // main → writer
+  SpscQueue<TrajectoryFrame*> freeFrames;    // writer → main
+  bool recording;
+
+  std::thread writer;
+  std::atomic<bool> running;
+  std::atomic<uint64_t> recordedSteps;
+  std::atomic<uint64_t> droppedSteps;
+  std::atomic<uint64_t> bytesWritten;
+
+  // ===== Dipakai writer thread saja =====
+  FILE* file;
+  int trackCount;
+  uint32_t chunkSize;
+  uint64_t fileOffset;
+
+  std::vector<uint8_t> chunk;  // Header chunk + payload
+  size_t chunkUsed;            // Bytes terpakai (termasuk header)
+  uint32_t chunkSteps;
+  uint64_t chunkFirstStep;
+  uint64_t lastStep;
+
+  // Nilai terkuantisasi step sebelumnya / sekarang per track (basis delta)
+  std::vector<std::vector<int64_t>> prevDist, prevVel;
+  std::vector<std::vector<int64_t>> curDist, curVel;
+  std::vector<std::vector<uint32_t>> prevId, curId;
+  std::vector<std::vector<uint8_t>> prevLane, curLane;
+  std::vector<uint8_t> scratch;  // Hasil encode satu step
+
+  std::vector<trajectory::TrajectoryIndexEntry> index;
+
+  void writerLoop();
+  void encodeFrame(const TrajectoryFrame& frame);
+  size_t encodeStep(uint64_t stepDelta, bool keyframe);
+  void flushChunk();
+  void writeBytes(const void* data, size_t size);
+};
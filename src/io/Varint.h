@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Varint - Encoding integer variable-length (LEB128) + zigzag
+ *
+ * - 7 bit data per byte, bit ke-8 = "masih ada byte berikutnya"
+ * - zigzag memetakan signed ke unsigned supaya delta kecil negatif
+ *   juga jadi 1 byte: 0 → 0, -1 → 1, 1 → 2, -2 → 3, ...
+ *
+ * Delta per kendaraan antar step biasanya kecil (|dv| <= 1 cell), jadi
+ * kebanyakan nilai muat di 1-2 byte.
+ */
+namespace varint {
+
+const size_t MAX_BYTES = 10;  // uint64 butuh maksimal 10 byte
+
+inline uint64_t zigzag(int64_t v) {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// Tulis v ke out, return jumlah byte (out minimal MAX_BYTES)
+inline size_t encode(uint64_t v, uint8_t* out) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+// Baca varint dari [p, end). Return pointer setelah varint, nullptr kalau rusak
+inline const uint8_t* decode(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    v |= (uint64_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return p;
+  }
+  return nullptr;
+}
+
+} // namespace varint
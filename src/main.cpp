@@ -2,7 +2,19 @@
 #include "ofApp.h"
 
 //========================================================================
-int main( ){
+int main(int argc, char* argv[]){
+
+	// Golden trajectory harness (--golden-record / --golden-check / --golden-bisect):
+	// simulasi tanpa jendela, hasil lewat exit code
+	golden::Options harness = golden::parseArgs(argc, argv);
+	if (harness.mode == golden::Options::DOMAIN_WORKER) {
+		ofApp app;
+		return app.runDomainWorker(harness);
+	}
+	if (harness.mode != golden::Options::NONE) {
+		ofApp app;
+		return app.runGolden(harness);
+	}
 
 	//Use ofGLFWWindowSettings for more options like multi-monitor fullscreen
 	ofGLWindowSettings settings;
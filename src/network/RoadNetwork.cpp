@@ -0,0 +1,354 @@
+#include "RoadNetwork.h"
+#include "../road/SegmentRoad.h"
+#include <algorithm>
+
+RoadNetwork::RoadNetwork()
+    : maxV(5), probSlow(0.1f), stepCount(0), finalized(false) {}
+
+void RoadNetwork::clear() {
+  junctions.clear();
+  edges.clear();
+  outOffsets.clear();
+  outEdges.clear();
+  inOffsets.clear();
+  inEdges.clear();
+  grantedEdge.clear();
+  mergeTurn.clear();
+  cells.clear();
+  vehEdge.clear();
+  vehCell.clear();
+  vehVel.clear();
+  vehNextEdge.clear();
+  vehNewVel.clear();
+  vehColor.clear();
+  stepCount = 0;
+  finalized = false;
+}
+
+int RoadNetwork::addJunction(vec2 posNorm, JunctionRule rule) {
+  junctions.push_back({posNorm, rule});
+  finalized = false;
+  return (int)junctions.size() - 1;
+}
+
+int RoadNetwork::addEdge(int from, int to, std::shared_ptr<Road> geometry,
+                         int numCells, int priority) {
+  Edge e;
+  e.from = from;
+  e.to = to;
+  e.numCells = std::max(1, numCells);
+  e.priority = priority;
+  e.cellOffset = 0;  // Di-set di finalize()
+  e.geometry = geometry;
+  edges.push_back(e);
+  finalized = false;
+  return (int)edges.size() - 1;
+}
+
+void RoadNetwork::finalize() {
+  const int numJunctions = (int)junctions.size();
+  const int numEdges = (int)edges.size();
+
+  // 1. Hitung degree per junction (counting sort → CSR)
+  outOffsets.assign(numJunctions + 1, 0);
+  inOffsets.assign(numJunctions + 1, 0);
+  for (const Edge& e : edges) {
+    outOffsets[e.from + 1]++;
+    inOffsets[e.to + 1]++;
+  }
+  for (int j = 0; j < numJunctions; j++) {
+    outOffsets[j + 1] += outOffsets[j];
+    inOffsets[j + 1] += inOffsets[j];
+  }
+
+  // 2. Isi daftar edge
+  outEdges.assign(numEdges, -1);
+  inEdges.assign(numEdges, -1);
+  std::vector<int> outFill(outOffsets.begin(), outOffsets.end() - 1);
+  std::vector<int> inFill(inOffsets.begin(), inOffsets.end() - 1);
+  for (int i = 0; i < numEdges; i++) {
+    outEdges[outFill[edges[i].from]++] = i;
+    inEdges[inFill[edges[i].to]++] = i;
+  }
+
+  // 3. Urutkan edge masuk per junction berdasarkan prioritas (tertinggi duluan)
+  for (int j = 0; j < numJunctions; j++) {
+    std::stable_sort(inEdges.begin() + inOffsets[j], inEdges.begin() + inOffsets[j + 1],
+                     [this](int a, int b) { return edges[a].priority > edges[b].priority; });
+  }
+
+  // 4. Occupancy flat untuk semua edge
+  int totalCells = 0;
+  for (Edge& e : edges) {
+    e.cellOffset = totalCells;
+    totalCells += e.numCells;
+  }
+  cells.assign(totalCells, -1);
+
+  grantedEdge.assign(numJunctions, -1);
+  mergeTurn.assign(numJunctions, 0);
+
+  // Kendaraan lama tidak valid lagi setelah topologi berubah
+  vehEdge.clear();
+  vehCell.clear();
+  vehVel.clear();
+  vehNextEdge.clear();
+  vehNewVel.clear();
+  vehColor.clear();
+
+  finalized = true;
+}
+
+void RoadNetwork::generateGeometry(ofRectangle bounds) {
+  for (Edge& e : edges) {
+    if (e.geometry) {
+      e.geometry->generatePath(bounds);
+    }
+  }
+}
+
+int RoadNetwork::spawnVehicles(int count, int maxV, float probSlow, uint64_t seed) {
+  if (!finalized || edges.empty()) return 0;
+
+  this->maxV = maxV;
+  this->probSlow = probSlow;
+  rng = CounterRng(seed);
+
+  int spawned = 0;
+  const int maxAttempts = count * 8;
+  for (int attempt = 0; attempt < maxAttempts && spawned < count; attempt++) {
+    int edge = (int)rng.below((uint32_t)edges.size(), CounterRng::STREAM_SPAWN, attempt, 0);
+    int cell = (int)rng.below((uint32_t)edges[edge].numCells, CounterRng::STREAM_SPAWN, attempt, 1);
+
+    int& slot = cells[edges[edge].cellOffset + cell];
+    if (slot != -1) continue;  // Sudah terisi, coba lagi
+
+    int id = (int)vehEdge.size();
+    slot = id;
+    vehEdge.push_back(edge);
+    vehCell.push_back(cell);
+    vehVel.push_back(0);
+    vehNewVel.push_back(0);
+    vehNextEdge.push_back(-1);
+    vehColor.push_back(vec3(rng.uniform(CounterRng::STREAM_SPAWN, attempt, 2),
+                            rng.uniform(CounterRng::STREAM_SPAWN, attempt, 3),
+                            rng.uniform(CounterRng::STREAM_SPAWN, attempt, 4)));
+    vehNextEdge[id] = chooseNextEdge(edge, id);
+    spawned++;
+  }
+  return spawned;
+}
+
+int RoadNetwork::freeCellsAhead(int edge, int fromCell, int limit) const {
+  const Edge& e = edges[edge];
+  const int* edgeCells = cells.data() + e.cellOffset;
+  int end = std::min(e.numCells, fromCell + limit);
+
+  int count = 0;
+  for (int c = fromCell; c < end; c++) {
+    if (edgeCells[c] != -1) break;
+    count++;
+  }
+  return count;
+}
+
+int RoadNetwork::chooseNextEdge(int edge, int vehicle) const {
+  const Edge& e = edges[edge];
+  int begin = outOffsets[e.to];
+  int count = outOffsets[e.to + 1] - begin;
+  if (count == 0) return -1;  // Jalan buntu
+
+  int pick = (int)rng.below((uint32_t)count, CounterRng::STREAM_ROUTE, stepCount, (uint32_t)vehicle);
+
+  // Hindari putar balik (U-turn) kalau masih ada pilihan lain
+  if (count > 1 && edges[outEdges[begin + pick]].to == e.from) {
+    pick = (pick + 1) % count;
+  }
+  return outEdges[begin + pick];
+}
+
+void RoadNetwork::arbitrateJunctions() {
+  const int numJunctions = (int)junctions.size();
+
+  for (int j = 0; j < numJunctions; j++) {
+    grantedEdge[j] = -1;
+
+    int begin = inOffsets[j];
+    int count = inOffsets[j + 1] - begin;
+    if (count == 0 || outOffsets[j + 1] == outOffsets[j]) continue;
+
+    // Mulai dari edge prioritas tertinggi (PRIORITY) atau dari giliran (MERGE)
+    int start = (junctions[j].rule == MERGE) ? mergeTurn[j] % count : 0;
+
+    for (int k = 0; k < count; k++) {
+      int local = (start + k) % count;
+      const Edge& e = edges[inEdges[begin + local]];
+
+      // Ada kendaraan dalam jarak maxV dari ujung edge? → minta lewat
+      int window = std::min(maxV, e.numCells);
+      if (freeCellsAhead(inEdges[begin + local], e.numCells - window, window) < window) {
+        grantedEdge[j] = inEdges[begin + local];
+        if (junctions[j].rule == MERGE) {
+          mergeTurn[j] = local + 1;  // Giliran pindah ke edge berikutnya
+        }
+        break;
+      }
+    }
+  }
+}
+
+int RoadNetwork::computeVelocity(int i) const {
+  const int edge = vehEdge[i];
+  const int cell = vehCell[i];
+  const Edge& e = edges[edge];
+
+  // Rule 1: Accelerate
+  int v = std::min(vehVel[i] + 1, maxV);
+
+  // Rule 2: Brake (cek edge sendiri, lalu edge berikutnya kalau diizinkan junction)
+  int gap = freeCellsAhead(edge, cell + 1, v);
+  bool reachesEnd = (cell + gap == e.numCells - 1);
+  if (reachesEnd && gap < v && grantedEdge[e.to] == edge && vehNextEdge[i] >= 0) {
+    gap += freeCellsAhead(vehNextEdge[i], 0, v - gap);
+  }
+  v = std::min(v, gap);
+
+  // Rule 3: Randomize
+  if (v > 0 && rng.uniform(CounterRng::STREAM_RANDOMIZE, stepCount, (uint32_t)i) < probSlow) {
+    v--;
+  }
+  return v;
+}
+
+void RoadNetwork::step() {
+  if (!finalized) return;
+  const int numVehicles = (int)vehEdge.size();
+
+  // Fase 1: Tentukan edge mana yang boleh lewat di tiap junction
+  arbitrateJunctions();
+
+  // Fase 2: Hitung velocity baru (hanya baca state lama → bisa paralel)
+  for (int i = 0; i < numVehicles; i++) {
+    vehNewVel[i] = computeVelocity(i);
+  }
+
+  // Fase 3: Kosongkan cell lama
+  for (int i = 0; i < numVehicles; i++) {
+    cells[edges[vehEdge[i]].cellOffset + vehCell[i]] = -1;
+  }
+
+  // Fase 4: Rule 4 Move + pindah edge lewat junction
+  for (int i = 0; i < numVehicles; i++) {
+    int v = vehNewVel[i];
+    int newCell = vehCell[i] + v;
+    int edge = vehEdge[i];
+
+    if (newCell >= edges[edge].numCells) {
+      newCell -= edges[edge].numCells;
+      edge = vehNextEdge[i];
+      vehEdge[i] = edge;
+      vehNextEdge[i] = chooseNextEdge(edge, i);
+    }
+
+    vehCell[i] = newCell;
+    vehVel[i] = v;
+    cells[edges[edge].cellOffset + newCell] = i;
+  }
+
+  stepCount++;
+}
+
+void RoadNetwork::draw() {
+  // Edge: garis tipis abu-abu
+  ofSetLineWidth(1);
+  ofSetColor(60, 60, 60);
+  for (const Edge& e : edges) {
+    if (e.geometry) {
+      e.geometry->getPolyline().draw();
+    }
+  }
+
+  // Kendaraan: lingkaran kecil, posisi = cell dipetakan ke panjang geometry
+  ofFill();
+  for (int i = 0; i < (int)vehEdge.size(); i++) {
+    const Edge& e = edges[vehEdge[i]];
+    if (!e.geometry) continue;
+
+    float dist = (vehCell[i] + 0.5f) * (e.geometry->getTotalLength() / e.numCells);
+    vec2 pos = e.geometry->getPointAtDistance(dist);
+
+    vec3 col = vehColor[i];
+    if (vehVel[i] == 0) {
+      ofSetColor(255, 40, 40, 200);  // Macet = merah
+    } else {
+      ofSetColor(col.r * 255, col.g * 255, col.b * 255, 200);
+    }
+    ofDrawCircle(pos.x, pos.y, 2.5f);
+  }
+}
+
+void RoadNetwork::writeRenderData(std::vector<vec2>& lines, std::vector<vec2>& positions,
+                                  std::vector<ofFloatColor>& colors) const {
+  lines.clear();
+  positions.clear();
+  colors.clear();
+
+  for (const Edge& e : edges) {
+    if (!e.geometry) continue;
+    const auto& verts = e.geometry->getPolyline().getVertices();
+    for (size_t k = 1; k < verts.size(); k++) {
+      lines.push_back(vec2(verts[k - 1].x, verts[k - 1].y));
+      lines.push_back(vec2(verts[k].x, verts[k].y));
+    }
+  }
+
+  // Sama seperti draw(): posisi = cell dipetakan ke panjang geometry
+  for (int i = 0; i < (int)vehEdge.size(); i++) {
+    const Edge& e = edges[vehEdge[i]];
+    if (!e.geometry) continue;
+
+    float dist = (vehCell[i] + 0.5f) * (e.geometry->getTotalLength() / e.numCells);
+    positions.push_back(e.geometry->getPointAtDistance(dist));
+
+    vec3 col = vehColor[i];
+    if (vehVel[i] == 0) {
+      colors.push_back(ofFloatColor(1.0f, 40 / 255.0f, 40 / 255.0f, 200 / 255.0f));  // Macet = merah
+    } else {
+      colors.push_back(ofFloatColor(col.r, col.g, col.b, 200 / 255.0f));
+    }
+  }
+}
+
+void RoadNetwork::buildGrid(RoadNetwork& net, int cols, int rows, int cellsPerEdge) {
+  net.clear();
+  cols = std::max(2, cols);
+  rows = std::max(2, rows);
+
+  // Junction di grid dengan margin 5%
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      vec2 pos(0.05f + 0.9f * c / (cols - 1), 0.05f + 0.9f * r / (rows - 1));
+      bool border = (r == 0 || c == 0 || r == rows - 1 || c == cols - 1);
+      net.addJunction(pos, border ? MERGE : PRIORITY);
+    }
+  }
+
+  // Jalan dua arah ke tetangga kanan dan bawah
+  const float laneOffset = 3.0f;
+  auto link = [&](int a, int b, int priority) {
+    vec2 pa = net.junctions[a].posNorm;
+    vec2 pb = net.junctions[b].posNorm;
+    net.addEdge(a, b, std::make_shared<SegmentRoad>(pa, pb, laneOffset), cellsPerEdge, priority);
+    net.addEdge(b, a, std::make_shared<SegmentRoad>(pb, pa, laneOffset), cellsPerEdge, priority);
+  };
+
+  for (int r = 0; r < rows; r++) {
+    for (int c = 0; c < cols; c++) {
+      int id = r * cols + c;
+      if (c + 1 < cols) link(id, id + 1, 1);     // Horizontal = jalan utama
+      if (r + 1 < rows) link(id, id + cols, 0);  // Vertikal = jalan minor
+    }
+  }
+
+  net.finalize();
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include "../road/Road.h"
+#include "../simulation/CounterRng.h"
+#include "ofMain.h"
+#include <memory>
+#include <vector>
+
+/**
+ * RoadNetwork - Jaringan jalan (graph) dengan junction dan merge
+ *
+ * Berbeda dengan TrackInstance (satu ring tertutup), RoadNetwork menyimpan
+ * BANYAK segmen jalan (edge) yang dihubungkan oleh junction (node).
+ * Kendaraan bergerak dari edge ke edge lewat junction.
+ *
+ * Penyimpanan:
+ * - Adjacency dalam format CSR (Compressed Sparse Row):
+ *   outEdges[outOffsets[j] .. outOffsets[j+1]) = edge yang KELUAR dari junction j
+ *   inEdges[inOffsets[j] .. inOffsets[j+1])    = edge yang MASUK ke junction j
+ *   (inEdges diurutkan berdasarkan prioritas, tertinggi duluan)
+ * - Occupancy semua edge dalam SATU array flat (cells), tiap edge punya offset
+ * - Kendaraan disimpan SoA (edge, cell, velocity, nextEdge, color)
+ *
+ * Aturan junction (per junction):
+ * - PRIORITY: edge masuk dengan prioritas tertinggi yang punya kendaraan
+ *   siap masuk yang boleh lewat; edge lain berhenti di garis stop
+ * - MERGE: zipper, giliran berputar di antara edge masuk yang antre
+ *
+ * Geometri tiap edge memakai Road yang sudah ada (misal SegmentRoad).
+ * Model gerak: Nagel-Schreckenberg klasik (velocity integer, cell integer).
+ *
+ * step() TIDAK melakukan alokasi memori: semua buffer dialokasi di
+ * finalize() dan spawnVehicles().
+ */
+class RoadNetwork {
+public:
+  enum JunctionRule {
+    PRIORITY,  // Prioritas tetap berdasarkan edge priority
+    MERGE      // Bergiliran (zipper merge)
+  };
+
+  RoadNetwork();
+
+  // Hapus semua junction, edge, dan kendaraan
+  void clear();
+
+  /**
+   * Tambah junction
+   * @param posNorm Posisi normal (0-1) relatif terhadap bounds
+   * @return Indeks junction
+   */
+  int addJunction(vec2 posNorm, JunctionRule rule = PRIORITY);
+
+  /**
+   * Tambah edge berarah dari junction `from` ke junction `to`
+   * @param geometry Road untuk posisi di layar (dipetakan dari cell)
+   * @param numCells Panjang edge dalam cells
+   * @param priority Prioritas di junction tujuan (lebih besar = didahulukan)
+   * @return Indeks edge
+   */
+  int addEdge(int from, int to, std::shared_ptr<Road> geometry, int numCells, int priority = 0);
+
+  // Bangun CSR + alokasi buffer occupancy. Wajib sebelum spawn/step
+  void finalize();
+
+  // Generate geometri semua edge di dalam bounds
+  void generateGeometry(ofRectangle bounds);
+
+  /**
+   * Spawn kendaraan di cell kosong secara acak (deterministik dari seed)
+   * @return Jumlah kendaraan yang berhasil di-spawn
+   */
+  int spawnVehicles(int count, int maxV, float probSlow, uint64_t seed);
+
+  // Satu langkah simulasi untuk semua kendaraan (allocation-free)
+  void step();
+
+  // Gambar edge + kendaraan
+  void draw();
+
+  /**
+   * Salin data gambar ke buffer (untuk render di thread lain, lihat RenderSnapshot)
+   * @param lines Pasangan titik per segmen polyline edge
+   * @param positions Posisi kendaraan di layar
+   * @param colors Warna kendaraan (merah kalau macet), alpha sudah termasuk
+   */
+  void writeRenderData(std::vector<vec2>& lines, std::vector<vec2>& positions,
+                       std::vector<ofFloatColor>& colors) const;
+
+  int getJunctionCount() const { return (int)junctions.size(); }
+  int getEdgeCount() const { return (int)edges.size(); }
+  int getVehicleCount() const { return (int)vehEdge.size(); }
+  bool isFinalized() const { return finalized; }
+
+  /**
+   * Helper: bangun grid kota (Manhattan) cols x rows junction,
+   * jalan dua arah antar junction tetangga.
+   * Jalan horizontal = jalan utama (prioritas lebih tinggi).
+   * Junction di pinggir memakai aturan MERGE, sisanya PRIORITY.
+   */
+  static void buildGrid(RoadNetwork& net, int cols, int rows, int cellsPerEdge);
+
+private:
+  struct Junction {
+    vec2 posNorm;
+    JunctionRule rule;
+  };
+
+  struct Edge {
+    int from;
+    int to;
+    int numCells;
+    int priority;
+    int cellOffset;  // Offset ke array cells
+    std::shared_ptr<Road> geometry;
+  };
+
+  std::vector<Junction> junctions;
+  std::vector<Edge> edges;
+
+  // ===== CSR adjacency =====
+  std::vector<int> outOffsets;  // size = junctions + 1
+  std::vector<int> outEdges;
+  std::vector<int> inOffsets;   // size = junctions + 1
+  std::vector<int> inEdges;     // urut prioritas (tertinggi duluan)
+
+  // ===== State per junction =====
+  std::vector<int> grantedEdge;  // Edge masuk yang boleh lewat di step ini (-1 = tidak ada)
+  std::vector<int> mergeTurn;    // Giliran berikutnya untuk aturan MERGE (indeks lokal)
+
+  // ===== Occupancy =====
+  std::vector<int> cells;  // cells[edge.cellOffset + c] = indeks kendaraan, -1 = kosong
+
+  // ===== Kendaraan (SoA) =====
+  std::vector<int> vehEdge;
+  std::vector<int> vehCell;
+  std::vector<int> vehVel;
+  std::vector<int> vehNextEdge;  // Edge tujuan setelah junction berikutnya
+  std::vector<int> vehNewVel;    // Buffer velocity baru (update paralel)
+  std::vector<vec3> vehColor;
+
+  int maxV;
+  float probSlow;
+  CounterRng rng;
+  uint64_t stepCount;
+  bool finalized;
+
+  // Fase step()
+  void arbitrateJunctions();
+  int computeVelocity(int vehicle) const;
+
+  // Hitung cell kosong berturut-turut mulai dari fromCell (maksimal limit)
+  int freeCellsAhead(int edge, int fromCell, int limit) const;
+
+  // Pilih edge keluar secara acak dari junction tujuan edge ini
+  int chooseNextEdge(int edge, int vehicle) const;
+};
@@ -1,5 +1,7 @@
 ﻿#include "ofApp.h"
 #include "road/CurvedRoad.h"
+#include <chrono>
+#include <cstring>
 
 //--------------------------------------------------------------
 //--------------------------------------------------------------
@@ -11,56 +13,156 @@ void ofApp::setup() {
   ofEnableAntiAliasing();
   ofEnableSmoothing();
 
+  bezierBatch.setFlatnessTolerance(bezierFlatness);
+  bezierBatch.setVertexBudget(bezierVertexBudget);
+
+  // Satu batch per worker thread (budget vertex tetap global, lihat buildGeometryParallel)
+  workerBatches.resize(workerPool.getWorkerCount());
+  for (BezierBatch &batch : workerBatches) {
+    batch.setFlatnessTolerance(bezierFlatness);
+  }
+
+  loadScenario();
+  setupTracks();
+
+  // Mulai dari sini state simulasi hanya disentuh thread simulasi
+  startSimulationThread();
+}
+
+//--------------------------------------------------------------
+void ofApp::setupTracks() {
   // ==================== MULTIPLE TRACKS SETUP ====================
-  // Kita buat 3 lintasan konsentris (Outer, Middle, Inner)
+  // Satu TrackInstance per track di scenario (default: 3 ring konsentris)
+  tracks.reserve(activeScenario.tracks.size());
+  for (const scenario::TrackConfig &cfg : activeScenario.tracks) {
+    tracks.emplace_back();
+    buildTrack(tracks.back(), cfg);
+  }
+  tracksMatchScenario = true;
+}
 
-  float w = ofGetWidth();
-  float h = ofGetHeight();
-  float cx = w / 2;
-  float cy = h / 2;
-
-  // Track 1: Outer (Besar)
-  // Margin kecil (misal 50)
-  {
-    TrackInstance t;
-    // Bounds: full screen minus margin
-    ofRectangle bounds(50, 50, w - 100, h - 100);
-    // Spawn mobil dengan maxVOuter, spiralMaxVOuter, maxCellsOuter, dll
-    t.setup(bounds, numCarsOuter, 50, maxVOuter, spiralMaxVOuter, probSlowOuter, maxCellsOuter, currentRoadType,
-            numLinesPerCarOuter, curveIntensityOuter, curveAngle1Outer, curveAngle2Outer, directionOuter);
-    t.visible = true;  // Default visible
-    t.drawFromCenter = (ofRandom(1.0f) < 0.5f);  // Random: center→car atau car→center
-    t.gradientMode = false;  // Default: normal mode
-    tracks.push_back(t);
-  }
-
-  // Track 2: Middle (Sedang)
-  // Margin lebih besar (misal 200)
-  {
-    TrackInstance t;
-    ofRectangle bounds(200, 200, w - 400, h - 400);
-    // Spawn mobil dengan maxVMiddle, spiralMaxVMiddle, maxCellsMiddle, dll
-    t.setup(bounds, numCarsMiddle, 50, maxVMiddle, spiralMaxVMiddle, probSlowMiddle, maxCellsMiddle, currentRoadType,
-            numLinesPerCarMiddle, curveIntensityMiddle, curveAngle1Middle, curveAngle2Middle, directionMiddle);
-    t.visible = true;  // Default visible
-    t.drawFromCenter = (ofRandom(1.0f) < 0.5f);  // Random: center→car atau car→center
-    t.gradientMode = false;  // Default: normal mode
-    tracks.push_back(t);
-  }
-
-  // Track 3: Inner (Kecil)
-  // Margin lebih besar lagi (misal 350)
-  {
-    TrackInstance t;
-    ofRectangle bounds(350, 350, w - 700, h - 700);
-    // Spawn mobil dengan maxVInner, spiralMaxVInner, maxCellsInner, dll
-    t.setup(bounds, numCarsInner, 45, maxVInner, spiralMaxVInner, probSlowInner, maxCellsInner, currentRoadType,
-            numLinesPerCarInner, curveIntensityInner, curveAngle1Inner, curveAngle2Inner, directionInner);
-    t.visible = true;  // Default visible
-    t.drawFromCenter = (ofRandom(1.0f) < 0.5f);  // Random: center→car atau car→center
-    t.gradientMode = false;  // Default: normal mode
-    tracks.push_back(t);
+//--------------------------------------------------------------
+void ofApp::buildTrack(TrackInstance &t, const scenario::TrackConfig &cfg) {
+  buildTrack(t, cfg, ofGetWidth(), ofGetHeight());
+}
+
+void ofApp::buildTrack(TrackInstance &t, const scenario::TrackConfig &cfg, float width, float height) {
+  t.fleetMix = cfg.fleetMix;
+  t.physics = cfg.physics;
+  t.caInterval = cfg.caInterval;
+  t.rules = cfg.rules;
+  t.waveSpeed = cfg.waveSpeed;
+  t.ctmCellLength = cfg.ctmCellLength;
+  t.microBegin = cfg.microBegin;
+  t.microLength = cfg.microLength;
+  t.occupancyMode = cfg.occupancy;
+  t.perlin = cfg.perlin;
+  t.setup(cfg.getBounds(width, height), cfg.numCars, cfg.spacing, cfg.maxV, cfg.spiralMaxV,
+          cfg.probSlow, cfg.maxCells, (RoadType)std::min(cfg.roadType, (uint32_t)SPIRAL),
+          cfg.numLinesPerCar, cfg.curveIntensity, cfg.curveAngle1, cfg.curveAngle2, cfg.direction,
+          cfg.numLanes, cfg.laneWidth, cfg.segmentsPerCar, cfg.seed);
+  applyTrackSettings(t, cfg);
+}
+
+//--------------------------------------------------------------
+void ofApp::applyTrackSettings(TrackInstance &t, const scenario::TrackConfig &cfg) {
+  t.numLinesPerCar = cfg.numLinesPerCar;
+  t.curveIntensity = cfg.curveIntensity;
+  t.curveAngle1 = cfg.curveAngle1;
+  t.curveAngle2 = cfg.curveAngle2;
+  t.visible = cfg.visible;
+  // -1: acak center→car atau car→center
+  t.drawFromCenter = (cfg.drawFromCenter < 0) ? (ofRandom(1.0f) < 0.5f) : (cfg.drawFromCenter != 0);
+  t.gradientMode = cfg.gradientMode;
+  t.detectorCell = cfg.detectorCell;
+  t.laneRule = LaneChangeRule(cfg.asymmetricLaneChange ? LaneChangeRule::ASYMMETRIC : LaneChangeRule::SYMMETRIC,
+                              cfg.probLaneChange);
+
+  // Bentuk perlin berubah: generate ulang road saja (distance kendaraan dalam cell, tidak berubah)
+  if (t.perlin != cfg.perlin) {
+    t.perlin = cfg.perlin;
+    if (t.roadType == PERLIN_NOISE) t.regenerateRoad(PERLIN_NOISE);
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::loadScenario() {
+  std::string path = ofToDataPath(scenarioFile);
+  std::string error;
+  if (scenario::loadScenario(path, activeScenario, error)) {
+    ofLogNotice("ofApp") << "Scenario dimuat: " << path << " (" << activeScenario.tracks.size() << " track)";
+  } else {
+    ofLogWarning("ofApp") << "Scenario tidak dipakai (" << error << "), pakai 3 ring bawaan";
+    activeScenario = scenario::builtinScenario();
   }
+
+  // File dipantau walau belum ada: begitu dibuat, langsung dimuat
+  scenarioWatcher.watch(path);
+}
+
+//--------------------------------------------------------------
+bool ofApp::reloadScenario() {
+  // Replay memakai jumlah kendaraan dari rekaman, track tidak boleh diganti
+  if (replayMode) {
+    ofLogWarning("ofApp") << "Scenario berubah saat replay, diabaikan";
+    return false;
+  }
+
+  scenario::Scenario next;
+  std::string error;
+  if (!scenario::loadScenario(scenarioWatcher.getPath(), next, error)) {
+    ofLogError("ofApp") << "Reload scenario gagal, tetap pakai yang lama: " << error;
+    return false;
+  }
+
+  // Setelah load snapshot, tracks bukan dari activeScenario: buat ulang semua
+  const size_t oldCount = tracksMatchScenario ? activeScenario.tracks.size() : 0;
+  if (!tracksMatchScenario) {
+    tracks.clear();
+  }
+
+  int rebuilt = 0;
+  int updated = 0;
+  const size_t keep = std::min(oldCount, next.tracks.size());
+  for (size_t i = 0; i < keep; i++) {
+    const scenario::TrackConfig &before = activeScenario.tracks[i];
+    const scenario::TrackConfig &after = next.tracks[i];
+    if (after == before) continue;  // Track ini tidak disentuh sama sekali
+
+    if (after.sameSimulation(before)) {
+      // Hanya render / lane change: kendaraan & road tetap
+      applyTrackSettings(tracks[i], after);
+      updated++;
+    } else {
+      tracks[i] = TrackInstance();
+      buildTrack(tracks[i], after);
+      rebuilt++;
+    }
+  }
+
+  // Track dihapus dari akhir / ditambah di akhir
+  const bool countChanged = next.tracks.size() != tracks.size();
+  if (tracks.size() > next.tracks.size()) {
+    tracks.erase(tracks.begin() + next.tracks.size(), tracks.end());
+  }
+  for (size_t i = tracks.size(); i < next.tracks.size(); i++) {
+    tracks.emplace_back();
+    buildTrack(tracks.back(), next.tracks[i]);
+    rebuilt++;
+  }
+
+  // Rekaman mengasumsikan kendaraan tiap track tetap: hentikan kalau struktur berubah
+  if ((rebuilt > 0 || countChanged) && recorder.isRecording()) {
+    ofLogWarning("ofApp") << "Track berubah, rekaman dihentikan";
+    stopRecording();
+  }
+
+  activeScenario = std::move(next);
+  tracksMatchScenario = true;
+
+  ofLogNotice("ofApp") << "Scenario dimuat ulang: " << rebuilt << " track dibuat ulang, " << updated
+                       << " diperbarui, " << (tracks.size() - rebuilt - updated) << " tidak berubah";
+  return true;
 }
 
 //--------------------------------------------------------------
@@ -70,13 +172,178 @@ void ofApp::update() {
     return;
   }
 
+  // Region micro track hybrid mengikuti mouse: satu perintah per frame
+  if (focusMoved && commands.push({SimCommand::FOCUS, 0, focusPoint.x, focusPoint.y})) {
+    focusMoved = false;
+  }
+
+  // Satu step simulasi per frame (kecepatan sama seperti sebelum pipelining),
+  // dijalankan thread simulasi SAMBIL frame ini digambar. Kalau simulasi
+  // tertinggal, STEP tidak ditumpuk (antrian tetap longgar untuk tombol)
+  if (stepsInFlight.load(std::memory_order_acquire) < maxStepsInFlight) {
+    stepsInFlight++;
+    if (!commands.push({SimCommand::STEP, 0})) {
+      stepsInFlight--;
+    }
+  }
+}
+
+//--------------------------------------------------------------
+ofApp::~ofApp() {
+  // Jaga-jaga kalau exit() tidak dipanggil: thread simulasi wajib di-join
+  stopSimulationThread();
+}
+
+//--------------------------------------------------------------
+void ofApp::exit() {
+  stopSimulationThread();
+  stopRecording();  // Tulis index + footer sebelum keluar
+  telemetryExporter.stop();
+  stateExporter.stop();
+}
+
+//--------------------------------------------------------------
+void ofApp::startSimulationThread() {
+  if (simRunning) return;
+
+  // Snapshot awal supaya frame pertama sudah punya data
+  publishSnapshot();
+  simRunning = true;
+  simThread = std::thread(&ofApp::simulationLoop, this);
+}
+
+//--------------------------------------------------------------
+void ofApp::stopSimulationThread() {
+  simRunning = false;
+  if (simThread.joinable()) {
+    simThread.join();
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::simulationLoop() {
+  SimCommand cmd;
+  while (simRunning.load(std::memory_order_acquire)) {
+    // Jalankan semua perintah yang antre (urutan tombol & step terjaga)
+    // Hot reload scenario (poll hanya cek waktu modifikasi file, tiap 500 ms)
+    const bool reloaded = scenarioWatcher.poll() && reloadScenario();
+
+    const uint64_t allocsBefore = alloc_counter::threadAllocations();
+    bool changed = reloaded;
+    bool onlySteps = !reloaded;
+    while (commands.pop(cmd)) {
+      // Scratch step sebelumnya tidak dipakai lagi
+      simArena.reset();
+      if (cmd.type == SimCommand::STEP) {
+        simulationStep();
+        stepsInFlight--;
+      } else if (cmd.type == SimCommand::FOCUS) {
+        applyFocus(vec2(cmd.x, cmd.y));
+        onlySteps = false;
+      } else {
+        applyKey(cmd.key);
+        onlySteps = false;
+      }
+      changed = true;
+    }
+
+    if (changed) {
+      publishSnapshot();
+
+      // Tombol boleh alokasi (track baru, file, dll); step biasa tidak
+      uint64_t allocs = alloc_counter::threadAllocations() - allocsBefore;
+      if (simAllocCheck.frame(onlySteps, allocs) && simAllocCheck.shouldReport()) {
+        ofLogWarning("ofApp") << "Step simulasi steady state alokasi heap: " << allocs
+                              << " (pelanggaran ke-" << simAllocCheck.getViolations() << ")";
+      }
+    } else {
+      // Antrian kosong: tunggu STEP dari frame berikutnya
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::simulationStep() {
+  // Network mode: hanya simulasi road network
+  if (networkMode) {
+    network.step();
+    return;
+  }
+
+  // Replay mode: posisi dari file rekaman, tanpa simulasi
+  if (replayMode) {
+    replayStep();
+    return;
+  }
+
+  auto stepStart = std::chrono::steady_clock::now();
   for (auto &track : tracks) {
-    track.update();
+    track.update(simArena, simPool);
+  }
+  simStep++;
+
+  if (telemetryExporter.isRunning()) {
+    for (size_t t = 0; t < tracks.size(); t++) {
+      TrackSample sample = tracks[t].telemetry;
+      sample.step = simStep;
+      sample.track = (uint32_t)t;
+      telemetryExporter.submit(sample);
+    }
+
+    auto stepEnd = std::chrono::steady_clock::now();
+    StepTiming timing;
+    timing.step = simStep;
+    timing.seconds = std::chrono::duration<float>(stepEnd - stepStart).count();
+    timing.time = std::chrono::duration<double>(stepEnd.time_since_epoch()).count();
+    telemetryExporter.submitStep(timing);
   }
+
+  if (recorder.isRecording()) {
+    recordStep();
+  }
+
+  if (stateExporter.isRunning()) {
+    exportState();
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::publishSnapshot() {
+  RenderSnapshot &frame = frames.writeBuffer();
+  frame.step = simStep;
+  frame.networkMode = networkMode;
+  frame.replayMode = replayMode;
+
+  if (networkMode) {
+    network.writeRenderData(frame.networkLines, frame.networkPositions, frame.networkColors);
+  } else {
+    frame.tracks.resize(tracks.size());
+    for (size_t i = 0; i < tracks.size(); i++) {
+      tracks[i].fillSnapshot(frame.tracks[i]);
+    }
+  }
+
+  frames.publish();
 }
 
 //--------------------------------------------------------------
 void ofApp::draw() {
+  const uint64_t allocsBefore = alloc_counter::threadAllocations();
+  drawScene();
+
+  // Frame tanpa input (setelah warm-up) harus bebas alokasi heap
+  uint64_t allocs = alloc_counter::threadAllocations() - allocsBefore;
+  bool steady = simulationStarted && !keyThisFrame;
+  keyThisFrame = false;
+  if (drawAllocCheck.frame(steady, allocs) && drawAllocCheck.shouldReport()) {
+    ofLogWarning("ofApp") << "draw() steady state alokasi heap: " << allocs
+                          << " (pelanggaran ke-" << drawAllocCheck.getViolations() << ")";
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::drawScene() {
   ofSetBackgroundAuto(false);
 
   // Jika simulasi belum mulai, layar tetap hitam
@@ -92,64 +359,227 @@ void ofApp::draw() {
   ofFill();
   ofDrawRectangle(0, 0, ofGetWidth(), ofGetHeight());
 
+  // Snapshot terbaru dari thread simulasi (tanpa lock). Kalau belum ada
+  // step baru, snapshot sebelumnya digambar lagi
+  frames.acquire();
+  const RenderSnapshot &frame = frames.readBuffer();
+
+  // Network mode: gambar road network saja
+  if (frame.networkMode) {
+    drawNetworkSnapshot(frame);
+    return;
+  }
+
   // Hitung wobble time untuk bezier curves
   float wobbleTime = ofGetElapsedTimef() * .5f;  // Kecepatan wobble
 
+  // Semua garis bezier frame ini dibangun paralel (tiap worker ke batch
+  // sendiri), lalu digabung ke bezierBatch
+  buildGeometryParallel(frame, wobbleTime);
+
   if (tabMode) {
-    // TAB MODE: Draw inter-track bezier melalui 3 tracks (outer→middle→inner)
-    drawInterTrackBezier(wobbleTime);
+    // TAB MODE: mobil semua track rantai (bezier antar track sudah di batch)
+    drawInterTrackCars(frame);
   } else {
     // NORMAL MODE: Draw setiap track secara independen
-    for (auto &track : tracks) {
-      // Hanya draw jika visible
-      if (track.visible) {
-        track.draw(&ofApp::getBezierPoint, wobbleTime, track.gradientMode);
+    for (const auto &track : frame.tracks) {
+      // Hanya draw jika visible; gradient mode menyembunyikan mobil
+      if (track.visible && !track.gradientMode) {
+        drawTrackVehicles(track);
       }
     }
   }
+
+  // Track physics macro: density road di kedua mode
+  for (const auto &track : frame.tracks) {
+    if (track.visible && !track.density.empty()) {
+      drawTrackDensity(track);
+    }
+  }
+
+  // Satu upload + draw call untuk semua garis
+  bezierBatch.draw();
+}
+
+//--------------------------------------------------------------
+void ofApp::buildGeometryParallel(const RenderSnapshot &frame, float wobbleTime) {
+  // Pekerjaan = indeks global. Normal mode: mobil semua track visible
+  // berurutan. TAB mode: rantai antar track visible, lalu inner loop
+  int chainCount = 0;
+  int loopCount = 0;
+  int total = 0;
+  if (tabMode) {
+    getInterTrackCounts(frame, chainCount, loopCount);
+    total = chainCount + loopCount;
+  } else {
+    for (const auto &track : frame.tracks) {
+      if (track.visible) total += track.size();
+    }
+  }
+
+  for (BezierBatch &batch : workerBatches) {
+    batch.begin();
+  }
+
+  // Tahap 1 (paralel): kurva + segmen adaptif. Worker hanya MEMBACA snapshot
+  // dan menulis ke batch miliknya sendiri, jadi tidak ada lock.
+  // Partisi statis → hasil gather() sama urutannya dengan loop serial
+  workerSegments.assign(workerBatches.size(), 0);
+  workerPool.parallelFor(total, geometryMinChunk, [&](int worker, int begin, int end) {
+    BezierBatch &batch = workerBatches[worker];
+
+    if (tabMode) {
+      buildInterTrackGeometry(batch, frame, begin, end, chainCount, wobbleTime);
+    } else {
+      // Petakan range global ke range per track
+      int offset = 0;
+      for (const auto &track : frame.tracks) {
+        if (!track.visible) continue;
+        int n = track.size();
+        int b = std::max(begin - offset, 0);
+        int e = std::min(end - offset, n);
+        if (b < e) {
+          buildTrackGeometry(batch, track, b, e, wobbleTime);
+        }
+        offset += n;
+      }
+    }
+
+    workerSegments[worker] = batch.measure();
+  });
+
+  // Budget vertex berlaku untuk SEMUA kurva frame ini (bukan per worker)
+  int requestedSegments = 0;
+  int curveCount = 0;
+  for (size_t w = 0; w < workerBatches.size(); w++) {
+    requestedSegments += workerSegments[w];
+    curveCount += workerBatches[w].getCurveCount();
+  }
+  float scale = BezierBatch::budgetScaleFor(bezierVertexBudget, requestedSegments, curveCount);
+
+  // Tahap 2 (paralel): tessellate ke buffer masing-masing worker
+  workerPool.parallelFor((int)workerBatches.size(), 1, [&](int worker, int begin, int end) {
+    for (int w = begin; w < end; w++) {
+      workerBatches[w].build(scale);
+    }
+  });
+
+  // Main thread: salin berurutan ke satu buffer untuk upload
+  bezierBatch.gather(workerBatches);
+}
+
+//--------------------------------------------------------------
+void ofApp::drawNetworkSnapshot(const RenderSnapshot &frame) {
+  // Edge: garis tipis abu-abu
+  ofSetLineWidth(1);
+  ofSetColor(60, 60, 60);
+  const std::vector<vec2> &lines = frame.networkLines;
+  for (size_t k = 0; k + 1 < lines.size(); k += 2) {
+    ofDrawLine(lines[k].x, lines[k].y, lines[k + 1].x, lines[k + 1].y);
+  }
+
+  // Kendaraan: lingkaran kecil (warna macet sudah di snapshot)
+  ofFill();
+  for (size_t i = 0; i < frame.networkPositions.size(); i++) {
+    const ofFloatColor &c = frame.networkColors[i];
+    ofSetColor(c.r * 255, c.g * 255, c.b * 255, c.a * 255);
+    ofDrawCircle(frame.networkPositions[i].x, frame.networkPositions[i].y, 2.5f);
+  }
 }
 
 // ==================== TRACK INSTANCE IMPLEMENTATION ====================
 
 void ofApp::TrackInstance::setup(ofRectangle bounds, int numCars, int spacing,
                                  float maxV, float spiralMaxV, float probSlow, int maxCells, RoadType roadType,
-                                 int numLinesPerCar, float curveIntensity, float curveAngle1, float curveAngle2, int direction) {
+                                 int numLinesPerCar, float curveIntensity, float curveAngle1, float curveAngle2, int direction,
+                                 int numLanes, float laneWidth, int segmentsPerCar, uint64_t seed) {
   this->bounds = bounds;
   this->roadType = roadType;          // Simpan roadType untuk cek SpiralRoad
   this->maxCells = maxCells;
   this->maxV = maxV;                  // Simpan maxV untuk normal mode
   this->spiralMaxV = spiralMaxV;      // Simpan maxV khusus SpiralRoad
+  this->probSlow = probSlow;          // Simpan probSlow untuk restore snapshot
   this->numLinesPerCar = numLinesPerCar;  // Simpan numLinesPerCar untuk track ini
   this->curveIntensity = curveIntensity;  // Simpan curveIntensity untuk track ini
   this->curveAngle1 = curveAngle1;        // Simpan curveAngle1 untuk track ini
   this->curveAngle2 = curveAngle2;        // Simpan curveAngle2 untuk track ini
   this->direction = direction;            // Simpan direction untuk track ini
+  this->numLanes = std::max(1, numLanes); // Jumlah lajur
+  this->laneWidth = laneWidth;            // Jarak antar lajur
+  // Seed 0 = acak tiap run. Seed lain: spawn + semua keputusan random
+  // berasal dari CounterRng, jadi simulasi bisa diulang persis
+  if (seed == 0) {
+    seed = (uint64_t)(ofRandom(1.0f) * 4294967295.0) << 32 | (uint64_t)(ofRandom(1.0f) * 4294967295.0);
+  }
+  this->rng = CounterRng(seed);
+  this->stepCount = 0;
+  this->caPhase = 0;
+  this->caSynced = false;
 
   // 1. Road - buat berdasarkan roadType
   regenerateRoad(roadType);
 
-  // 2. Grid
-  grid.resize(maxCells);
+  // Physics macro: density per cell CTM, tanpa grid / kendaraan
+  if (physics == scenario::PHYSICS_MACRO) {
+    grid.clear();
+    bodies.reset(segmentsPerCar);
+    setupMacro(numCars, spacing);
+    return;
+  }
+
+  // 2. Grid (satu slice per lajur). Road sangat panjang: SparseOccupancy,
+  //    memori per kendaraan. Physics integer tidak memakai keduanya
+  sparseOccupancy = (physics != scenario::PHYSICS_INTEGER) &&
+                    (occupancyMode == scenario::OCCUPANCY_SPARSE ||
+                     (occupancyMode == scenario::OCCUPANCY_AUTO &&
+                      (int64_t)this->numLanes * maxCells >= SparseOccupancy::AUTO_MIN_CELLS));
+  if (sparseOccupancy || physics == scenario::PHYSICS_INTEGER) {
+    grid.clear();
+    grid.shrink_to_fit();
+    occupancy.reset(this->numLanes, maxCells);
+  } else {
+    grid.resize(this->numLanes * maxCells);
+  }
+
+  // 3. Traffic (numCars per lajur, lajur berikutnya digeser setengah spacing)
+  //    Jenis & distance dari SpawnSequence (sama dengan proses RingDomain)
+  bodies.reset(segmentsPerCar);
 
-  // 3. Traffic
-  for (int i = 0; i < numCars; i++) {
-    float startDist = i * spacing;
+  for (int lane = 0; lane < this->numLanes; lane++) {
+    SpawnSequence spawn(rng, fleetMix.data(), spacing, lane);
 
-    vec3 color = vec3(ofRandom(1.0f), ofRandom(1.0f), ofRandom(1.0f));
+    for (int i = 0; i < numCars; i++) {
+      spawn.next();
+      const uint32_t spawnIndex = spawn.getSpawnIndex();
+      const float startDist = spawn.getDistance();
 
-    traffic.push_back(std::make_shared<SedanCar>(startDist, 0.005f, color,
-                                                 maxCells, maxV, probSlow));
+      vec3 color = vec3(rng.uniform(CounterRng::STREAM_SPAWN, lane, spawnIndex + 1),
+                        rng.uniform(CounterRng::STREAM_SPAWN, lane, spawnIndex + 2),
+                        rng.uniform(CounterRng::STREAM_SPAWN, lane, spawnIndex + 3));
+
+      auto car = makeVehicle(spawn.getType(), startDist, SpawnSequence::START_VELOCITY, color, maxCells, maxV,
+                             probSlow);
+      car->setLane(lane);
+      traffic.push_back(car);
+      bodies.addCar(startDist);
+    }
   }
 
   // 4. Set velocity berdasarkan roadType (HARUS SETELAH traffic dibuat!)
   if (roadType == SPIRAL) {
-    // Gunakan kecepatan SpiralRoad
+    // Gunakan kecepatan SpiralRoad (dikali skala jenis kendaraan)
     for (auto &vehicle : traffic) {
-      vehicle->setMaxVelocity(this->spiralMaxV);
-      vehicle->setVelocity(this->spiralMaxV);
+      float typeMaxV = this->spiralMaxV * getVehicleSpec(vehicle->getType()).maxVScale;
+      vehicle->setMaxVelocity(typeMaxV);
+      vehicle->setVelocity(typeMaxV);
     }
   }
   // Untuk road type lain, velocity sudah diset dari maxV di constructor SedanCar
+
+  // 5. Hybrid: kendaraan di luar region micro jadi density CTM
+  if (physics == scenario::PHYSICS_HYBRID) {
+    setupHybrid();
+  }
 }
 
 void ofApp::TrackInstance::regenerateRoad(RoadType roadType) {
@@ -161,19 +591,25 @@ void ofApp::TrackInstance::regenerateRoad(RoadType roadType) {
     road = std::make_shared<CircleRoad>();
     // Restore kecepatan normal
     for (auto &vehicle : traffic) {
-      vehicle->setMaxVelocity(this->maxV);
+      vehicle->setMaxVelocity(this->maxV * getVehicleSpec(vehicle->getType()).maxVScale);
     }
   } else if (roadType == CURVED) {
     road = std::make_shared<CurvedRoad>();
     // Restore kecepatan normal
     for (auto &vehicle : traffic) {
-      vehicle->setMaxVelocity(this->maxV);
+      vehicle->setMaxVelocity(this->maxV * getVehicleSpec(vehicle->getType()).maxVScale);
     }
   } else if (roadType == PERLIN_NOISE) {
-    road = std::make_shared<PerlinNoiseRoad>();
+    auto perlinRoad = std::make_shared<PerlinNoiseRoad>();
+    perlinRoad->setResolution(perlin.resolution);
+    perlinRoad->setOctaves(perlin.octaves);
+    perlinRoad->setNoiseScale(perlin.noiseScale);
+    perlinRoad->setNoiseSeed(perlin.seed);
+    perlinRoad->setDeformAmount(perlin.deform);
+    road = perlinRoad;
     // Restore kecepatan normal
     for (auto &vehicle : traffic) {
-      vehicle->setMaxVelocity(this->maxV);
+      vehicle->setMaxVelocity(this->maxV * getVehicleSpec(vehicle->getType()).maxVScale);
     }
   } else {  // SPIRAL
     road = std::make_shared<SpiralRoad>();
@@ -182,172 +618,1169 @@ void ofApp::TrackInstance::regenerateRoad(RoadType roadType) {
     // Setiap track punya maxV sendiri untuk SpiralRoad
     // PENTING: Juga set velocity saat ini, bukan cuma maxV!
     for (auto &vehicle : traffic) {
-      vehicle->setMaxVelocity(this->spiralMaxV);
-      vehicle->setVelocity(this->spiralMaxV);  // Reset velocity saat ini juga!
+      float typeMaxV = this->spiralMaxV * getVehicleSpec(vehicle->getType()).maxVScale;
+      vehicle->setMaxVelocity(typeMaxV);
+      vehicle->setVelocity(typeMaxV);  // Reset velocity saat ini juga!
     }
   }
 
   // Generate path dengan bounds yang tersimpan
   road->generatePath(bounds);
+
+  // Posisi lama dari road sebelumnya
+  carFramesValid = false;
+
+  // maxV per jenis kendaraan berubah (SPIRAL ↔ normal)
+  caSynced = false;
+  if (physics == scenario::PHYSICS_MACRO || physics == scenario::PHYSICS_HYBRID) {
+    ctm.setSpeeds(macroFreeSpeed(), macroWaveSpeed());
+  }
+  densityPointsValid = false;
+}
+
+float ofApp::TrackInstance::macroFreeSpeed() const {
+  // Rata-rata maxV jenis kendaraan, berbobot fleetMix
+  float total = 0.0f, scale = 0.0f;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    total += fleetMix[k];
+    scale += fleetMix[k] * getVehicleSpec((VehicleType)k).maxVScale;
+  }
+  float baseMaxV = (roadType == SPIRAL) ? spiralMaxV : maxV;
+  return baseMaxV * ((total > 0.0f) ? scale / total : 1.0f);
+}
+
+float ofApp::TrackInstance::macroVehicleLength() const {
+  float total = 0.0f, length = 0.0f;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    total += fleetMix[k];
+    length += fleetMix[k] * getVehicleSpec((VehicleType)k).length;
+  }
+  return std::max((total > 0.0f) ? length / total : (float)VEHICLE_SPECS[VEHICLE_SEDAN].length, 1.0f);
+}
+
+float ofApp::TrackInstance::macroWaveSpeed() const {
+  // Default = cabang macet NaSch: ujung antrian mundur satu kendaraan
+  // tiap kali kendaraan terdepan lolos random braking
+  if (waveSpeed > 0.0f) return waveSpeed;
+  return macroVehicleLength() * std::max(1.0f - probSlow, 0.05f);
+}
+
+void ofApp::TrackInstance::setupMacro(int numCars, int spacing) {
+  // Jam density = kendaraan mikroskopik berhenti bumper ke bumper
+  const float jamDensity = 1.0f / macroVehicleLength();
+
+  // Cell CTM cukup panjang untuk maxV normal dan SpiralRoad, jadi ganti
+  // roadType tidak mengubah jumlah cell
+  int cellLength = std::max(ctmCellLength, (int)std::ceil(std::max(maxV, spiralMaxV)));
+  ctm.setup(maxCells, cellLength, numLanes, macroFreeSpeed(), macroWaveSpeed(), jamDensity);
+
+  // Kendaraan awal seperti setup(): numCars per lajur dari distance 0
+  ctm.addVehicles(0, numCars * spacing, (float)numCars * numLanes);
+  densityPointsValid = false;
+}
+
+// ==================== HYBRID MICRO / MACRO ====================
+
+void ofApp::TrackInstance::setupHybrid() {
+  // CTM kosong, region awal = seluruh ring (semua kendaraan dari setup()
+  // micro), lalu dipersempit: kendaraan di luar region jadi density
+  setupMacro(0, 0);
+  const int cells = ctm.getCellCount();
+  const float size = ctm.getCellSize();
+  entryCredit = 0.0f;
+  exitCredit = 0.0f;
+  exitBlocked = false;
+  handoffSerial = 0;
+  microRegion = HybridRegion::make(0, cells, cells);
+
+  // Cell macro langsung berjalan dengan kecepatan bebas; kendaraan micro
+  // juga, supaya region tidak mulai sebagai antrean (akselerasi 0.02)
+  // yang terus diisi dari entry
+  for (auto &vehicle : traffic) {
+    vehicle->setVelocity(((roadType == SPIRAL) ? spiralMaxV : maxV) * getVehicleSpec(vehicle->getType()).maxVScale);
+  }
+
+  // Pool kendaraan keluar region: kapasitas untuk semua kendaraan track,
+  // pindah region / handoff tidak mengalokasi ulang vector
+  for (auto &pool : spareVehicles) {
+    pool.reserve(traffic.size() + numLanes);
+  }
+  // Kendaraan yang langsung masuk pool (di luar region sejak awal) belum
+  // punya body point: kapasitasnya disiapkan di sini, bukan saat spawn
+  for (auto &vehicle : traffic) {
+    static_cast<SedanCar *>(vehicle.get())->reserveBody(bodies.getSegmentCount());
+  }
+
+  int length = (microLength > 0) ? microLength : maxCells / 4;
+  setMicroRegion((int)(microBegin / size), (int)std::ceil(length / size));
+}
+
+int ofApp::TrackInstance::cellOf(float distance) const {
+  int cell = (int)(distance / ctm.getCellSize());
+  return std::min(std::max(cell, 0), ctm.getCellCount() - 1);
 }
 
-void ofApp::TrackInstance::update() {
-  // 0. Hapus vehicles yang ditandai untuk dihapus (SpiralRoad black hole)
-  if (!vehiclesToRemove.empty()) {
-    // Sort descending untuk menghapus dari indeks terbesar (aman!)
-    std::sort(vehiclesToRemove.begin(), vehiclesToRemove.end(), std::greater<int>());
+VehicleType ofApp::TrackInstance::pickHandoffType() const {
+  // Kendaraan cadangan acak (bobot = isi pool per jenis): komposisi jenis
+  // track tetap sama dengan setup() dan spawn tidak pernah membuat objek
+  // baru. Pool kosong (tidak terjadi selama jumlah kendaraan terjaga) → fleetMix
+  size_t spare = 0;
+  for (const auto &pool : spareVehicles) {
+    spare += pool.size();
+  }
+  auto weight = [&](int k) { return (spare > 0) ? (float)spareVehicles[k].size() : fleetMix[k]; };
+
+  float total = 0.0f;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    total += weight(k);
+  }
+  float pick = rng.uniform(CounterRng::STREAM_HANDOFF, handoffSerial, 0) * total;
+  VehicleType last = VEHICLE_SEDAN;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    const float w = weight(k);
+    if (w <= 0.0f) continue;
+    if (pick < w) return (VehicleType)k;
+    pick -= w;
+    last = (VehicleType)k;
+  }
+  return last;  // Sisa pembulatan float
+}
 
-    // Hapus dari vector (dari indeks terbesar ke terkecil)
-    for (int idx : vehiclesToRemove) {
-      if (idx < traffic.size()) {
-        traffic.erase(traffic.begin() + idx);
+void ofApp::TrackInstance::addHandoffVehicle(float headDistance, float velocity, int lane, VehicleType type) {
+  vec3 color(rng.uniform(CounterRng::STREAM_HANDOFF, handoffSerial, 1),
+             rng.uniform(CounterRng::STREAM_HANDOFF, handoffSerial, 2),
+             rng.uniform(CounterRng::STREAM_HANDOFF, handoffSerial, 3));
+  handoffSerial++;
+
+  const float typeMaxV = ((roadType == SPIRAL) ? spiralMaxV : maxV) * getVehicleSpec(type).maxVScale;
+  velocity = std::min(std::max(velocity, 0.0f), typeMaxV);
+  if (headDistance >= maxCells) headDistance -= maxCells;
+
+  // Kendaraan yang pernah keluar region dipakai ulang kalau ada
+  std::vector<std::shared_ptr<Vehicle>> &pool = spareVehicles[type];
+  std::shared_ptr<Vehicle> car;
+  if (!pool.empty()) {
+    car = std::move(pool.back());
+    pool.pop_back();
+    car->setDistance(headDistance);
+    car->setVelocity(velocity);
+    car->setColor(color);
+  } else {
+    car = makeVehicle(type, headDistance, velocity, color, maxCells, maxV, probSlow);
+  }
+  car->setMaxVelocity(typeMaxV);
+  car->setLane(lane);
+  traffic.push_back(std::move(car));
+  bodies.addCar(headDistance);
+}
+
+void ofApp::TrackInstance::setMicroRegion(int firstCell, int cellCount) {
+  const int cells = ctm.getCellCount();
+  if (cells == 0) return;
+  const HybridRegion next = HybridRegion::make(firstCell, cellCount, cells);
+  if (next == microRegion) return;
+
+  float *n = ctm.data();
+  const float size = ctm.getCellSize();
+  const float ring = (float)maxCells;
+
+  // 1. Cell micro yang jadi macro: isinya kendaraan yang ada di sana (langkah 2)
+  for (int k = 0; k < microRegion.cellCount; k++) {
+    int cell = (microRegion.firstCell + k) % cells;
+    if (!next.containsCell(cell, cells)) n[cell] = 0.0f;
+  }
+
+  // 2. Kendaraan di luar region baru → +1 di cell CTM-nya
+  auto outside = [&](int i) { return !next.containsDistance(traffic[i]->getDistance(), size, ring); };
+  bodies.compact(outside);
+  size_t kept = 0;
+  for (size_t i = 0; i < traffic.size(); i++) {
+    if (outside((int)i)) {
+      n[cellOf(traffic[i]->getDistance())] += 1.0f;
+      spareVehicles[traffic[i]->getType()].push_back(std::move(traffic[i]));
+      continue;
+    }
+    if (kept != i) traffic[kept] = std::move(traffic[i]);
+    kept++;
+  }
+  traffic.resize(kept);
+
+  // 3. Cell macro yang jadi micro: density → kendaraan berjejer rata per
+  //    lajur dengan kecepatan cell. Pecahan diteruskan, sisanya masuk
+  //    entryCredit (tetap terhitung, di-spawn lewat entry)
+  float carry = 0.0f;
+  for (int k = 0; k < next.cellCount; k++) {
+    int cell = (next.firstCell + k) % cells;
+    if (microRegion.containsCell(cell, cells)) continue;
+
+    float amount = n[cell] + carry;
+    int whole = (int)std::floor(amount);
+    carry = amount - whole;
+    int slots = (whole + numLanes - 1) / numLanes;
+    float v = ctm.speed(cell);
+    for (int i = 0; i < whole; i++) {
+      float head = (cell + ((i / numLanes) + 0.5f) / slots) * size;
+      addHandoffVehicle(head, v, i % numLanes, pickHandoffType());
+    }
+    n[cell] = 0.0f;
+  }
+  entryCredit += carry;
+
+  microRegion = next;
+  carFramesValid = false;
+}
+
+void ofApp::TrackInstance::updateDensityPoints() {
+  // Titik batas bin di centreline road (dihitung ulang hanya saat road berubah)
+  const int bins = std::min(ctm.getCellCount(), (int)MAX_DENSITY_BINS);
+  if (densityPointsValid && (int)densityPoints.size() == bins + 1) return;
+
+  densityPoints.resize(bins + 1);
+  for (int b = 0; b <= bins; b++) {
+    densityPoints[b] = road->getPointAtDistance(toWorldDistance(maxCells * (float)b / bins));
+  }
+  densityPointsValid = true;
+}
+
+void ofApp::TrackInstance::focusAt(vec2 point) {
+  const int cells = ctm.getCellCount();
+  if (cells == 0 || microRegion.cellCount == 0) return;
+
+  // Titik batas bin terdekat (paling banyak MAX_DENSITY_BINS + 1 titik)
+  updateDensityPoints();
+  const int bins = (int)densityPoints.size() - 1;
+  int nearest = 0;
+  float best = std::numeric_limits<float>::max();
+  for (int b = 0; b < bins; b++) {
+    float d = glm::length(densityPoints[b] - point);
+    if (d < best) {
+      best = d;
+      nearest = b;
+    }
+  }
+
+  int center = (int)((int64_t)nearest * cells / bins);
+  setMicroRegion(center - microRegion.cellCount / 2, microRegion.cellCount);
+}
+
+void ofApp::TrackInstance::clearGridWindow() {
+  // Region + margin: ekor kendaraan di belakang awal region, look-ahead
+  // dan dinding di depan ujung region
+  int longest = 0;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    longest = std::max(longest, getVehicleSpec((VehicleType)k).length);
+  }
+  const int margin = longest + (int)std::ceil(std::max(maxV, spiralMaxV)) + 2;
+  const float size = ctm.getCellSize();
+  int begin = (int)std::floor(microRegion.firstCell * size) - margin;
+  int length = (int)std::ceil(microRegion.cellCount * size) + 2 * margin;
+  if (length >= maxCells || grid.size() != (size_t)numLanes * maxCells) {
+    grid.assign(numLanes * maxCells, -1);
+    return;
+  }
+
+  begin = ((begin % maxCells) + maxCells) % maxCells;
+  const int first = std::min(length, maxCells - begin);
+  for (int lane = 0; lane < numLanes; lane++) {
+    int *laneGrid = grid.data() + lane * maxCells;
+    std::fill(laneGrid + begin, laneGrid + begin + first, -1);
+    std::fill(laneGrid, laneGrid + (length - first), -1);
+  }
+}
+
+bool ofApp::TrackInstance::spawnAtEntry(int lane) {
+  // Ekor kendaraan baru di awal region. Badan + entrySpeed + 1 cell di
+  // depannya harus kosong: kendaraan tidak langsung direm (akselerasi
+  // float hanya 0.02 per step, antrean lambat di entry sulit pulih)
+  const VehicleType type = pickHandoffType();
+  const int length = getVehicleSpec(type).length;
+  const float size = ctm.getCellSize();
+  const int clear = length + (int)std::ceil(entrySpeed) + 1;
+  if (clear > microRegion.cellCount * size) return false;
+
+  const int tail = (int)std::ceil(microRegion.firstCell * size) % maxCells;
+  if (sparseOccupancy) {
+    // Kendaraan baru masuk occupancy di rebuild setelah semua spawn
+    if (occupancy.distanceAhead(lane, (tail + maxCells - 1) % maxCells, clear) <= clear) return false;
+    addHandoffVehicle((float)(tail + length - 1), entrySpeed, lane, type);
+    return true;
+  }
+
+  int *laneGrid = grid.data() + lane * maxCells;
+  for (int k = 0; k < clear; k++) {
+    if (laneGrid[(tail + k) % maxCells] != -1) return false;
+  }
+
+  const int index = (int)traffic.size();
+  addHandoffVehicle((float)(tail + length - 1), entrySpeed, lane, type);
+  for (int k = 0; k < length; k++) {
+    laneGrid[(tail + k) % maxCells] = index;
+  }
+  return true;
+}
+
+void ofApp::TrackInstance::beginHybridStep() {
+  const int cells = ctm.getCellCount();
+  if (!microRegion.hasBoundary(cells)) {
+    // Semua macro (CTM saja) atau semua micro (ring NaSch biasa)
+    if (microRegion.cellCount == 0) ctm.computeFlows();
+    exitBlocked = false;
+    rebuildGrid();
+    return;
+  }
+
+  // 1. Kendaraan micro per cell CTM → receiving cell pertama region
+  float *n = ctm.data();
+  for (int k = 0; k < microRegion.cellCount; k++) {
+    n[(microRegion.firstCell + k) % cells] = 0.0f;
+  }
+  for (const auto &vehicle : traffic) {
+    n[cellOf(vehicle->getDistance())] += 1.0f;
+  }
+
+  // 2. Flow semua batas cell, lalu batas region diganti handoff
+  ctm.computeFlows();
+  float *y = ctm.flows();
+
+  // 3. Masuk: flow cell entry jadi credit, paling banyak satu kendaraan
+  //    menunggu per lajur (sisanya tetap di CTM)
+  const int entry = microRegion.entryCell(cells);
+  entrySpeed = ctm.speed(entry);
+  y[entry] = std::min(y[entry], std::max(numLanes - entryCredit, 0.0f));
+  entryCredit += y[entry];
+
+  // 4. Keluar: receiving cell exit menambah credit. Dinding hanya kalau
+  //    credit habis DAN cell exit padat (receiving < kapasitas): di arus
+  //    bebas kendaraan tidak pernah direm mendadak di ujung region
+  const float exitReceiving = ctm.receiving(microRegion.exitCell(cells));
+  exitCredit = std::min(exitCredit + exitReceiving, 2.0f * numLanes);
+  exitBlocked = (exitCredit < 1.0f) && (exitReceiving < ctm.getCapacity());
+
+  // 5. Grid region + dinding, lalu spawn (lajur bergiliran tiap step)
+  rebuildGrid();
+  bool spawned = false;
+  for (int k = 0; k < numLanes && entryCredit >= 1.0f; k++) {
+    if (spawnAtEntry((int)((stepCount + k) % numLanes))) {
+      entryCredit -= 1.0f;
+      spawned = true;
+    }
+  }
+  if (spawned && sparseOccupancy) {
+    rebuildGrid();
+  }
+}
+
+void ofApp::TrackInstance::finishHybridStep() {
+  const int cells = ctm.getCellCount();
+  if (!microRegion.hasBoundary(cells)) {
+    if (microRegion.cellCount == 0) {
+      ctm.applyFlows(0, cells);
+      ctm.sample(detectorCell, telemetry);
+    }
+    return;
+  }
+
+  // 1. Kendaraan yang lewat ujung region → density cell exit
+  const float size = ctm.getCellSize();
+  const float ring = (float)maxCells;
+  const float regionLength = microRegion.cellCount * size;
+  auto exited = [&](int i) {
+    return microRegion.localDistance(traffic[i]->getDistance(), size, ring) >= regionLength;
+  };
+  bodies.compact(exited);
+  int exits = 0;
+  size_t kept = 0;
+  for (size_t i = 0; i < traffic.size(); i++) {
+    if (exited((int)i)) {
+      spareVehicles[traffic[i]->getType()].push_back(std::move(traffic[i]));
+      exits++;
+      continue;
+    }
+    if (kept != i) traffic[kept] = std::move(traffic[i]);
+    kept++;
+  }
+  traffic.resize(kept);
+  exitCredit -= exits;
+
+  // 2. Konservasi cell macro: masuk dari region = kendaraan yang keluar
+  ctm.flows()[microRegion.lastCell(cells)] = (float)exits;
+  const int exitCell = microRegion.exitCell(cells);
+  ctm.applyFlows(exitCell, cells - microRegion.cellCount);
+
+  // 3. Telemetry: sampel micro (sudah di telemetry) + cell macro. Flow
+  //    dari bagian yang memuat detector
+  TrackSample macro;
+  ctm.sample(detectorCell, macro, exitCell, cells - microRegion.cellCount);
+  if (!microRegion.containsDistance(detectorCell, size, ring)) {
+    telemetry.flow = 0.0f;
+  }
+  telemetry = combineSamples(telemetry, macro);
+}
+
+void ofApp::TrackInstance::update(FrameArena &scratch, WorkerPool &pool) {
+  // Physics macro: satu sweep CTM, telemetry dari flow / density per cell
+  if (physics == scenario::PHYSICS_MACRO) {
+    ctm.step();
+    telemetry.step = stepCount;
+    ctm.sample(detectorCell, telemetry);
+    stepCount++;
+    return;
+  }
+
+  // 0. Hapus vehicles yang masuk black hole step lalu (SpiralRoad).
+  //    Compaction di tempat: urutan sisa kendaraan tetap, tanpa alokasi
+  if (removeBlackHoles && carFrames.size() == traffic.size()) {
+    bodies.compact([this](int i) { return carFrames[i].blackHole; });
+    size_t kept = 0;
+    for (size_t i = 0; i < traffic.size(); i++) {
+      if (!carFrames[i].blackHole) {
+        if (kept != i) traffic[kept] = std::move(traffic[i]);
+        kept++;
+      }
+    }
+    if (physics == scenario::PHYSICS_INTEGER && caSynced && ca.getCarCount() == (int)carFrames.size()) {
+      ca.compact([this](int i) { return carFrames[i].blackHole; });
+    }
+    traffic.resize(kept);
+  }
+  removeBlackHoles = false;
+
+  // Hybrid: flow CTM + kendaraan yang masuk region (sebelum array step ini)
+  const bool hybrid = (physics == scenario::PHYSICS_HYBRID);
+  if (hybrid) {
+    beginHybridStep();
+  }
+
+  // Distance sebelum / sesudah + velocity dicatat di step 4 untuk
+  // telemetry selagi kendaraan masih di cache
+  const int count = (int)traffic.size();
+  float *distanceBefore = scratch.alloc<float>(count);
+  float *distanceAfter = scratch.alloc<float>(count);
+  float *velocity = scratch.alloc<float>(count);
+
+  if (physics == scenario::PHYSICS_INTEGER) {
+    // 1-4. CA integer (tanpa grid / lane change) + interpolasi
+    updateIntegerPhysics(distanceBefore, distanceAfter, velocity);
+  } else {
+    // 1. Reset Grid + Map Vehicles to Grid (NORMAL untuk SEMUA direction).
+    //    Hybrid: sudah di beginHybridStep() (termasuk kendaraan baru)
+    if (!hybrid) {
+      rebuildGrid();
+    }
+
+    // 2. Lane change phase (hanya multi-lane), SEBELUM aturan NaSch
+    //    Pass 1 hanya baca grid / occupancy → range kendaraan dibagi ke
+    //    worker simPool (keputusan tiap kendaraan tidak bergantung partisi)
+    //    Pass 2 terapkan semua keputusan sekaligus (serial)
+    if (numLanes > 1) {
+      laneDecisions.resize(traffic.size());
+      const float laneMaxV = (roadType == SPIRAL) ? spiralMaxV : maxV;
+      int8_t *decisions = laneDecisions.data();
+      pool.parallelFor(count, LANE_CHANGE_MIN_CHUNK, [&](int worker, int begin, int end) {
+        if (sparseOccupancy) {
+          laneRule.decide(traffic, occupancy, numLanes, laneMaxV, rng, stepCount, decisions, begin, end);
+        } else {
+          laneRule.decide(traffic, grid.data(), maxCells, numLanes, laneMaxV, rng, stepCount, decisions, begin,
+                          end);
+        }
+      });
+
+      if (LaneChangeRule::apply(traffic, laneDecisions.data()) > 0) {
+        rebuildGrid();
+      }
+    }
+
+    // 3. Set Grid to Vehicles (slice grid sesuai lajur masing-masing, atau
+    //    jarak ke kendaraan depan dari occupancy) + random stream step ini
+    //    (randomize hanya bergantung pada seed track)
+    for (size_t i = 0; i < traffic.size(); i++) {
+      Vehicle &vehicle = *traffic[i];
+      if (sparseOccupancy) {
+        vehicle.setLeaderDistance(occupancy.leaderDistance((int)i));
+      } else {
+        vehicle.setGrid(grid.data() + vehicle.getLane() * maxCells, maxCells);
+      }
+      vehicle.setRandom(&rng, stepCount, (uint32_t)i);
+    }
+
+    // 4. Update Vehicles
+    for (int i = 0; i < count; i++) {
+      Vehicle &vehicle = *traffic[i];
+      distanceBefore[i] = vehicle.getDistance();
+      vehicle.update();
+      distanceAfter[i] = vehicle.getDistance();
+      velocity[i] = vehicle.getVelocity();
+    }
+  }
+
+  // 5. Telemetry step ini (density, flow di detectorCell, velocity, berhenti)
+  telemetry.step = stepCount;
+  sampleTraffic(distanceBefore, distanceAfter, velocity, count, (float)maxCells, maxCells * numLanes,
+                detectorCell, telemetry);
+
+  // Hybrid: kendaraan yang keluar region → CTM, update cell macro
+  if (hybrid) {
+    finishHybridStep();
+  }
+
+  // 6. Posisi kepala semua mobil (satu lookup road per mobil untuk step ini)
+  resolveCarFrames();
+
+  // 7. Update Segments (body hanya bergantung pada distance kepala)
+  updateBodies(scratch);
+
+  // 8. SpiralRoad black hole: mobil di GAP area (carFrames[i].blackHole)
+  //    dihapus di awal step berikutnya, supaya snapshot step ini masih
+  //    menggambarnya hitam
+  if (roadType == SPIRAL) {
+    for (const CarFrame &f : carFrames) {
+      if (f.blackHole) {
+        removeBlackHoles = true;
+        break;
       }
     }
+  }
 
-    // Clear list untuk frame berikutnya
-    vehiclesToRemove.clear();
+  stepCount++;
+}
+
+void ofApp::TrackInstance::updateIntegerPhysics(float *distanceBefore, float *distanceAfter, float *velocity) {
+  const int count = (int)traffic.size();
+  if (!caSynced || ca.getCarCount() != count) {
+    syncIntegerPhysics();
+  }
+
+  // Step CA di awal interval; step simulasi berikutnya hanya menggeser
+  // distance tampilan dari posisi sebelum ke sesudah step CA itu
+  if (caPhase == 0) {
+    ca.step(rng, stepCount);
+  }
+  caPhase = (caPhase + 1) % caInterval;
+  const float t = (caPhase == 0) ? 1.0f : caPhase / (float)caInterval;
+
+  // Velocity traffic tetap cells per step simulasi (seperti mode float)
+  const float perStep = 1.0f / caInterval;
+  for (int i = 0; i < count; i++) {
+    Vehicle &vehicle = *traffic[i];
+    distanceBefore[i] = vehicle.getDistance();
+    vehicle.setDistance(ca.interpolated(i, t));
+    vehicle.setVelocity(ca.getVelocity(i) * perStep);
+    distanceAfter[i] = vehicle.getDistance();
+    velocity[i] = vehicle.getVelocity();
   }
+}
 
-  // 1. Reset Grid
-  grid.assign(maxCells, -1);
+void ofApp::TrackInstance::syncIntegerPhysics() {
+  // maxV & probSlow per jenis dalam satuan step CA (caInterval step simulasi)
+  const float baseMaxV = (roadType == SPIRAL) ? spiralMaxV : maxV;
+  auto fill = [this, baseMaxV]() {
+    ca.reset((uint32_t)maxCells, numLanes);
+    ca.setRules(rules);
+    for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+      const VehicleSpec &spec = VEHICLE_SPECS[k];
+      ca.setType((VehicleType)k, (int)std::lround(baseMaxV * spec.maxVScale * caInterval),
+                 spec.length, probSlow * spec.probSlowScale);
+    }
+    for (const auto &vehicle : traffic) {
+      ca.addCar(vehicle->getLane(), (uint32_t)std::max(0.0f, vehicle->getDistance()),
+                (int)std::lround(vehicle->getVelocity() * caInterval), vehicle->getType());
+    }
+  };
+
+  // Kendaraan depan di IntegerNaSch = indeks berikutnya: traffic dari
+  // setup() sudah urut lajur + posisi, dari snapshot / replay belum tentu
+  auto byLane = [](const std::shared_ptr<Vehicle> &a, const std::shared_ptr<Vehicle> &b) {
+    return a->getLane() < b->getLane();
+  };
+  bool ordered = std::is_sorted(traffic.begin(), traffic.end(), byLane);
+  if (ordered) {
+    fill();
+    ordered = ca.isOrdered();
+  }
+  if (!ordered) {
+    std::stable_sort(traffic.begin(), traffic.end(),
+                     [](const std::shared_ptr<Vehicle> &a, const std::shared_ptr<Vehicle> &b) {
+                       if (a->getLane() != b->getLane()) return a->getLane() < b->getLane();
+                       return a->getDistance() < b->getDistance();
+                     });
+    bodies.reset(bodies.getSegmentCount());
+    for (const auto &vehicle : traffic) {
+      bodies.addCar(vehicle->getDistance());
+    }
+    carFramesValid = false;
+    fill();
+  }
+
+  caPhase = 0;
+  caSynced = true;
+}
+
+void ofApp::TrackInstance::updateBodies(FrameArena &scratch) {
+  // Kepala body = posisi mobil, sudah ada di carFrames kalau masih valid
+  const bool headCached = carFramesValid && carFrames.size() == traffic.size();
+  const int count = (int)traffic.size();
+  const int segs = bodies.getSegmentCount();
+
+  // Jaga-jaga: traffic berubah tanpa lewat bodies → body mulai ulang dari head
+  if (bodies.getCarCount() != count) {
+    bodies.reset(segs);
+    for (int i = 0; i < count; i++) {
+      bodies.addCar(traffic[i]->getDistance());
+    }
+  }
+
+  // A. Head = distance kendaraan (row 0)
+  float *heads = bodies.row(0);
+  for (int i = 0; i < count; i++) {
+    heads[i] = traffic[i]->getDistance();
+  }
+
+  // B. Follow logic: satu kernel untuk semua segment semua mobil
+  //    (fase gelombang dari nomor step, bukan jam dinding → deterministik)
+  bodies.step(stepCount * SegmentFollower::WAVE_PHASE_PER_STEP, (float)maxCells);
+
+  // C. Convert to World Points using THIS track's road
+  //    (buffer sementara dari arena, dibuang saat reset step berikutnya)
+  vec2 *bodyPoints = scratch.alloc<vec2>(segs);
+  for (int i = 0; i < count; i++) {
+    // Semua kendaraan dari makeVehicle() turunan SedanCar
+    SedanCar *car = static_cast<SedanCar *>(traffic[i].get());
+    for (int j = 0; j < segs; j++) {
+      if (j == 0 && headCached) {
+        bodyPoints[j] = carFrames[i].position;
+        continue;
+      }
+      // Jika direction -1, distance di-reverse untuk world positioning
+      float worldD = toWorldDistance(bodies.at(i, j));
+      bodyPoints[j] = getLanePoint(worldD, car->getLane());
+    }
+
+    car->updateBody(bodyPoints, segs);
+  }
+}
+
+void ofApp::TrackInstance::applyReplayStep(const float *distances, const float *velocities, const uint32_t *ids,
+                                           const uint8_t *lanes, int count, FrameArena &scratch) {
+  // Kendaraan hanya bisa berkurang (black hole SpiralRoad) selama rekaman.
+  // Id naik di traffic maupun di rekaman: yang tidak ada di rekaman dibuang,
+  // compaction sama dengan update() supaya warna, jenis & body tetap cocok
+  const int current = (int)traffic.size();
+  uint8_t *removed = scratch.alloc<uint8_t>(current);
+  int matched = 0;
+  for (int i = 0; i < current; i++) {
+    removed[i] = !(matched < count && traffic[i]->getRecordId() == ids[matched]);
+    if (!removed[i]) matched++;
+  }
+  if (matched < current) {
+    bodies.compact([removed](int i) { return removed[i] != 0; });
+    size_t kept = 0;
+    for (size_t i = 0; i < traffic.size(); i++) {
+      if (!removed[i]) {
+        if (kept != i) traffic[kept] = std::move(traffic[i]);
+        kept++;
+      }
+    }
+    traffic.resize(kept);
+  }
+  removeBlackHoles = false;
+  caSynced = false;  // Physics integer lanjut dari posisi rekaman
+
+  for (int i = 0; i < matched; i++) {
+    traffic[i]->setDistance(distances[i]);
+    traffic[i]->setVelocity(velocities[i]);
+    traffic[i]->setLane(std::min((int)lanes[i], numLanes - 1));
+  }
+
+  resolveCarFrames();
+  updateBodies(scratch);
+  stepCount++;
+}
+
+void ofApp::TrackInstance::rebuildGrid() {
+  // Physics integer: IntegerNaSch mencari kendaraan depan sendiri
+  if (physics == scenario::PHYSICS_INTEGER) return;
+
+  // Hybrid: cell exit belum bisa menerima → dinding tepat di ujung region
+  const bool windowed = (physics == scenario::PHYSICS_HYBRID) && microRegion.hasBoundary(ctm.getCellCount());
+  int wall = -1;
+  if (windowed && exitBlocked) {
+    const float end = (microRegion.firstCell + microRegion.cellCount) * ctm.getCellSize();
+    wall = (int)std::ceil(end) % maxCells;
+  }
+
+  if (sparseOccupancy) {
+    occupancy.rebuild(traffic);
+    occupancy.setWall(wall);
+    return;
+  }
+
+  // Hybrid: hanya region micro + margin (kendaraan tidak pernah di luarnya)
+  if (windowed) {
+    clearGridWindow();
+  } else {
+    grid.assign(numLanes * maxCells, -1);
+  }
+
+  const int count = (int)traffic.size();
+  for (int i = 0; i < count; i++) {
+    int pos = (int)traffic[i]->getDistance();
+    pos = pos % maxCells;
+    int lane = ofClamp(traffic[i]->getLane(), 0, numLanes - 1);
+    int *laneGrid = grid.data() + lane * maxCells;
+
+    // Tandai SELURUH panjang kendaraan: kepala (pos) mundur sampai ekor
+    int length = std::min(traffic[i]->getLength(), maxCells);
+    for (int k = 0; k < length; k++) {
+      int cell = pos - k;
+      if (cell < 0) cell += maxCells;
+      laneGrid[cell] = i;
+    }
+  }
+
+  if (wall >= 0) {
+    for (int lane = 0; lane < numLanes; lane++) {
+      grid[lane * maxCells + wall] = GRID_WALL;
+    }
+  }
+}
+
+float ofApp::TrackInstance::toWorldDistance(float cellDist) const {
+  float roadLen = road->getTotalLength();
+  float worldD = cellDist * (roadLen / maxCells);
+
+  // Jika direction = -1 (clockwise), reverse distance
+  if (direction == -1) {
+    worldD = roadLen - worldD;
+  }
+  return worldD;
+}
+
+vec2 ofApp::TrackInstance::getLanePoint(float worldDist, int lane) const {
+  vec2 p = road->getPointAtDistance(worldDist);
+  if (numLanes <= 1) {
+    return p;
+  }
+  return offsetToLane(p, road->getTangentAtDistance(worldDist), lane);
+}
+
+vec2 ofApp::TrackInstance::offsetToLane(vec2 p, vec2 tangent, int lane) const {
+  if (numLanes <= 1) {
+    return p;
+  }
+
+  // Arah gerak mobil (tangent dibalik kalau direction = -1)
+  vec2 t = (direction == -1) ? -tangent : tangent;
+
+  // Normal kanan dari arah gerak; lajur 0 paling kanan
+  vec2 right(-t.y, t.x);
+  float offset = ((numLanes - 1) * 0.5f - lane) * laneWidth;
+  return p + right * offset;
+}
+
+void ofApp::TrackInstance::resolveCarFrames() {
+  carFrames.resize(traffic.size());
+  for (size_t i = 0; i < traffic.size(); i++) {
+    const Vehicle &vehicle = *traffic[i];
+    float dist = toWorldDistance(vehicle.getDistance());
+
+    CarFrame &f = carFrames[i];
+    f.tangent = road->getTangentAtDistance(dist);
+    f.position = offsetToLane(road->getPointAtDistance(dist), f.tangent, vehicle.getLane());
+    f.color = vehicle.getColor();
+    f.blackHole = isInBlackHole(f.position);
+  }
+  carFramesValid = true;
+}
+
+snapshot::SnapshotTrack ofApp::TrackInstance::toSnapshotRecord() const {
+  snapshot::SnapshotTrack r;
+  std::memset(&r, 0, sizeof(r));
+
+  r.roadType = (uint32_t)roadType;
+  r.direction = direction;
+  r.maxCells = maxCells;
+  r.numLanes = numLanes;
+  r.boundsX = bounds.x;
+  r.boundsY = bounds.y;
+  r.boundsW = bounds.width;
+  r.boundsH = bounds.height;
+  r.laneWidth = laneWidth;
+
+  r.maxV = maxV;
+  r.spiralMaxV = spiralMaxV;
+  r.probSlow = probSlow;
+
+  r.numLinesPerCar = numLinesPerCar;
+  r.curveIntensity = curveIntensity;
+  r.curveAngle1 = curveAngle1;
+  r.curveAngle2 = curveAngle2;
+  r.flags = (visible ? (uint32_t)snapshot::FLAG_VISIBLE : 0u) |
+            (drawFromCenter ? (uint32_t)snapshot::FLAG_DRAW_FROM_CENTER : 0u) |
+            (gradientMode ? (uint32_t)snapshot::FLAG_GRADIENT_MODE : 0u) |
+            (physics == scenario::PHYSICS_INTEGER ? (uint32_t)snapshot::FLAG_INTEGER_PHYSICS : 0u) |
+            (physics == scenario::PHYSICS_MACRO ? (uint32_t)snapshot::FLAG_MACRO_PHYSICS : 0u) |
+            (physics == scenario::PHYSICS_HYBRID ? (uint32_t)snapshot::FLAG_HYBRID_PHYSICS : 0u);
+  r.caInterval = (uint32_t)caInterval;
+  r.ruleFlags = (rules.velocityDependent ? (uint32_t)snapshot::RULE_VDR : 0u) |
+                (rules.slowToStart ? (uint32_t)snapshot::RULE_SLOW_TO_START : 0u) |
+                (rules.anticipation ? (uint32_t)snapshot::RULE_ANTICIPATION : 0u);
+  r.probSlowStopped = rules.probSlowStopped;
+  r.probSlowToStart = rules.probSlowToStart;
+  r.slowToStartGap = rules.slowToStartGap;
+  r.anticipationSafety = rules.anticipationSafety;
+  const bool hasCells = (physics == scenario::PHYSICS_MACRO || physics == scenario::PHYSICS_HYBRID);
+  r.cellCount = hasCells ? (uint32_t)ctm.getCellCount() : 0;
+  r.waveSpeed = waveSpeed;
+  r.ctmCellLength = ctmCellLength;
+  r.microFirstCell = (uint32_t)microRegion.firstCell;
+  r.microCellCount = (uint32_t)microRegion.cellCount;
+  r.entryCredit = entryCredit;
+  r.exitCredit = exitCredit;
+  r.handoffSerial = handoffSerial;
+
+  r.laneMode = (uint32_t)laneRule.getMode();
+  r.probLaneChange = laneRule.getProbChange();
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    r.fleetMix[k] = fleetMix[k];
+  }
+
+  r.rngSeed = rng.seed;
+  r.stepCount = stepCount;
+
+  // Semua kendaraan satu track punya jumlah segment yang sama
+  r.vehicleCount = traffic.size();
+  r.segmentsPerVehicle = traffic.empty() ? 0 : (uint32_t)bodies.getSegmentCount();
+  return r;
+}
+
+void ofApp::TrackInstance::writeSnapshotArrays(const SnapshotWriter::Arrays &out) const {
+  const uint32_t segs = toSnapshotRecord().segmentsPerVehicle;
+
+  for (size_t i = 0; i < traffic.size(); i++) {
+    const Vehicle &vehicle = *traffic[i];
+    vec3 col = vehicle.getColor();
+
+    out.distance[i] = vehicle.getDistance();
+    out.velocity[i] = vehicle.getVelocity();
+    out.color[i * 3 + 0] = col.r;
+    out.color[i * 3 + 1] = col.g;
+    out.color[i * 3 + 2] = col.b;
+    out.lane[i] = (uint8_t)vehicle.getLane();
+    out.type[i] = (uint8_t)vehicle.getType();
+
+    // Body segment (layout file per kendaraan, di memory per segment)
+    if (segs > 0) {
+      bodies.copyCar((int)i, out.segments + i * segs);
+    }
+  }
+
+  if (physics == scenario::PHYSICS_MACRO || physics == scenario::PHYSICS_HYBRID) {
+    std::copy(ctm.data(), ctm.data() + ctm.getCellCount(), out.cells);
+  }
+}
+
+void ofApp::TrackInstance::restoreFromSnapshot(const snapshot::SnapshotTrack &r,
+                                               const SnapshotReader::Arrays &in) {
+  bounds = ofRectangle(r.boundsX, r.boundsY, r.boundsW, r.boundsH);
+  direction = r.direction;
+  maxCells = std::max(1, r.maxCells);
+  numLanes = std::max(1, r.numLanes);
+  laneWidth = r.laneWidth;
+
+  maxV = r.maxV;
+  spiralMaxV = r.spiralMaxV;
+  probSlow = r.probSlow;
+
+  numLinesPerCar = r.numLinesPerCar;
+  curveIntensity = r.curveIntensity;
+  curveAngle1 = r.curveAngle1;
+  curveAngle2 = r.curveAngle2;
+  visible = (r.flags & snapshot::FLAG_VISIBLE) != 0;
+  drawFromCenter = (r.flags & snapshot::FLAG_DRAW_FROM_CENTER) != 0;
+  gradientMode = (r.flags & snapshot::FLAG_GRADIENT_MODE) != 0;
+  physics = (r.flags & snapshot::FLAG_HYBRID_PHYSICS)    ? scenario::PHYSICS_HYBRID
+            : (r.flags & snapshot::FLAG_MACRO_PHYSICS)   ? scenario::PHYSICS_MACRO
+            : (r.flags & snapshot::FLAG_INTEGER_PHYSICS) ? scenario::PHYSICS_INTEGER
+                                                         : scenario::PHYSICS_FLOAT;
+  waveSpeed = r.waveSpeed;
+  ctmCellLength = std::max(0, r.ctmCellLength);
+  caInterval = std::max(1u, r.caInterval);
+  rules.velocityDependent = (r.ruleFlags & snapshot::RULE_VDR) != 0;
+  rules.slowToStart = (r.ruleFlags & snapshot::RULE_SLOW_TO_START) != 0;
+  rules.anticipation = (r.ruleFlags & snapshot::RULE_ANTICIPATION) != 0;
+  rules.probSlowStopped = r.probSlowStopped;
+  rules.probSlowToStart = r.probSlowToStart;
+  rules.slowToStartGap = r.slowToStartGap;
+  rules.anticipationSafety = r.anticipationSafety;
+  caPhase = 0;
+  caSynced = false;
+
+  LaneChangeRule::Mode laneMode =
+      (r.laneMode == LaneChangeRule::ASYMMETRIC) ? LaneChangeRule::ASYMMETRIC : LaneChangeRule::SYMMETRIC;
+  laneRule = LaneChangeRule(laneMode, r.probLaneChange);
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    fleetMix[k] = r.fleetMix[k];
+  }
+
+  rng = CounterRng(r.rngSeed);
+  stepCount = r.stepCount;
+
+  // Kendaraan: array dibaca langsung dari file yang di-map
+  const size_t n = (size_t)r.vehicleCount;
+  const uint32_t segs = r.segmentsPerVehicle;
+  traffic.clear();
+  traffic.reserve(n);
+  removeBlackHoles = false;
+  laneDecisions.clear();
+  bodies.reset(segs > 0 ? (int)segs : SegmentFollower::DEFAULT_SEGMENTS);
+
+  for (size_t i = 0; i < n; i++) {
+    VehicleType type = (in.type[i] < VEHICLE_TYPE_COUNT) ? (VehicleType)in.type[i] : VEHICLE_SEDAN;
+    vec3 color(in.color[i * 3 + 0], in.color[i * 3 + 1], in.color[i * 3 + 2]);
+
+    auto car = makeVehicle(type, in.distance[i], in.velocity[i], color, maxCells, maxV, probSlow);
+    car->setLane(std::min((int)in.lane[i], numLanes - 1));
+    car->setRecordId((uint32_t)i);  // Sama dengan penomoran di startRecording()
+
+    if (segs > 0) {
+      bodies.addCar(in.segments + i * segs, (int)segs);
+    } else {
+      bodies.addCar(in.distance[i]);
+    }
+
+    traffic.push_back(car);
+  }
+
+  // Road + maxV per jenis kendaraan sesuai roadType
+  regenerateRoad((RoadType)std::min(r.roadType, (uint32_t)SPIRAL));
+
+  // regenerateRoad() me-reset velocity di SPIRAL, kembalikan ke nilai snapshot
+  if (roadType == SPIRAL) {
+    for (size_t i = 0; i < n; i++) {
+      traffic[i]->setVelocity(in.velocity[i]);
+    }
+  }
+
+  if (physics == scenario::PHYSICS_MACRO || physics == scenario::PHYSICS_HYBRID) {
+    // Jumlah cell dari parameter yang sama → sama dengan saat disimpan.
+    // Kalau tidak (file dari build lain), total kendaraan disebar merata
+    setupMacro(0, 0);
+    if ((uint32_t)ctm.getCellCount() == r.cellCount) {
+      std::copy(in.cells, in.cells + r.cellCount, ctm.data());
+    } else {
+      double total = 0.0;
+      for (uint32_t i = 0; i < r.cellCount; i++) total += in.cells[i];
+      ctm.addVehicles(0, maxCells, (float)total);
+    }
+
+    microRegion = HybridRegion::make((int)r.microFirstCell, (int)r.microCellCount, ctm.getCellCount());
+    entryCredit = r.entryCredit;
+    exitCredit = r.exitCredit;
+    exitBlocked = false;
+    handoffSerial = r.handoffSerial;
+    if (physics == scenario::PHYSICS_MACRO) {
+      grid.clear();
+      return;
+    }
+    if (!sparseOccupancy) {
+      grid.assign(numLanes * maxCells, -1);  // Region di luar window lama bisa kotor
+    }
+  }
+
+  rebuildGrid();
+}
+
+bool ofApp::TrackInstance::isInBlackHole(vec2 pos) const {
+  if (roadType != SPIRAL) return false;
+
+  // Pakai center dari bounds, bukan screen center (untuk multi-track)
+  // Threshold GAP: Absolute 100 pixels (SEMUA inner track masuk black hole!)
+  vec2 trackCenter(bounds.x + bounds.width / 2.0f, bounds.y + bounds.height / 2.0f);
+  return glm::length(pos - trackCenter) < 100.0f;
+}
 
-  // 2. Map Vehicles to Grid (NORMAL untuk SEMUA direction)
-  for (int i = 0; i < traffic.size(); i++) {
-    int pos = (int)traffic[i]->getDistance();
-    pos = pos % maxCells;
-    grid[pos] = i;
+void ofApp::TrackInstance::fillSnapshot(TrackSnapshot &out) {
+  // Parameter render (bisa berubah lewat tombol di antara step)
+  out.center = vec2(bounds.x + bounds.width / 2.0f, bounds.y + bounds.height / 2.0f);
+  out.spiral = (roadType == SPIRAL);
+  out.visible = visible;
+  out.drawFromCenter = drawFromCenter;
+  out.gradientMode = gradientMode;
+  out.numLinesPerCar = numLinesPerCar;
+  out.curveIntensity = curveIntensity;
+  out.curveAngle1 = curveAngle1;
+  out.curveAngle2 = curveAngle2;
+  out.macro = (physics == scenario::PHYSICS_MACRO);
+
+  if (out.macro) {
+    out.clear();
+    fillDensitySnapshot(out);
+    return;
   }
 
-  // 3. Set Grid to Vehicles
-  for (auto &vehicle : traffic) {
-    vehicle->setGrid(grid.data(), grid.size());
+  // Road diganti / snapshot di-load di luar step → resolve sekali di sini
+  if (!carFramesValid || carFrames.size() != traffic.size()) {
+    resolveCarFrames();
   }
 
-  // 4. Update Vehicles & Segments
-  for (auto &vehicle : traffic) {
-    vehicle->update();
-
-    // Update SedanCar segment positions (untuk physics simulation)
-    SedanCar *car = dynamic_cast<SedanCar *>(vehicle.get());
-    if (car) {
-      auto &segments = car->getSegmentDistances();
-
-      // A. Head check
-      segments[0] = car->getDistance();
-
-      // B. Follow logic
-      float time = ofGetElapsedTimef() * 6.0f;
-      for (size_t j = 1; j < segments.size(); j++) {
-        float leaderDist = segments[j - 1];
-        float followerDist = segments[j];
-        float targetSpacing = 5.0f + sin(time - j * 0.5f) * 2.0f;
-
-        float diff = leaderDist - followerDist;
-        if (diff < -maxCells / 2.0f)
-          diff += maxCells;
-        if (diff > maxCells / 2.0f)
-          diff -= maxCells;
-
-        float actualSpacing = diff;
-        float spacingError = actualSpacing - targetSpacing;
-        float moveAmt = spacingError * 0.2f;
-
-        segments[j] += moveAmt;
-
-        // Range check
-        if (segments[j] >= maxCells)
-          segments[j] -= maxCells;
-        if (segments[j] < 0)
-          segments[j] += maxCells;
-      }
+  // Kapasitas array tetap dari snapshot sebelumnya → tidak alokasi ulang
+  out.clear();
+  for (size_t i = 0; i < traffic.size(); i++) {
+    const auto &vehicle = traffic[i];
+    const CarFrame &f = carFrames[i];
+
+    out.position.push_back(f.position);
+    out.tangent.push_back(f.tangent);
+    out.color.push_back(f.color);
+    out.velocity.push_back(vehicle->getVelocity());
+    out.blackHole.push_back(f.blackHole ? 1 : 0);
+    out.bodyOffset.push_back((uint32_t)out.bodyPoints.size());
+
+    const SedanCar *car = static_cast<const SedanCar *>(vehicle.get());
+    const auto &body = car->getBodyPoints();
+    out.bodyPoints.insert(out.bodyPoints.end(), body.begin(), body.end());
+    out.drawSize.push_back(car->getDrawSize());
+  }
+  out.bodyOffset.push_back((uint32_t)out.bodyPoints.size());
 
-      // C. Convert to World Points using THIS track's road
-      std::vector<vec2> bodyPoints;
-      float roadLen = road->getTotalLength();
+  // Hybrid: density bagian macro di bawah kendaraan micro
+  if (physics == scenario::PHYSICS_HYBRID) {
+    fillDensitySnapshot(out);
+  }
+}
 
-      for (float d : segments) {
-        float worldD = d * (roadLen / maxCells);
+void ofApp::TrackInstance::fillStateExport(SharedStateExporter &out) const {
+  // Physics macro: traffic kosong, track tetap diekspor (tanpa kendaraan)
+  size_t bodyPointCount = 0;
+  for (const auto &vehicle : traffic) {
+    bodyPointCount += static_cast<const SedanCar *>(vehicle.get())->getBodyPoints().size();
+  }
 
-        // Jika direction -1, reverse distance untuk world positioning
-        if (direction == -1) {
-          worldD = roadLen - worldD;
-        }
+  const uint32_t count = (uint32_t)traffic.size();
+  if (!out.beginTrack(count, (uint32_t)bodyPointCount, (uint32_t)numLanes, (uint32_t)physics, (uint32_t)maxCells)) {
+    return;
+  }
 
-        bodyPoints.push_back(road->getPointAtDistance(worldD));
-      }
+  // Langsung ke slot shared memory, tanpa buffer perantara
+  float *distance = out.distances();
+  float *velocity = out.velocities();
+  uint8_t *lane = out.lanes();
+  float *color = out.colors();
+  uint32_t *bodyBegin = out.bodyBegins();
+  float *bodyPoints = out.bodyPoints();
+  uint32_t bodyPoint = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const SedanCar &car = static_cast<const SedanCar &>(*traffic[i]);
+    distance[i] = car.getDistance();
+    velocity[i] = car.getVelocity();
+    lane[i] = (uint8_t)car.getLane();
+    const vec3 c = car.getColor();
+    color[3 * i] = c.r;
+    color[3 * i + 1] = c.g;
+    color[3 * i + 2] = c.b;
+
+    const std::vector<vec2> &body = car.getBodyPoints();
+    bodyBegin[i] = bodyPoint;
+    std::memcpy(bodyPoints + 2 * (size_t)bodyPoint, body.data(), body.size() * sizeof(vec2));
+    bodyPoint += (uint32_t)body.size();
+  }
+  bodyBegin[count] = bodyPoint;
+}
 
-      car->updateBody(bodyPoints);
+void ofApp::TrackInstance::fillDensitySnapshot(TrackSnapshot &out) {
+  const int cells = ctm.getCellCount();
+  const int bins = std::min(cells, (int)MAX_DENSITY_BINS);
+  if (bins == 0) return;
+
+  updateDensityPoints();
+  out.densityPoints.insert(out.densityPoints.end(), densityPoints.begin(), densityPoints.end());
+
+  // Bin b = cell [b * cells / bins, (b + 1) * cells / bins), density n / N.
+  // Cell region micro (hybrid) tidak dihitung; bin yang seluruhnya micro = -1
+  const bool hybrid = (physics == scenario::PHYSICS_HYBRID);
+  const float *n = ctm.data();
+  const float maxPerCell = std::max(ctm.getCellMaximum(), 1e-6f);
+  for (int b = 0; b < bins; b++) {
+    int begin = (int)((int64_t)b * cells / bins);
+    int end = (int)((int64_t)(b + 1) * cells / bins);
+    float sum = 0.0f;
+    int macroCells = 0;
+    for (int i = begin; i < end; i++) {
+      if (hybrid && microRegion.containsCell(i, cells)) continue;
+      sum += n[i];
+      macroCells++;
     }
+    out.density.push_back((macroCells > 0) ? std::min(sum / (maxPerCell * macroCells), 1.0f) : -1.0f);
   }
+  out.densityWidth = std::max(3.0f, numLanes * laneWidth);
 }
 
-void ofApp::TrackInstance::draw(ofPoint (bezierHelper)(float, ofPoint, ofPoint, ofPoint, ofPoint), float wobbleTime, bool gradientMode) {
-  // TEST: Gambar road polyline untuk lihat apa yang terjadi
-  //road->draw();
+// ==================== RENDER DARI SNAPSHOT ====================
 
-  // Draw Vehicles
-  for (auto &vehicle : traffic) {
-    float dist = vehicle->getDistance() * (road->getTotalLength() / maxCells);
+void ofApp::drawTrackVehicles(const TrackSnapshot &track) {
+  for (int i = 0; i < track.size(); i++) {
+    drawSnapshotCar(track, i);
+  }
+}
 
-    // Jika direction = -1 (clockwise), reverse distance
-    if (direction == -1) {
-      dist = road->getTotalLength() - dist;
-    }
+void ofApp::drawTrackDensity(const TrackSnapshot &track) {
+  // Kosong → hijau kebiruan, macet → merah
+  const ofColor freeColor(0, 200, 180);
+  const ofColor jamColor(230, 30, 30);
+
+  ofSetLineWidth(track.densityWidth);
+  for (size_t b = 0; b < track.density.size(); b++) {
+    if (track.density[b] < 0.0f) continue;  // Region micro (hybrid)
+    const vec2 &p0 = track.densityPoints[b];
+    const vec2 &p1 = track.densityPoints[b + 1];
+    ofSetColor(freeColor.getLerped(jamColor, track.density[b]), 180);
+    ofDrawLine(p0.x, p0.y, p1.x, p1.y);
+  }
+  ofSetLineWidth(1.0f);
+}
 
-    vec2 pos = road->getPointAtDistance(dist);
-    vec2 tangent = road->getTangentAtDistance(dist);
-    float angle = ofRadToDeg(atan2(tangent.y, tangent.x));
+void ofApp::drawSnapshotCar(const TrackSnapshot &track, int i) {
+  // Sama seperti SedanCar::drawBody(): lingkaran di kepala body,
+  // mobil macet (v ≈ 0) tidak digambar
+  uint32_t head = track.bodyOffset[i];
+  if (head == track.bodyOffset[i + 1] || track.velocity[i] < 0.1f) {
+    return;
+  }
 
-    // ===== SPIRAL ROAD BLACK HOLE EFFECT =====
-    // Check apakah mobil di GAP area (SpiralRoad only)
-    vec2 carPos(pos.x, pos.y);
+  vec2 pos = track.bodyPoints[head];
+  vec3 col = track.color[i];
+  ofSetColor(ofColor(col.r * 255, col.g * 255, col.b * 255), 150);
+  ofFill();
+  ofDrawCircle(pos.x, pos.y, track.drawSize[i]);
+}
 
-    // Pakai center dari bounds, bukan screen center (untuk multi-track)
-    vec2 trackCenter(bounds.x + bounds.width / 2.0f, bounds.y + bounds.height / 2.0f);
+void ofApp::buildTrackGeometry(BezierBatch &batch, const TrackSnapshot &track, int begin, int end,
+                               float wobbleTime) const {
+  // Pakai center dari bounds, bukan screen center (untuk multi-track)
+  const vec2 trackCenter = track.center;
+  ofPoint centerPoint(trackCenter.x, trackCenter.y);  // Convert vec2 ke ofPoint
+
+  const int numLinesPerCar = track.numLinesPerCar;
+  const bool drawFromCenter = track.drawFromCenter;
+  const bool gradientMode = track.gradientMode;
+  const float curveIntensity = track.curveIntensity;
+  const float curveAngle1 = track.curveAngle1;
+  const float curveAngle2 = track.curveAngle2;
+
+  for (int i = begin; i < end; i++) {
+    vec2 carPos = track.position[i];
     float radius = glm::length(carPos - trackCenter);
 
-    bool inBlackHole = false;  // Flag untuk cek apakah di black hole
-
-    if (roadType == SPIRAL) {
-      // Threshold GAP: Absolute 150 pixels (SEMUA inner track masuk black hole!)
-      float gapThreshold = 100.0f;
-
-      if (radius < gapThreshold) {
-        inBlackHole = true;  // Masuk black hole!
-
-        // Mark vehicle untuk DIHAPUS (cari indeksnya di traffic vector)
-        for (int i = 0; i < traffic.size(); i++) {
-          if (traffic[i] == vehicle) {
-            vehiclesToRemove.push_back(i);  // Tambah ke list untuk dihapus
-            break;  // Sudah ketemu, keluar loop
-          }
-        }
-      }
-    }
-
-    // Skip drawing vehicle jika gradient mode aktif
-    if (!gradientMode) {
-      if (inBlackHole) {
-        // Gambar mobil dengan WARNA HITAM (merge dengan background)
-        ofSetColor(0, 0, 0);  // Hitam total
-        vehicle->draw(pos.x, pos.y, angle);
-      } else {
-        vehicle->draw(pos.x, pos.y, angle);
-      }
-    }
-
     // Gambar MULTIPLE garis radial bezier
-    ofPoint centerPoint(trackCenter.x, trackCenter.y);  // Convert vec2 ke ofPoint
-    float angleToCar = atan2(carPos.y - centerPoint.y, carPos.x - centerPoint.x);
-    vec3 col = vehicle->getColor();
+    vec3 col = track.color[i];
 
-    // Jika di black hole, bezier juga HITAM
-    if (inBlackHole) {
+    // Jika di black hole (SpiralRoad), bezier juga HITAM
+    if (track.blackHole[i]) {
       col = vec3(0, 0, 0);  // Hitam
     }
 
     // Hitung radius mobil (berdasarkan velocity)
-    float v = vehicle->getVelocity();
+    float v = track.velocity[i];
     float carDiameter = ofMap(v, 0, 15, 20, 10);  // Diameter mobil (10-20 pixel)
     float carRadius = carDiameter / 2.0f;            // Radius mobil
     float gap = 5.0f;  // Gap 5 pixel dari pinggir mobil
@@ -392,43 +1825,18 @@ void ofApp::TrackInstance::draw(ofPoint (bezierHelper)(float, ofPoint, ofPoint,
       ofPoint p2(p0.x + cos(lineAngle + curveAngle2) * (curveAmount + wobble2),
                  p0.y + sin(lineAngle + curveAngle2) * (curveAmount + wobble2));
 
-      // Tessellate bezier curve
-      int segments = 100;
+      // Tessellate bezier curve (di batch, satu VBO untuk semua garis per frame)
+      const int segments = bezierMaxSegments;
+      vec2 b0(p0.x, p0.y), b1(p1.x, p1.y), b2(p2.x, p2.y), b3(p3.x, p3.y);
 
       if (gradientMode) {
-        // GRADIENT MODE: Hitam ke Orange dengan vertex colors
-        ofMesh bezierMesh;
-        bezierMesh.setMode(OF_PRIMITIVE_LINE_STRIP);
-
-        for(int k = 0; k <= segments; k++) {
-          float t = (float)k / segments;
-          ofPoint p = bezierHelper(t, p0, p1, p2, p3);
-          bezierMesh.addVertex(glm::vec3(p.x, p.y, 0.0f));
-
-          // Gradient dari putih (255,255,255) ke gelap (0,0,0)
-          float val = ofMap(t, 0.0f, 1.0f, 255.0f, 0.0f);  // Reverse: 255→0
-          bezierMesh.addColor(ofColor(val, val, val, 150));  // Grayscale gradient, Alpha 200
-        }
-
-        // Gambar mesh dengan gradient
-        bezierMesh.draw();
+        // GRADIENT MODE: putih (t = 0) ke gelap (t = 1) dengan vertex colors, alpha 150
+        batch.addCurve(b0, b1, b2, b3, ofFloatColor(1.0f, 1.0f, 1.0f, 150 / 255.0f),
+                       ofFloatColor(0.0f, 0.0f, 0.0f, 150 / 255.0f), 3, segments);
       } else {
-        // NORMAL MODE: Single color dengan alpha variation
-        ofPolyline bezierPolyline;
-
-        for(int k = 0; k <= segments; k++) {
-          float t = (float)k / segments;
-          ofPoint p = bezierHelper(t, p0, p1, p2, p3);
-          bezierPolyline.addVertex(p.x, p.y);
-        }
-
-        // Alpha bervariasi per garis
+        // NORMAL MODE: Single color dengan alpha bervariasi per garis
         float alpha = ofMap(lineIdx, 0, numLinesPerCar - 1, 80, 150);
-        ofSetColor(col.r * 255, col.g * 255, col.b * 255, alpha);
-
-        // Gambar bezier polyline sebagai garis kontinu
-        ofSetLineWidth(3);
-        bezierPolyline.draw();
+        batch.addCurve(b0, b1, b2, b3, ofFloatColor(col.r, col.g, col.b, alpha / 255.0f), 3, segments);
       }
     }
   }
@@ -436,17 +1844,66 @@ void ofApp::TrackInstance::draw(ofPoint (bezierHelper)(float, ofPoint, ofPoint,
 
 //--------------------------------------------------------------
 void ofApp::keyPressed(int key) {
+  keyThisFrame = true;
+
   // Mulai simulasi dengan tombol 's' atau 'S'
   if (key == 's' || key == 'S') {
     simulationStarted = true;
+    return;
+  }
+
+  // Toggle TAB mode dengan tombol TAB (ASCII 9 atau '\t') - hanya render
+  if (key == 9 || key == '\t') {
+    tabMode = !tabMode;  // Toggle inter-track bezier mode
+    return;
+  }
+
+  // Region micro track hybrid ikut mouse ('F', main thread → FOCUS tiap frame)
+  if (key == 'f' || key == 'F') {
+    focusFollowMouse = !focusFollowMouse;
+    return;
+  }
+
+  // Keluar dengan tombol 'q' atau 'Q' (exit() menghentikan thread simulasi
+  // dan menutup rekaman)
+  if (key == 'q' || key == 'Q') {
+    ofExit();
+    return;
+  }
+
+  // Bersihkan trail saat ganti road / mode (GL → harus di main thread)
+  bool seek = (key == OF_KEY_LEFT || key == OF_KEY_RIGHT) && frames.readBuffer().replayMode;
+  if (key == '1' || key == '2' || key == 'l' || key == 'L' || key == 'p' || key == 'P' ||
+      key == 'n' || key == 'N' || seek) {
+    ofBackground(0);
+  }
+
+  // Sisanya mengubah state simulasi → dijalankan thread simulasi (applyKey)
+  if (!commands.push({SimCommand::KEY, key})) {
+    ofLogWarning("ofApp") << "Antrian perintah simulasi penuh, tombol diabaikan: " << key;
+  }
+}
+
+//--------------------------------------------------------------
+void ofApp::applyFocus(vec2 point) {
+  if (networkMode || replayMode) return;
+  for (auto &track : tracks) {
+    if (track.physics == scenario::PHYSICS_HYBRID) {
+      track.focusAt(point);
+    }
   }
+}
+
+//--------------------------------------------------------------
+void ofApp::applyKey(int key) {
+  // Dijalankan di thread simulasi (lihat keyPressed): TIDAK boleh ada
+  // panggilan GL di sini (ofBackground dsb), itu tetap di keyPressed
 
   // Switch road type: '1' = CircleRoad, '2' = CurvedRoad
   if (key == '1') {
     currentRoadType = CIRCLE;
     // Regenerate semua track dengan CircleRoad
     for (auto &track : tracks) {
-      ofBackground(0);
       track.regenerateRoad(currentRoadType);
     }
   }
@@ -455,7 +1912,6 @@ void ofApp::keyPressed(int key) {
     currentRoadType = CURVED;
     // Regenerate semua track dengan CurvedRoad
     for (auto &track : tracks) {
-      ofBackground(0);
       track.regenerateRoad(currentRoadType);
     }
   }
@@ -476,37 +1932,29 @@ void ofApp::keyPressed(int key) {
 
   }
 
-  // Kontrol curveIntensity untuk track luar (outer)
+  // Kontrol curveIntensity: +/- track 0 (outer), ]/[ track 1 (middle), >/< track 2 (inner)
   if (key == '=' || key == '+') {  // '=' biasanya '+' tanpa shift
-    curveIntensityOuter += 0.1f;
-    if (!tracks.empty())tracks[0].curveIntensity = curveIntensityOuter;
-    
+    if (tracks.size() > 0) tracks[0].curveIntensity += 0.1f;
   }
 
   if (key == '-' || key == '_') {  // '_' biasanya '-' tanpa shift
-      curveIntensityOuter -= 0.1f;
-      if (!tracks.empty()) tracks[0].curveIntensity = curveIntensityOuter;
-      
+    if (tracks.size() > 0) tracks[0].curveIntensity -= 0.1f;
   }
 
   if (key == ']' || key == '}') {
-      curveIntensityMiddle += .1f;
-      if (!tracks.empty()) tracks[1].curveIntensity = curveIntensityMiddle;
+    if (tracks.size() > 1) tracks[1].curveIntensity += 0.1f;
   }
 
   if (key == '[' || key == '{') {
-      curveIntensityMiddle -= .1f;
-      if (!tracks.empty()) tracks[1].curveIntensity = curveIntensityMiddle;
+    if (tracks.size() > 1) tracks[1].curveIntensity -= 0.1f;
   }
 
   if (key == '.' || key == '>') {
-      curveIntensityInner += .1f;
-      if (!tracks.empty()) tracks[2].curveIntensity = curveIntensityInner;
+    if (tracks.size() > 2) tracks[2].curveIntensity += 0.1f;
   }
 
   if (key == ',' || key == '<') {
-      curveIntensityInner -= .1f;
-      if (!tracks.empty()) tracks[2].curveIntensity = curveIntensityInner;
+    if (tracks.size() > 2) tracks[2].curveIntensity -= 0.1f;
   }
 
   // Toggle visibility track outer dengan 'Z' atau 'z'
@@ -532,8 +1980,14 @@ void ofApp::keyPressed(int key) {
 
   // Reset simulasi dengan 'R' atau 'r'
   if (key == 'r' || key == 'R') {
+    stopRecording();
+    replayMode = false;
+    player.close();
     tracks.clear();  // Hapus semua track lama
-    setup();         // Buat ulang semua track, mobil, dan bezier
+    simStep = 0;
+    network.clear(); // Network di-generate ulang saat 'n' ditekan lagi
+    networkMode = false;
+    setupTracks();   // Buat ulang semua track dan mobil
   }
 
   // Toggle gradient mode untuk OUTER track dengan 'T' atau 't'
@@ -557,21 +2011,107 @@ void ofApp::keyPressed(int key) {
     }
   }
 
-  // Toggle TAB mode dengan tombol TAB (ASCII 9 atau '\t')
-  if (key == 9 || key == '\t') {
-    tabMode = !tabMode;  // Toggle inter-track bezier mode
+  // Track sebanyak apapun (scenario): pilih dengan panah atas/bawah, lalu
+  // 'B' toggle visibility dan 'G' toggle gradient track terpilih.
+  // Z/X/C dan T/Y/U tetap jalan pintas untuk track 0-2
+  if ((key == OF_KEY_UP || key == OF_KEY_DOWN) && !tracks.empty()) {
+    int n = (int)tracks.size();
+    selectedTrack = (std::min(selectedTrack, n - 1) + (key == OF_KEY_DOWN ? 1 : n - 1)) % n;
+    ofLogNotice("ofApp") << "Track terpilih: " << selectedTrack << " dari " << n;
   }
 
-  // Keluar dengan tombol 'q' atau 'Q'
-  if (key == 'q' || key == 'Q')
-    ofExit();
+  if (key == 'b' || key == 'B') {
+    if (selectedTrack < (int)tracks.size()) {
+      tracks[selectedTrack].visible = !tracks[selectedTrack].visible;
+    }
+  }
+
+  if (key == 'g' || key == 'G') {
+    if (selectedTrack < (int)tracks.size()) {
+      tracks[selectedTrack].gradientMode = !tracks[selectedTrack].gradientMode;
+    }
+  }
+
+  // Mulai/berhenti export telemetry dengan 'E' atau 'e'
+  if (key == 'e' || key == 'E') {
+    toggleTelemetry();
+  }
+
+  // Mulai/berhenti publish state ke shared memory dengan 'M' atau 'm'
+  if (key == 'm' || key == 'M') {
+    toggleStateExport();
+  }
+
+  // Simpan snapshot state semua track dengan 'K' atau 'k'
+  if (key == 'k' || key == 'K') {
+    saveSnapshot(ofToDataPath(snapshotFile));
+  }
+
+  // Load snapshot terakhir dengan 'L' atau 'l'
+  if (key == 'l' || key == 'L') {
+    stopRecording();
+    if (loadSnapshot(ofToDataPath(snapshotFile))) {
+      networkMode = false;
+      replayMode = false;
+      player.close();
+    }
+  }
+
+  // Mulai/berhenti merekam trajektori dengan 'V' atau 'v'
+  if (key == 'v' || key == 'V') {
+    if (recorder.isRecording()) {
+      stopRecording();
+    } else if (!replayMode && !networkMode) {
+      startRecording();
+    }
+  }
+
+  // Toggle replay rekaman terakhir dengan 'P' atau 'p'
+  if (key == 'p' || key == 'P') {
+    if (replayMode) {
+      replayMode = false;
+      player.close();
+    } else {
+      stopRecording();
+      replayMode = startReplay();
+    }
+  }
+
+  // Seek replay dengan panah kiri/kanan
+  if (replayMode && (key == OF_KEY_LEFT || key == OF_KEY_RIGHT)) {
+    uint64_t current = player.getCurrentStep();
+    uint64_t target = (key == OF_KEY_RIGHT) ? current + replaySeekSteps
+                                            : current - std::min<uint64_t>(current, replaySeekSteps);
+    if (player.seek(std::min(target, player.getLastStep()))) {
+      // Snapshot awal dimuat ulang supaya jumlah kendaraan sesuai sebelum di-set
+      loadSnapshot(ofToDataPath(trajectorySnapshotFile));
+      applyReplayFrame();
+    }
+  }
+
+  // Toggle network mode dengan 'N' atau 'n'
+  if (key == 'n' || key == 'N') {
+    networkMode = !networkMode;
+
+    // Bangun network sekali saja (saat pertama kali masuk network mode)
+    if (networkMode && !network.isFinalized()) {
+      RoadNetwork::buildGrid(network, networkCols, networkRows, networkCellsPerEdge);
+      network.generateGeometry(ofRectangle(0, 0, ofGetWidth(), ofGetHeight()));
+      network.spawnVehicles(networkNumCars, networkMaxV, networkProbSlow, (uint64_t)(ofRandom(1.0f) * 0xFFFFFFFF));
+    }
+  }
 }
 
 //--------------------------------------------------------------
 void ofApp::keyReleased(int key) {}
 
 //--------------------------------------------------------------
-void ofApp::mouseMoved(int x, int y) {}
+void ofApp::mouseMoved(int x, int y) {
+  if (focusFollowMouse) {
+    focusPoint = vec2(x, y);
+    focusMoved = true;
+  }
+}
 
 //--------------------------------------------------------------
 void ofApp::mouseDragged(int x, int y, int button) {}
@@ -598,111 +2138,465 @@ void ofApp::gotMessage(ofMessage msg) {}
 void ofApp::dragEvent(ofDragInfo dragInfo) {}
 
 //--------------------------------------------------------------
-ofPoint ofApp::getBezierPoint(float t, ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3) {
-	// Cubic bezier formula: B(t) = (1-t)³P0 + 3(1-t)²tP1 + 3(1-t)t²P2 + t³P3
-	float u = 1.0f - t;
-	float tt = t * t;
-	float uu = u * u;
-	float uuu = uu * u;
-	float ttt = tt * t;
+bool ofApp::saveSnapshot(const std::string& path) {
+  uint64_t startTime = ofGetElapsedTimeMicros();
+
+  std::vector<snapshot::SnapshotTrack> records;
+  records.reserve(tracks.size());
+  for (const auto &track : tracks) {
+    records.push_back(track.toSnapshotRecord());
+  }
+
+  // Array kendaraan ditulis langsung ke buffer file, lalu satu kali write
+  SnapshotWriter writer(simStep, (uint32_t)currentRoadType, records);
+  for (int i = 0; i < (int)tracks.size(); i++) {
+    tracks[i].writeSnapshotArrays(writer.getArrays(i));
+  }
 
-	ofPoint p;
-	p.x = uuu * p0.x + 3 * uu * t * p1.x + 3 * u * tt * p2.x + ttt * p3.x;
-	p.y = uuu * p0.y + 3 * uu * t * p1.y + 3 * u * tt * p2.y + ttt * p3.y;
+  if (!writer.save(path)) {
+    ofLogError("ofApp") << "Gagal menyimpan snapshot: " << path;
+    return false;
+  }
 
-	return p;
+  ofLogNotice("ofApp") << "Snapshot disimpan: " << path << " (" << writer.getByteSize()
+                       << " bytes, " << (ofGetElapsedTimeMicros() - startTime) / 1000.0 << " ms)";
+  return true;
 }
 
 //--------------------------------------------------------------
-// TAB MODE: Helper methods untuk inter-track bezier
+bool ofApp::loadSnapshot(const std::string& path) {
+  uint64_t startTime = ofGetElapsedTimeMicros();
+
+  SnapshotReader reader;
+  if (!reader.load(path)) {
+    ofLogError("ofApp") << "Snapshot tidak valid atau tidak ditemukan: " << path;
+    return false;
+  }
+
+  tracks.clear();
+  tracks.resize(reader.getTrackCount());
+  for (int i = 0; i < reader.getTrackCount(); i++) {
+    tracks[i].restoreFromSnapshot(reader.getTrack(i), reader.getArrays(i));
+  }
+
+  currentRoadType = (RoadType)std::min(reader.getRoadType(), (uint32_t)SPIRAL);
+  simStep = reader.getGlobalStep();
+  tracksMatchScenario = false;
+
+  ofLogNotice("ofApp") << "Snapshot dimuat: " << path << " (step " << simStep << ", "
+                       << (ofGetElapsedTimeMicros() - startTime) / 1000.0 << " ms)";
+  return true;
+}
+
 //--------------------------------------------------------------
+void ofApp::startRecording() {
+  // Track hybrid menambah kendaraan di awal region micro dan membuang di
+  // akhirnya tiap step; rekaman hanya mengenal kendaraan yang hilang
+  // (black hole). Scenario yang mengubah physics membuat ulang track dan
+  // menghentikan rekaman (reloadScenario), jadi cukup dicek di sini
+  for (const auto &track : tracks) {
+    if (track.physics == scenario::PHYSICS_HYBRID) {
+      ofLogWarning("ofApp") << "Rekaman trajektori tidak mendukung track hybrid, tidak direkam";
+      return;
+    }
+  }
+
+  // State awal (warna, jenis kendaraan, road) disimpan sebagai snapshot,
+  // file trajektori hanya berisi distance, velocity, id & lane per step.
+  // Id = urutan kendaraan saat ini, sama dengan urutan di snapshot
+  for (auto &track : tracks) {
+    for (size_t i = 0; i < track.traffic.size(); i++) {
+      track.traffic[i]->setRecordId((uint32_t)i);
+    }
+  }
+  if (!saveSnapshot(ofToDataPath(trajectorySnapshotFile))) return;
+
+  if (!recorder.start(ofToDataPath(trajectoryFile), (int)tracks.size())) {
+    ofLogError("ofApp") << "Gagal membuka file rekaman: " << trajectoryFile;
+    return;
+  }
+  ofLogNotice("ofApp") << "Rekaman dimulai di step " << simStep;
+}
 
 //--------------------------------------------------------------
-ofPoint ofApp::getCarPosition(TrackInstance& track, int carIndex) {
-  if (carIndex >= track.traffic.size()) {
-    return ofPoint(0, 0);
+void ofApp::stopRecording() {
+  if (!recorder.isRecording()) return;
+
+  recorder.stop();
+  ofLogNotice("ofApp") << "Rekaman selesai: " << recorder.getRecordedSteps() << " step, "
+                       << recorder.getBytesWritten() << " bytes, "
+                       << recorder.getDroppedSteps() << " step di-drop";
+}
+
+//--------------------------------------------------------------
+int ofApp::runGolden(const golden::Options &options) {
+  if (options.mode == golden::Options::INVALID || options.mode == golden::Options::NONE) {
+    ofLogError("golden") << options.error << "\n" << golden::usage();
+    return 2;
   }
 
-  auto& vehicle = track.traffic[carIndex];
-  float dist = vehicle->getDistance() * (track.road->getTotalLength() / track.maxCells);
+  // Scenario dari file, atau 3 ring bawaan (tidak bergantung scenario.json
+  // yang sering diedit)
+  scenario::Scenario sc = scenario::builtinScenario();
+  std::string error;
+  if (!options.scenarioPath.empty() && !scenario::loadScenario(ofToDataPath(options.scenarioPath), sc, error)) {
+    ofLogError("golden") << error;
+    return 2;
+  }
 
-  // Handle direction reversal
-  if (track.direction == -1) {
-    dist = track.road->getTotalLength() - dist;
+  // Check / bisect: seed & jumlah step dari file golden
+  const bool record = (options.mode == golden::Options::RECORD);
+  const std::string goldenPath = ofToDataPath(options.goldenPath);
+  golden::GoldenTrace expected;
+  if (!record && !expected.load(goldenPath, error)) {
+    ofLogError("golden") << error;
+    return 2;
+  }
+  const uint64_t seed = record ? options.seed : expected.getSeed();
+  const uint64_t steps = record ? options.steps : expected.getSteps();
+  const int trackCount = (int)sc.tracks.size();
+  if (!record && expected.getTrackCount() != trackCount) {
+    ofLogError("golden") << "Golden punya " << expected.getTrackCount() << " track, scenario " << trackCount
+                         << " (scenario berbeda?)";
+    return 2;
   }
 
-  vec2 pos = track.road->getPointAtDistance(dist);
-  return ofPoint(pos.x, pos.y);
+  // Setiap track dapat seed turunan seed run → spawn + randomize deterministik.
+  // --domains n: track dijalankan n proses (DomainCluster), hasil dikumpulkan
+  // di proses ini dan harus sama persis dengan satu proses
+  const bool decomposed = (options.domains > 1);
+  DomainCluster cluster;
+  if (decomposed) {
+    std::vector<RingDomainSpec> specs;
+    std::vector<std::string> workerArgs;
+    if (!options.scenarioPath.empty()) workerArgs = {"--scenario", options.scenarioPath};
+    if (!buildDomainSpecs(sc, seed, options.domains, specs, error) ||
+        !cluster.start(options.domains, seed, steps, ChildProcess::currentExecutable(options.executable.c_str()),
+                       workerArgs, error) ||
+        !cluster.setupTracks(specs, error)) {
+      ofLogError("golden") << error;
+      return 2;
+    }
+  } else {
+    tracks.clear();
+    tracks.resize(trackCount);
+    for (int t = 0; t < trackCount; t++) {
+      scenario::TrackConfig cfg = sc.tracks[t];
+      cfg.seed = golden::trackSeed(seed, t);
+      buildTrack(tracks[t], cfg, golden::HARNESS_WIDTH, golden::HARNESS_HEIGHT);
+    }
+  }
+
+  golden::GoldenTrace actual;
+  actual.reset(seed, trackCount);
+  std::vector<uint32_t> hashes;
+
+  for (uint64_t step = 0; step < steps; step++) {
+    simArena.reset();
+    if (decomposed && !cluster.step(step)) {
+      ofLogError("golden") << "Domain dibatalkan di step " << step << " (worker gagal / berhenti)";
+      return 2;
+    }
+
+    for (int t = 0; t < trackCount; t++) {
+      if (decomposed) {
+        const std::vector<DomainCluster::Sample> &samples = cluster.getSamples(t);
+        hashes.resize(samples.size());
+        for (size_t i = 0; i < samples.size(); i++) {
+          hashes[i] = golden::vehicleHash(samples[i].distance, samples[i].velocity, samples[i].lane);
+        }
+      } else {
+        TrackInstance &track = tracks[t];
+        track.update(simArena, simPool);
+
+        hashes.resize(track.traffic.size());
+        for (size_t i = 0; i < track.traffic.size(); i++) {
+          const Vehicle &v = *track.traffic[i];
+          hashes[i] = golden::vehicleHash(v.getDistance(), v.getVelocity(), v.getLane());
+        }
+      }
+
+      if (record) {
+        actual.addTrack(hashes.data(), (int)hashes.size());
+        continue;
+      }
+
+      if (golden::trackHash(hashes.data(), (int)hashes.size()) == expected.getTrackHash(step, t)) continue;
+
+      // Divergensi pertama: step + track (check), ditambah kendaraan (bisect)
+      ofLogError("golden") << "BERBEDA di step " << step << ", track " << t << " (semua step sebelumnya cocok)";
+      if (options.mode == golden::Options::BISECT) {
+        int expectedCount = expected.getVehicleCount(step, t);
+        const uint32_t *expectedHashes = expected.getVehicleHashes(step, t);
+        if (expectedCount != (int)hashes.size()) {
+          ofLogError("golden") << "  jumlah kendaraan " << hashes.size() << ", golden " << expectedCount;
+        }
+
+        int first = -1;
+        int diverged = 0;
+        int common = std::min(expectedCount, (int)hashes.size());
+        for (int i = 0; i < common; i++) {
+          if (hashes[i] != expectedHashes[i]) {
+            if (first < 0) first = i;
+            diverged++;
+          }
+        }
+        if (first >= 0) {
+          VehicleType type;
+          int lane;
+          float distance, velocity;
+          if (decomposed) {
+            const DomainCluster::Sample &v = cluster.getSamples(t)[first];
+            type = (VehicleType)v.type;
+            lane = v.lane;
+            distance = v.distance;
+            velocity = v.velocity;
+          } else {
+            const Vehicle &v = *tracks[t].traffic[first];
+            type = v.getType();
+            lane = v.getLane();
+            distance = v.getDistance();
+            velocity = v.getVelocity();
+          }
+          ofLogError("golden") << "  kendaraan pertama yang beda: #" << first << " (" << getVehicleSpec(type).name
+                               << ", lajur " << lane << ") distance " << ofToString(distance, 6) << " velocity "
+                               << ofToString(velocity, 6) << "; " << diverged << " dari " << common
+                               << " kendaraan beda";
+        }
+      } else {
+        ofLogError("golden") << "  jalankan --golden-bisect untuk kendaraan yang berbeda";
+      }
+      return 1;
+    }
+  }
+
+  if (decomposed && !cluster.finish(error)) {
+    ofLogError("golden") << error;
+    return 2;
+  }
+
+  if (record) {
+    if (!actual.save(goldenPath)) {
+      ofLogError("golden") << "Gagal menyimpan golden: " << goldenPath;
+      return 2;
+    }
+    ofLogNotice("golden") << "Golden disimpan: " << goldenPath << " (seed " << seed << ", " << steps << " step, "
+                          << trackCount << " track, " << options.domains << " domain)";
+    return 0;
+  }
+
+  ofLogNotice("golden") << "Cocok: " << steps << " step, " << trackCount << " track, " << options.domains
+                        << " domain (seed " << seed << ")";
+  return 0;
+}
+
+//--------------------------------------------------------------
+int ofApp::runDomainWorker(const golden::Options &options) {
+  // Scenario sama dengan koordinator; seed + jumlah step dari shared memory
+  scenario::Scenario sc = scenario::builtinScenario();
+  std::string error;
+  DomainCluster cluster;
+  std::vector<RingDomainSpec> specs;
+  if ((!options.scenarioPath.empty() && !scenario::loadScenario(ofToDataPath(options.scenarioPath), sc, error)) ||
+      !cluster.attach(options.domainChannel, options.domainRank, error) ||
+      !buildDomainSpecs(sc, cluster.getSeed(), cluster.getDomainCount(), specs, error) ||
+      !cluster.setupTracks(specs, error)) {
+    ofLogError("golden") << "Worker domain rank " << options.domainRank << ": " << error;
+    return 2;
+  }
+
+  for (uint64_t step = 0; step < cluster.getSteps(); step++) {
+    if (!cluster.step(step)) return 2;  // Dibatalkan: koordinator yang melaporkan
+  }
+  return 0;
+}
+
+//--------------------------------------------------------------
+bool ofApp::buildDomainSpecs(const scenario::Scenario &sc, uint64_t seed, int domainCount,
+                             std::vector<RingDomainSpec> &specs, std::string &error) {
+  specs.resize(sc.tracks.size());
+  for (size_t t = 0; t < sc.tracks.size(); t++) {
+    const scenario::TrackConfig &cfg = sc.tracks[t];
+    if (cfg.physics != scenario::PHYSICS_INTEGER || cfg.roadType >= (uint32_t)SPIRAL) {
+      error = "Track " + std::to_string(t) + " (" + cfg.name +
+              "): --domains hanya untuk physics integer di ring (bukan SpiralRoad)";
+      return false;
+    }
+
+    RingDomainSpec &spec = specs[t];
+    spec.maxCells = (uint32_t)std::max(1, cfg.maxCells);
+    spec.numLanes = std::max(1, cfg.numLanes);
+    spec.numCars = cfg.numCars;
+    spec.spacing = cfg.spacing;
+    std::copy(cfg.fleetMix.begin(), cfg.fleetMix.end(), spec.fleetMix);
+    spec.maxV = cfg.maxV;
+    spec.probSlow = cfg.probSlow;
+    spec.caInterval = std::max(1, cfg.caInterval);
+    spec.rules = cfg.rules;
+    spec.seed = golden::trackSeed(seed, (int)t);
+
+    if (!RingDomain::validate(spec, domainCount, error)) {
+      error = "Track " + std::to_string(t) + " (" + cfg.name + "): " + error;
+      return false;
+    }
+  }
+  return true;
 }
 
 //--------------------------------------------------------------
-bool ofApp::isInBlackHole(TrackInstance& track, int carIndex) {
-  if (carIndex >= track.traffic.size()) return false;
+void ofApp::toggleTelemetry() {
+  if (telemetryExporter.isRunning()) {
+    telemetryExporter.stop();
+    ofLogNotice("ofApp") << "Telemetry berhenti: " << telemetryExporter.getExports() << " export, "
+                         << telemetryExporter.getDroppedSamples() << " sampel di-drop";
+    return;
+  }
 
-  // Only check for SPIRAL road type
-  if (track.roadType != SPIRAL) return false;
+  std::string csvPath = ofToDataPath(telemetryCsvFile);
+  if (!telemetryExporter.start(csvPath, ofToDataPath(telemetryPromFile), telemetryIntervalMs)) {
+    ofLogError("ofApp") << "Gagal membuka file telemetry: " << csvPath;
+    return;
+  }
+  ofLogNotice("ofApp") << "Telemetry dimulai di step " << simStep << " → " << csvPath;
+}
+
+//--------------------------------------------------------------
+void ofApp::toggleStateExport() {
+  if (stateExporter.isRunning()) {
+    stateExporter.stop();
+    ofLogNotice("ofApp") << "State export berhenti: " << stateExporter.getPublishedSteps() << " step, "
+                         << stateExporter.getTruncatedSteps() << " step terpotong (slot penuh)";
+    return;
+  }
 
-  auto& vehicle = track.traffic[carIndex];
-  float dist = vehicle->getDistance() * (track.road->getTotalLength() / track.maxCells);
+  // Slot 2x kebutuhan saat ini (minimal 1 MB): jumlah kendaraan bisa
+  // bertambah lewat hot reload atau region hybrid tanpa membuat region baru
+  size_t bytes = sizeof(tj_state_slot) + tracks.size() * sizeof(tj_state_track) + TJ_STATE_ALIGN;
+  for (const auto &track : tracks) {
+    size_t bodyPointCount = 0;
+    for (const auto &vehicle : track.traffic) {
+      bodyPointCount += static_cast<const SedanCar *>(vehicle.get())->getBodyPoints().size();
+    }
+    bytes += SharedStateExporter::trackBytes(2 * track.traffic.size(), 2 * bodyPointCount);
+  }
+  bytes = std::max(bytes, (size_t)1 << 20);
 
-  if (track.direction == -1) {
-    dist = track.road->getTotalLength() - dist;
+  if (!stateExporter.start(stateExportName, bytes)) {
+    ofLogError("ofApp") << "Gagal membuat shared memory state export: " << stateExportName;
+    return;
   }
 
-  vec2 pos = track.road->getPointAtDistance(dist);
-  vec2 trackCenter(track.bounds.x + track.bounds.width / 2.0f,
-                   track.bounds.y + track.bounds.height / 2.0f);
-  float radius = glm::length(pos - trackCenter);
+  // Reader langsung melihat state saat ini, walau simulasi belum jalan
+  exportState();
+  ofLogNotice("ofApp") << "State export dimulai di step " << simStep << " → shared memory /" << stateExportName
+                       << " (" << 2 * stateExporter.getSlotBytes() / 1024 << " KB)";
+}
+
+//--------------------------------------------------------------
+void ofApp::exportState() {
+  stateExporter.beginStep(simStep, (uint32_t)tracks.size());
+  for (const auto &track : tracks) {
+    track.fillStateExport(stateExporter);
+  }
+  stateExporter.endStep();
+}
 
-  // Black hole threshold (same as existing draw method)
-  return (radius < 100.0f);
+//--------------------------------------------------------------
+void ofApp::recordStep() {
+  // Hanya salin float ke frame; encode + tulis disk di writer thread
+  TrajectoryFrame *frame = recorder.acquireFrame(simStep);
+  if (!frame) return;
+
+  for (const auto &track : tracks) {
+    frame->beginTrack();
+    for (const auto &vehicle : track.traffic) {
+      frame->add(vehicle->getDistance(), vehicle->getVelocity(), vehicle->getRecordId(), vehicle->getLane());
+    }
+  }
+  recorder.submitFrame(frame);
 }
 
 //--------------------------------------------------------------
-void ofApp::drawCarForTabMode(TrackInstance& track, int carIndex) {
-  if (carIndex >= track.traffic.size()) return;
+bool ofApp::startReplay() {
+  if (!player.open(ofToDataPath(trajectoryFile))) {
+    ofLogError("ofApp") << "Rekaman tidak valid atau tidak ditemukan: " << trajectoryFile;
+    return false;
+  }
+
+  // Warna, jenis kendaraan, dan road dari snapshot awal rekaman
+  if (!loadSnapshot(ofToDataPath(trajectorySnapshotFile))) {
+    player.close();
+    return false;
+  }
+
+  networkMode = false;
+  simulationStarted = true;
 
-  auto& vehicle = track.traffic[carIndex];
-  float dist = vehicle->getDistance() * (track.road->getTotalLength() / track.maxCells);
+  // open() sudah decode step pertama
+  applyReplayFrame();
+  return true;
+}
 
-  // Handle direction reversal
-  if (track.direction == -1) {
-    dist = track.road->getTotalLength() - dist;
+//--------------------------------------------------------------
+void ofApp::replayStep() {
+  // Di akhir rekaman: ulang dari awal (snapshot dimuat ulang untuk jumlah kendaraan)
+  if (!player.next()) {
+    if (!player.rewind() || !loadSnapshot(ofToDataPath(trajectorySnapshotFile))) {
+      replayMode = false;
+      return;
+    }
   }
 
-  vec2 pos = track.road->getPointAtDistance(dist);
-  vec2 tangent = track.road->getTangentAtDistance(dist);
-  float angle = ofRadToDeg(atan2(tangent.y, tangent.x));
+  applyReplayFrame();
+}
+
+void ofApp::applyReplayFrame() {
+  for (int i = 0; i < (int)tracks.size() && i < player.getTrackCount(); i++) {
+    tracks[i].applyReplayStep(player.getDistances(i), player.getVelocities(i), player.getIds(i), player.getLanes(i),
+                              player.getVehicleCount(i), simArena);
+  }
+  simStep = player.getCurrentStep();
+}
 
-  // Check black hole
-  vec2 carPos(pos.x, pos.y);
-  vec2 trackCenter(track.bounds.x + track.bounds.width / 2.0f,
-                   track.bounds.y + track.bounds.height / 2.0f);
-  float radius = glm::length(carPos - trackCenter);
-  bool inBlackHole = false;
+//--------------------------------------------------------------
+// TAB MODE: Helper methods untuk inter-track bezier
+//--------------------------------------------------------------
 
-  if (track.roadType == SPIRAL && radius < 100.0f) {
-    inBlackHole = true;
+//--------------------------------------------------------------
+ofPoint ofApp::getCarPosition(const TrackSnapshot& track, int carIndex) const {
+  if (carIndex >= track.size()) {
+    return ofPoint(0, 0);
   }
 
+  vec2 pos = track.position[carIndex];
+  return ofPoint(pos.x, pos.y);
+}
+
+//--------------------------------------------------------------
+bool ofApp::isInBlackHole(const TrackSnapshot& track, int carIndex) const {
+  if (carIndex >= track.size()) return false;
+
+  // Dihitung thread simulasi (TrackInstance::isInBlackHole, SPIRAL saja)
+  return track.blackHole[carIndex] != 0;
+}
+
+//--------------------------------------------------------------
+void ofApp::drawCarForTabMode(const TrackSnapshot& track, int carIndex) {
+  if (carIndex >= track.size()) return;
+
   // Skip drawing vehicle if gradient mode is active
   if (track.gradientMode) {
     return;
   }
 
   // Draw car
-  if (inBlackHole) {
-    ofSetColor(0, 0, 0);  // Black color for black hole
-    vehicle->draw(pos.x, pos.y, angle);
-  } else {
-    vehicle->draw(pos.x, pos.y, angle);
-  }
+  drawSnapshotCar(track, carIndex);
 }
 
 //--------------------------------------------------------------
 ofPoint ofApp::calculateControlPoint(ofPoint start, ofPoint end, ofPoint center,
                                      int direction, float wobbleTime, int carIndex,
-                                     float curveIntensity, float curveAngle) {
+                                     float curveIntensity, float curveAngle) const {
   float angleToTarget = atan2(end.y - start.y, end.x - start.x);
   float radius = glm::length(vec2(end.x, end.y) - vec2(center.x, center.y));
 
@@ -718,148 +2612,123 @@ ofPoint ofApp::calculateControlPoint(ofPoint start, ofPoint end, ofPoint center,
 }
 
 //--------------------------------------------------------------
-void ofApp::drawBezierSegment(ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3,
-                               vec3 col, int segments) {
-  ofPolyline bezierPolyline;
-
-  for (int k = 0; k <= segments; k++) {
-    float t = (float)k / segments;
-    ofPoint p = getBezierPoint(t, p0, p1, p2, p3);
-    bezierPolyline.addVertex(p.x, p.y);
-  }
-
-  ofSetColor(col.r * 255, col.g * 255, col.b * 255, 150);
-  ofSetLineWidth(3);
-  bezierPolyline.draw();
+void ofApp::addBezierSegment(BezierBatch& batch, ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3,
+                             vec3 col, int segments) const {
+  // Masuk batch worker (digabung + digambar sekaligus di akhir draw())
+  batch.addCurve(vec2(p0.x, p0.y), vec2(p1.x, p1.y), vec2(p2.x, p2.y), vec2(p3.x, p3.y),
+                 ofFloatColor(col.r, col.g, col.b, 150 / 255.0f), 3, segments);
 }
 
 //--------------------------------------------------------------
-void ofApp::drawContinuousBezier(ofPoint p0, ofPoint p1, ofPoint p2, ofPoint center,
-                                  vec3 col, float wobbleTime, int carIndex,
-                                  TrackInstance& outerTrack, TrackInstance& middleTrack, TrackInstance& innerTrack) {
-  // Calculate control points for smooth S-curve
-  // Segment 1: Outer (p0) → Middle (p1)
-  // Control point 1 uses OUTER track, Control point 2 uses MIDDLE track
-  ofPoint cp1_1 = calculateControlPoint(p0, p1, center, 1, wobbleTime, carIndex,
-                                        outerTrack.curveIntensity, outerTrack.curveAngle1);
-  ofPoint cp1_2 = calculateControlPoint(p1, p0, center, -1, wobbleTime, carIndex,
-                                        middleTrack.curveIntensity, middleTrack.curveAngle2);
-
-  // Segment 2: Middle (p1) → Inner (p2)
-  // TAB MODE: Both control points use MIDDLE track (inner curve intensity only affects inner loop!)
-  ofPoint cp2_1 = calculateControlPoint(p1, p2, center, 1, wobbleTime, carIndex,
-                                        middleTrack.curveIntensity, middleTrack.curveAngle1);
-  ofPoint cp2_2 = calculateControlPoint(p2, p1, center, -1, wobbleTime, carIndex,
-                                        middleTrack.curveIntensity, middleTrack.curveAngle2);
+void ofApp::getInterTrackCounts(const RenderSnapshot& frame, int& chainCount, int& loopCount) {
+  chainCount = 0;
+  loopCount = 0;
+
+  // Rantai = semua track visible, berurutan dari luar ke dalam (urutan
+  // scenario). Track hidden dilewati, jadi kombinasi visibility apapun jalan.
+  // Track hybrid ikut dengan kendaraan di region micro: jumlahnya berubah
+  // tiap step (masuk / keluar region), jadi chainCount (minimum di bawah)
+  // ikut berubah dan indeks mobil bisa bergeser saat kendaraan keluar,
+  // sama seperti mobil yang dihapus black hole SpiralRoad
+  tabChain.clear();
+  for (int t = 0; t < (int)frame.tracks.size(); t++) {
+    // Track physics macro tidak punya kendaraan untuk dirantai
+    if (frame.tracks[t].visible && !frame.tracks[t].macro) {
+      tabChain.push_back(t);
+    }
+  }
+  if (tabChain.empty()) return;
 
-  // Draw segment 1: outer → middle
-  drawBezierSegment(p0, cp1_1, cp1_2, p1, col, 100);
+  // Indeks mobil yang ada di SEMUA track rantai
+  chainCount = frame.tracks[tabChain[0]].size();
+  for (int t : tabChain) {
+    chainCount = std::min(chainCount, frame.tracks[t].size());
+  }
 
-  // Draw segment 2: middle → inner
-  drawBezierSegment(p1, cp2_1, cp2_2, p2, col, 100);
+  // Track visible terdalam: loop sesama mobilnya, need at least 2 cars
+  int numInner = frame.tracks[tabChain.back()].size();
+  loopCount = (numInner >= 2) ? numInner : 0;
 }
 
 //--------------------------------------------------------------
-void ofApp::drawInterTrackBezier(float wobbleTime) {
-  // REQUIREMENT: Need 3 tracks (outer, middle, inner)
-  if (tracks.size() < 3) return;
-
-  TrackInstance& outerTrack = tracks[0];
-  TrackInstance& middleTrack = tracks[1];
-  TrackInstance& innerTrack = tracks[2];
+bool ofApp::chainHasBlackHole(const RenderSnapshot& frame, int carIndex) const {
+  for (int t : tabChain) {
+    if (isInBlackHole(frame.tracks[t], carIndex)) return true;
+  }
+  return false;
+}
 
+//--------------------------------------------------------------
+void ofApp::buildInterTrackGeometry(BezierBatch& batch, const RenderSnapshot& frame, int begin, int end,
+                                    int chainCount, float wobbleTime) const {
   // Get common center point (screen center)
   float w = ofGetWidth();
   float h = ofGetHeight();
   ofPoint centerPoint(w / 2, h / 2);
 
-  // CASE 1: All tracks visible - draw outer → middle → inner
-  if (outerTrack.visible && middleTrack.visible && innerTrack.visible) {
-    // Determine max cars to process
-    int maxCars = std::min({
-      (int)outerTrack.traffic.size(),
-      (int)middleTrack.traffic.size(),
-      (int)innerTrack.traffic.size()
-    });
-
-    // Loop through cars by index
-    for (int i = 0; i < maxCars; i++) {
-      ofPoint outerPos = getCarPosition(outerTrack, i);
-      ofPoint middlePos = getCarPosition(middleTrack, i);
-      ofPoint innerPos = getCarPosition(innerTrack, i);
-
-      // Skip if any car is in black hole
-      if (isInBlackHole(outerTrack, i) ||
-          isInBlackHole(middleTrack, i) ||
-          isInBlackHole(innerTrack, i)) {
-        continue;
-      }
-
-      vec3 col = outerTrack.traffic[i]->getColor();
-
-      // Draw continuous bezier: outer → middle → inner
-      drawContinuousBezier(outerPos, middlePos, innerPos, centerPoint, col, wobbleTime, i,
-                          outerTrack, middleTrack, innerTrack);
-
-      // Draw all cars
-      drawCarForTabMode(outerTrack, i);
-      drawCarForTabMode(middleTrack, i);
-      drawCarForTabMode(innerTrack, i);
+  const int links = (int)tabChain.size() - 1;  // Segmen per mobil
+
+  // Indeks [0, chainCount) = rantai antar track, sisanya = inner loop.
+  // Biaya O(track x mobil): tiap mobil satu lintasan di rantai, posisi
+  // langsung dari array snapshot per track
+  int chainEnd = std::min(end, chainCount);
+  for (int i = begin; i < chainEnd; i++) {
+    // Skip if any car is in black hole
+    if (chainHasBlackHole(frame, i)) continue;
+
+    const TrackSnapshot& first = frame.tracks[tabChain[0]];
+    vec3 col = first.color[i];
+    ofPoint from = getCarPosition(first, i);
+
+    // Bezier bersambung: track visible k → k + 1 (ujung segmen = awal segmen berikutnya)
+    for (int k = 0; k < links; k++) {
+      const TrackSnapshot& a = frame.tracks[tabChain[k]];
+      const TrackSnapshot& b = frame.tracks[tabChain[k + 1]];
+      ofPoint to = getCarPosition(b, i);
+
+      // Control point 1 dari track asal, control point 2 dari track tujuan.
+      // Track terdalam: curve intensity-nya hanya untuk inner loop, jadi
+      // segmen terakhir memakai track asal untuk kedua control point
+      const TrackSnapshot& c2 = (k + 1 == links) ? a : b;
+      ofPoint cp1 = calculateControlPoint(from, to, centerPoint, 1, wobbleTime, i,
+                                          a.curveIntensity, a.curveAngle1);
+      ofPoint cp2 = calculateControlPoint(to, from, centerPoint, -1, wobbleTime, i,
+                                          c2.curveIntensity, c2.curveAngle2);
+
+      addBezierSegment(batch, from, cp1, cp2, to, col, bezierMaxSegments);
+      from = to;
     }
-
-    // Draw inner track loop (sesama mobil inner)
-    drawInnerTrackLoop(innerTrack, centerPoint, wobbleTime);
   }
-  // CASE 2: Outer hidden - draw only middle → inner
-  else if (!outerTrack.visible && middleTrack.visible && innerTrack.visible) {
-    int maxCars = std::min({
-      (int)middleTrack.traffic.size(),
-      (int)innerTrack.traffic.size()
-    });
-
-    for (int i = 0; i < maxCars; i++) {
-      ofPoint middlePos = getCarPosition(middleTrack, i);
-      ofPoint innerPos = getCarPosition(innerTrack, i);
-
-      if (isInBlackHole(middleTrack, i) || isInBlackHole(innerTrack, i)) {
-        continue;
-      }
 
-      vec3 col = middleTrack.traffic[i]->getColor();
+  // Inner track loop (sesama mobil track visible terdalam)
+  if (end > chainCount) {
+    buildInnerTrackLoop(batch, frame.tracks[tabChain.back()], centerPoint, wobbleTime,
+                        std::max(begin, chainCount) - chainCount, end - chainCount);
+  }
+}
 
-      // Draw single segment: middle → inner
-      // TAB MODE: Both control points use MIDDLE track (inner curve intensity only affects inner loop!)
-      ofPoint cp1 = calculateControlPoint(middlePos, innerPos, centerPoint, 1, wobbleTime, i,
-                                         middleTrack.curveIntensity, middleTrack.curveAngle1);
-      ofPoint cp2 = calculateControlPoint(innerPos, middlePos, centerPoint, -1, wobbleTime, i,
-                                         middleTrack.curveIntensity, middleTrack.curveAngle2);
+//--------------------------------------------------------------
+void ofApp::drawInterTrackCars(const RenderSnapshot& frame) {
+  int chainCount, loopCount;
+  getInterTrackCounts(frame, chainCount, loopCount);
 
-      drawBezierSegment(middlePos, cp1, cp2, innerPos, col, 100);
+  // Mobil hanya digambar untuk indeks yang punya bezier (bukan di black hole)
+  for (int i = 0; i < chainCount; i++) {
+    if (chainHasBlackHole(frame, i)) continue;
 
-      // Draw only middle and inner cars (outer is hidden)
-      drawCarForTabMode(middleTrack, i);
-      drawCarForTabMode(innerTrack, i);
+    for (int t : tabChain) {
+      drawCarForTabMode(frame.tracks[t], i);
     }
-
-    // Draw inner track loop (sesama mobil inner)
-    drawInnerTrackLoop(innerTrack, centerPoint, wobbleTime);
-  }
-  // CASE 3 & 4: Other combinations (not implemented yet)
-  else {
-    // For now, don't draw anything if other tracks are hidden
-    // TODO: Handle X and C key presses later
   }
 }
 
 //--------------------------------------------------------------
-void ofApp::drawInnerTrackLoop(TrackInstance& innerTrack, ofPoint centerPoint, float wobbleTime) {
-  if (!innerTrack.visible) return;
-
-  int numCars = (int)innerTrack.traffic.size();
-  if (numCars < 2) return;  // Need at least 2 cars to make a loop
+void ofApp::buildInnerTrackLoop(BezierBatch& batch, const TrackSnapshot& innerTrack, ofPoint centerPoint,
+                                float wobbleTime, int begin, int end) const {
+  int numCars = innerTrack.size();
 
   // Loop through each car and draw bezier to the next car (with wraparound)
-  for (int i = 0; i < numCars; i++) {
+  for (int i = begin; i < end; i++) {
     int nextIndex = (i + 1) % numCars;  // Wrap around to 0 for last car
 
     // Skip if either car is in black hole
@@ -872,7 +2741,7 @@ void ofApp::drawInnerTrackLoop(TrackInstance& innerTrack, ofPoint centerPoint, f
     ofPoint nextPos = getCarPosition(innerTrack, nextIndex);
 
     // Use current car's color
-    vec3 col = innerTrack.traffic[i]->getColor();
+    vec3 col = innerTrack.color[i];
 
     // Calculate control points for smooth curve
     ofPoint cp1 = calculateControlPoint(currentPos, nextPos, centerPoint, 1, wobbleTime, i,
@@ -880,7 +2749,7 @@ void ofApp::drawInnerTrackLoop(TrackInstance& innerTrack, ofPoint centerPoint, f
     ofPoint cp2 = calculateControlPoint(nextPos, currentPos, centerPoint, -1, wobbleTime, i,
                                         innerTrack.curveIntensity, innerTrack.curveAngle2);
 
-    // Draw bezier segment: current car → next car
-    drawBezierSegment(currentPos, cp1, cp2, nextPos, col, 100);
+    // Bezier segment: current car → next car
+    addBezierSegment(batch, currentPos, cp1, cp2, nextPos, col, bezierMaxSegments);
   }
 }
@@ -2,13 +2,43 @@
 
 #include "entities/SedanCar.h"
 #include "entities/Vehicle.h"
+#include "entities/VehicleTypes.h"
+#include "io/GoldenTrace.h"
+#include "io/ScenarioFile.h"
+#include "io/SharedStateExporter.h"
+#include "io/SimulationSnapshot.h"
+#include "io/TelemetryExporter.h"
+#include "io/TrajectoryPlayer.h"
+#include "io/TrajectoryRecorder.h"
+#include "network/RoadNetwork.h"
+#include "render/BezierBatch.h"
 #include "ofMain.h"
 #include "road/CircleRoad.h"
 #include "road/CurvedRoad.h"
 #include "road/PerlinNoiseRoad.h"
 #include "road/Road.h"
 #include "road/SpiralRoad.h"
+#include "simulation/CellTransmission.h"
+#include "simulation/CounterRng.h"
+#include "simulation/DomainCluster.h"
+#include "simulation/HybridRegion.h"
+#include "simulation/IntegerNaSch.h"
+#include "simulation/RenderSnapshot.h"
+#include "simulation/SegmentFollower.h"
+#include "simulation/SparseOccupancy.h"
+#include "simulation/SpawnSequence.h"
+#include "simulation/TrafficStats.h"
+#include "strategies/LaneChangeRule.h"
+#include "util/AllocCounter.h"
+#include "util/FrameArena.h"
+#include "util/SpscQueue.h"
+#include "util/TripleBuffer.h"
+#include "util/WorkerPool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 
 using glm::vec2;
@@ -25,9 +55,12 @@ public:
     SPIRAL         // Spiral in-out continuous
   };
 
+  ~ofApp();
+
   void setup();
   void update();
   void draw();
+  void exit();
 
   void keyPressed(int key);
   void keyReleased(int key);
@@ -41,17 +74,40 @@ public:
   void dragEvent(ofDragInfo dragInfo);
   void gotMessage(ofMessage msg);
 
+  // Golden trajectory harness tanpa jendela (main.cpp, io/GoldenTrace.h).
+  // Exit code: 0 = cocok / golden tersimpan, 1 = berbeda, 2 = error
+  int runGolden(const golden::Options& options);
+
+  // Proses worker --golden-* --domains n (dijalankan DomainCluster). Exit code 0 / 2
+  int runDomainWorker(const golden::Options& options);
+
 private:
+  // Posisi mobil yang sudah di-resolve dari road (sekali per step per mobil)
+  struct CarFrame {
+    vec2 position;   // Titik kepala di lajur (koordinat layar)
+    vec2 tangent;    // Arah road di posisi kepala
+    vec3 color;
+    bool blackHole;  // Di GAP area SpiralRoad
+  };
+
   // Struct to hold simulation instance
   struct TrackInstance {
     std::shared_ptr<Road> road;  // Gunakan Road base class
     RoadType roadType;            // Tipe road untuk cek SpiralRoad behavior
     ofRectangle bounds;          // Simpan bounds untuk regenerate road
+    scenario::PerlinConfig perlin;  // Bentuk PerlinNoiseRoad (scenario "perlin*")
     std::vector<std::shared_ptr<Vehicle>> traffic;
-    std::vector<int> grid;
+    std::vector<int> grid;  // numLanes * maxCells, lajur l mulai di grid[l * maxCells]
+    static const int GRID_WALL = 0x7fffffff;  // Cell terisi tanpa kendaraan (ujung region hybrid)
+    // Road sangat panjang: occupancy per kendaraan sebagai ganti grid
+    // (scenario "occupancy", diputuskan di setup())
+    scenario::Occupancy occupancyMode = scenario::OCCUPANCY_AUTO;
+    bool sparseOccupancy = false;
+    SparseOccupancy occupancy;
     int maxCells;
     float maxV;  // Kecepatan maksimal untuk track ini (normal mode)
     float spiralMaxV;  // Kecepatan maksimal khusus untuk SpiralRoad
+    float probSlow;    // Probabilitas random braking track (sebelum skala jenis kendaraan)
     int numLinesPerCar;  // Jumlah garis per mobil untuk track ini
     float curveIntensity; // Intensitas kelengkungan garis radial
     float curveAngle1;    // Angle offset untuk P1 (dalam radian)
@@ -61,16 +117,139 @@ private:
     bool drawFromCenter;  // true: center→car, false: car→center
     bool gradientMode;    // true: white→dark gradient, hide cars
 
-    // Untuk SpiralRoad: daftar indeks vehicle yang harus dihapus
-    std::vector<int> vehiclesToRemove;
+    // Multi-lane
+    int numLanes;                       // Jumlah lajur (1 = single-lane)
+    float laneWidth;                    // Jarak antar lajur di layar (pixels)
+    LaneChangeRule laneRule;            // Aturan pindah lajur (symmetric/asymmetric)
+    std::vector<int8_t> laneDecisions;  // Buffer keputusan lane-change (pass 1)
+    CounterRng rng;                     // Random generator per track (berbasis counter)
+    uint64_t stepCount = 0;             // Nomor step simulasi track ini
+
+    // Komposisi jenis kendaraan (bobot per VehicleType, tidak harus total 1)
+    std::array<float, VEHICLE_TYPE_COUNT> fleetMix = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+    // SpiralRoad: ada mobil di black hole step ini (carFrames[i].blackHole),
+    // dihapus di awal step berikutnya
+    bool removeBlackHoles = false;
+
+    // Telemetry: sampel step terakhir (density, flow di detectorCell,
+    // velocity Welford, fraksi berhenti), diisi tiap update()
+    float detectorCell = 0.0f;
+    TrackSample telemetry;
+
+    // Cache posisi mobil step ini (indeks = indeks traffic). Dipakai
+    // black hole, body kepala, dan snapshot render, jadi road hanya
+    // di-lookup SEKALI per mobil per step
+    std::vector<CarFrame> carFrames;
+    bool carFramesValid = false;  // false setelah road/kendaraan diganti di luar step
+
+    // Distance segment body semua kendaraan (urutan = traffic), di-update
+    // sekaligus per step oleh kernel SegmentFollower
+    SegmentFollower bodies;
+
+    // Model pergerakan (scenario "physics")
+    scenario::Physics physics = scenario::PHYSICS_FLOAT;
+
+    // Physics integer: state kendaraan di IntegerNaSch, traffic hanya
+    // salinan distance / velocity untuk render, body, telemetry. Satu step
+    // CA tiap caInterval step simulasi, di antaranya distance di-interpolasi.
+    // Tanpa lane change
+    int caInterval = 1;
+    NaSchRules rules;        // Varian aturan CA (VDR, slow-to-start, anticipation)
+    int caPhase = 0;         // Step simulasi sejak step CA terakhir
+    bool caSynced = false;   // false → IntegerNaSch diisi ulang dari traffic di update()
+    IntegerNaSch ca;
+
+    // Physics macro: traffic kosong, density per cell CTM. Digambar sebagai
+    // segmen road; titik batas bin dihitung ulang saat road berubah
+    CellTransmission ctm;
+    float waveSpeed = 0.0f;
+    int ctmCellLength = 0;
+    std::vector<vec2> densityPoints;  // Bin + 1 titik centreline
+    bool densityPointsValid = false;
+
+    // Physics hybrid: CTM di seluruh ring, traffic (NaSch float) hanya di
+    // microRegion. Handoff di batas region lewat credit:
+    // - entryCredit: kendaraan dari cell entry yang menunggu di-spawn
+    // - exitCredit:  kendaraan yang masih diterima cell exit; < 1 → dinding
+    //   di grid tepat di ujung region sampai receiving CTM cukup
+    // Grid hanya di-reset di region + margin, jadi biaya per step = jumlah
+    // kendaraan micro + cell CTM
+    HybridRegion microRegion;
+    int microBegin = 0;   // Scenario (cell NaSch)
+    int microLength = 0;
+    float entryCredit = 0.0f;
+    float exitCredit = 0.0f;
+    float entrySpeed = 0.0f;     // Kecepatan cell entry step ini (kendaraan baru)
+    bool exitBlocked = false;
+    uint32_t handoffSerial = 0;  // Indeks CounterRng kendaraan dari density
+    // Kendaraan yang keluar region, dipakai ulang saat spawn (tanpa alokasi)
+    std::array<std::vector<std::shared_ptr<Vehicle>>, VEHICLE_TYPE_COUNT> spareVehicles;
 
     // Helper to update this track
     void setup(ofRectangle bounds, int numCars, int spacing, float maxV, float spiralMaxV,
                float probSlow, int maxCells, RoadType roadType,
-               int numLinesPerCar, float curveIntensity, float curveAngle1, float curveAngle2, int direction);
-    void update();
-    void draw(ofPoint (bezierHelper)(float, ofPoint, ofPoint, ofPoint, ofPoint), float wobbleTime, bool gradientMode);
+               int numLinesPerCar, float curveIntensity, float curveAngle1, float curveAngle2, int direction,
+               int numLanes = 1, float laneWidth = 30.0f,
+               int segmentsPerCar = SegmentFollower::DEFAULT_SEGMENTS, uint64_t seed = 0);
+    void update(FrameArena& scratch, WorkerPool& pool);
+    // Hitung ulang carFrames dari distance kendaraan saat ini
+    void resolveCarFrames();
+
+    // Salin car frame, velocity, body point + parameter render ke snapshot
+    void fillSnapshot(TrackSnapshot& out);
+    // Distance, velocity, lajur, warna, body point kendaraan → slot state export
+    void fillStateExport(SharedStateExporter& out) const;
     void regenerateRoad(RoadType roadType);  // Switch road type
+    void rebuildGrid();                       // Reset + map semua kendaraan ke grid lajurnya (atau occupancy)
+    void updateBodies(FrameArena& scratch);   // Segment follower + body points dari distance kepala
+    // Physics integer: step CA / interpolasi → distance & velocity traffic
+    void updateIntegerPhysics(float* distanceBefore, float* distanceAfter, float* velocity);
+    void syncIntegerPhysics();  // IntegerNaSch dari traffic (urutan lajur + posisi)
+
+    // Physics macro: CTM dengan numCars per lajur tersebar di [0, numCars * spacing)
+    void setupMacro(int numCars, int spacing);
+    float macroFreeSpeed() const;      // maxV / spiralMaxV sesuai roadType
+    float macroWaveSpeed() const;      // waveSpeed, 0 → dari panjang kendaraan & probSlow
+    float macroVehicleLength() const;  // Rata-rata berbobot fleetMix (cell)
+    void fillDensitySnapshot(TrackSnapshot& out);  // Bin density (region micro: -1)
+    void updateDensityPoints();
+    static const int MAX_DENSITY_BINS = 512;  // Segmen render per track
+    static const int LANE_CHANGE_MIN_CHUNK = 2048;  // Kendaraan minimal per worker (decide lane change)
+
+    // Physics hybrid
+    void setupHybrid();                                 // Setelah setup() float: region dari scenario
+    void setMicroRegion(int firstCell, int cellCount);  // Konversi kendaraan ↔ density di cell yang berpindah
+    void focusAt(vec2 point);                           // Region berpusat di titik road terdekat
+    void beginHybridStep();                             // Flow CTM, credit, grid region, spawn di entry
+    void finishHybridStep();                            // Kendaraan keluar → CTM, telemetry micro + macro
+    bool spawnAtEntry(int lane);
+    void addHandoffVehicle(float headDistance, float velocity, int lane, VehicleType type);
+    VehicleType pickHandoffType() const;  // Acak dari spareVehicles (kosong: fleetMix), dari handoffSerial
+    void clearGridWindow();               // Grid region + margin (track hybrid)
+    int cellOf(float distance) const;     // Cell CTM
+
+    // Replay: buang kendaraan yang hilang dari rekaman, set distance, velocity
+    // & lane (tanpa simulasi), lalu update body
+    void applyReplayStep(const float* distances, const float* velocities, const uint32_t* ids,
+                         const uint8_t* lanes, int count, FrameArena& scratch);
+
+    // Snapshot: salin parameter track (tanpa array kendaraan) / restore semua state
+    snapshot::SnapshotTrack toSnapshotRecord() const;
+    void writeSnapshotArrays(const SnapshotWriter::Arrays& out) const;
+    void restoreFromSnapshot(const snapshot::SnapshotTrack& record, const SnapshotReader::Arrays& in);
+
+    // Cell distance → distance di road (pixels), sudah termasuk direction
+    float toWorldDistance(float cellDist) const;
+
+    // Posisi di road untuk lajur tertentu (offset dari centreline via tangent)
+    vec2 getLanePoint(float worldDist, int lane) const;
+
+    // Geser titik centreline ke lajur (tangent = arah road di titik itu)
+    vec2 offsetToLane(vec2 point, vec2 tangent, int lane) const;
+
+    // SpiralRoad: posisi di GAP area (radius < 100 px dari pusat track)
+    bool isInBlackHole(vec2 pos) const;
   };
 
   // Tracks
@@ -79,75 +258,161 @@ private:
   // Current road type
   RoadType currentRoadType = CIRCLE;  // Default: CircleRoad
 
-  // Jumlah mobil per track
-  int numCarsOuter = 20;   // Track luar
-  int numCarsMiddle = 20;   // Track tengah
-  int numCarsInner = 20;    // Track dalam
-
-  // Ukuran track dalam cells per track (semakin besar track, semakin banyak cells)
-  int maxCellsOuter = 1500;   // Track luar - lebih panjang
-  int maxCellsMiddle = 1500;  // Track tengah
-  int maxCellsInner = 1500;   // Track dalam - lebih pendek
-
-  // Kecepatan maksimal per track (track lebih besar = lebih cepat)
-  float maxVOuter = 20.0f;    // Track luar - paling cepat
-  float maxVMiddle = 6.0f;   // Track tengah - sedang
-  float maxVInner = 5.0f;    // Track dalam - paling lambat
-
-  // Kecepatan maksimal khusus untuk SpiralRoad
-  float spiralMaxVOuter = .7f;    
-  float spiralMaxVMiddle = 1.f;   
-  float spiralMaxVInner = 1.5f;    
-
-  // Jumlah garis radial per mobil (per track)
-  int numLinesPerCarOuter = 5;    // Track luar - lebih banyak garis
-  int numLinesPerCarMiddle = 5;   // Track tengah
-  int numLinesPerCarInner = 5;    // Track dalam - lebih sedikit garis
-
-  // Intensitas kelengkungan garis radial per track
-  float curveIntensityOuter = .0f;   // Track luar - lurus
-  float curveIntensityMiddle = 0.f;  // Track tengah - sedang melengkung
-  float curveIntensityInner = 0.f;   // Track dalam - lebih melengkung
-
-  // Angle offset untuk P1 per track (dalam radian)
-  float curveAngle1Outer = HALF_PI / 2;      // Track luar - 45 derajat
-  float curveAngle1Middle = HALF_PI / 4;     // Track tengah
-  float curveAngle1Inner = HALF_PI;      // Track dalam
-
-  // Angle offset untuk P2 per track (dalam radian)
-  float curveAngle2Outer = -HALF_PI;         // Track luar - -90 derajat
-  float curveAngle2Middle = -HALF_PI /2;        // Track tengah
-  float curveAngle2Inner = -HALF_PI / 2;         // Track dalam
-
-  // Arah putaran per track: 1 = counter-clockwise, -1 = clockwise
-  int directionOuter = 1;     // Track luar - counter-clockwise
-  int directionMiddle = -1;   // Track tengah - clockwise (berlawanan)
-  int directionInner = 1;     // Track dalam - counter-clockwise
-
-  // Probabilitas random braking per track (semakin kecil, semakin lancar)
-  float probSlowOuter = 0.03f;   // Track luar
-  float probSlowMiddle = 0.03f;  // Track tengah
-  float probSlowInner = 0.03f;   // Track dalam
-
-  // Bezier curve helper
-  static ofPoint getBezierPoint(float t, ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3);
+  // Scenario: daftar track + semua parameternya (io/ScenarioFile.h).
+  // Dimuat saat setup(), hot reload saat file berubah (dicek thread simulasi)
+  std::string scenarioFile = "scenario.json";  // Relatif ke folder data/
+  scenario::Scenario activeScenario;           // Config yang dipakai tracks saat ini
+  ScenarioWatcher scenarioWatcher;
+  bool tracksMatchScenario = false;  // false setelah load snapshot (tracks dari file lain)
+  int selectedTrack = 0;             // Track yang dikontrol 'B' / 'G' (panah atas/bawah)
+  void loadScenario();    // File scenario, atau 3 ring bawaan kalau gagal
+  bool reloadScenario();  // Hot reload: hanya track yang berubah dibuat ulang
+  void buildTrack(TrackInstance& t, const scenario::TrackConfig& cfg);  // Bounds dari ukuran jendela
+  void buildTrack(TrackInstance& t, const scenario::TrackConfig& cfg, float width, float height);
+  void applyTrackSettings(TrackInstance& t, const scenario::TrackConfig& cfg);  // Render + lane change
+
+  // Track scenario (seed run → seed track) sebagai RingDomainSpec; false kalau
+  // ada track yang tidak bisa dipecah ke domainCount proses
+  static bool buildDomainSpecs(const scenario::Scenario& sc, uint64_t seed, int domainCount,
+                               std::vector<RingDomainSpec>& specs, std::string& error);
+
+  // Semua garis bezier satu frame → satu VBO (lihat BezierBatch)
+  BezierBatch bezierBatch;
+  float bezierFlatness = 0.25f;      // Toleransi tessellation adaptif (pixels)
+  int bezierVertexBudget = 1000000;  // Total vertex bezier maksimal per frame
+  int bezierMaxSegments = 100;       // Segmen maksimal per kurva (kurva yang sudah datar memakai lebih sedikit)
+
+  // Geometry bezier dibangun paralel: satu batch per worker, digabung ke bezierBatch
+  WorkerPool workerPool;
+  std::vector<BezierBatch> workerBatches;
+  std::vector<int> workerSegments;  // Hasil measure() per worker (untuk budget global)
+  int geometryMinChunk = 64;  // Mobil minimal per worker (di bawah ini tidak dipecah)
+  void buildGeometryParallel(const RenderSnapshot& frame, float wobbleTime);
+  void drawScene();  // Isi draw(); draw() membungkusnya dengan cek alokasi
+
+  // Render dari snapshot (main thread): garis bezier mobil [begin, end) + mobil
+  void buildTrackGeometry(BezierBatch& batch, const TrackSnapshot& track, int begin, int end,
+                          float wobbleTime) const;
+  void drawTrackVehicles(const TrackSnapshot& track);
+  void drawTrackDensity(const TrackSnapshot& track);  // Physics macro
+  void drawSnapshotCar(const TrackSnapshot& track, int carIndex);
+  void drawNetworkSnapshot(const RenderSnapshot& frame);
 
   // TAB mode helpers
-  void drawInterTrackBezier(float wobbleTime);
-  void drawCarForTabMode(TrackInstance& track, int carIndex);
-  void drawInnerTrackLoop(TrackInstance& innerTrack, ofPoint centerPoint, float wobbleTime);
-  ofPoint getCarPosition(TrackInstance& track, int carIndex);
-  bool isInBlackHole(TrackInstance& track, int carIndex);
-  void drawContinuousBezier(ofPoint p0, ofPoint p1, ofPoint p2, ofPoint center,
-                            vec3 col, float wobbleTime, int carIndex,
-                            TrackInstance& outerTrack, TrackInstance& middleTrack, TrackInstance& innerTrack);
+  // Rantai TAB mode = track visible dari luar ke dalam (diisi getInterTrackCounts,
+  // main thread, sebelum worker membangun geometry)
+  std::vector<int> tabChain;
+  void getInterTrackCounts(const RenderSnapshot& frame, int& chainCount, int& loopCount);
+  bool chainHasBlackHole(const RenderSnapshot& frame, int carIndex) const;
+  void buildInterTrackGeometry(BezierBatch& batch, const RenderSnapshot& frame, int begin, int end,
+                               int chainCount, float wobbleTime) const;
+  void drawInterTrackCars(const RenderSnapshot& frame);
+  void drawCarForTabMode(const TrackSnapshot& track, int carIndex);
+  void buildInnerTrackLoop(BezierBatch& batch, const TrackSnapshot& innerTrack, ofPoint centerPoint,
+                           float wobbleTime, int begin, int end) const;
+  ofPoint getCarPosition(const TrackSnapshot& track, int carIndex) const;
+  bool isInBlackHole(const TrackSnapshot& track, int carIndex) const;
   ofPoint calculateControlPoint(ofPoint start, ofPoint end, ofPoint center,
                                  int direction, float wobbleTime, int carIndex,
-                                 float curveIntensity, float curveAngle);
-  void drawBezierSegment(ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3,
-                         vec3 col, int segments);
+                                 float curveIntensity, float curveAngle) const;
+  void addBezierSegment(BezierBatch& batch, ofPoint p0, ofPoint p1, ofPoint p2, ofPoint p3,
+                        vec3 col, int segments) const;
+
+  // Road network (grid kota) - alternatif dari 3 ring konsentris
+  RoadNetwork network;
+  int networkCols = 24;          // Jumlah junction horizontal
+  int networkRows = 14;          // Jumlah junction vertikal
+  int networkCellsPerEdge = 40;  // Panjang tiap edge dalam cells
+  int networkNumCars = 3000;     // Jumlah kendaraan di network
+  int networkMaxV = 5;           // Kecepatan maksimal (cells per step)
+  float networkProbSlow = 0.1f;  // Probabilitas random braking
+
+  // Snapshot state simulasi (binary, mmap saat load)
+  std::string snapshotFile = "snapshot.tjs";  // Relatif ke folder data/
+  bool saveSnapshot(const std::string& path);
+  bool loadSnapshot(const std::string& path);
+
+  // Rekaman trajektori (streaming ke disk) + replay dari file
+  TrajectoryRecorder recorder;
+  TrajectoryPlayer player;
+  std::string trajectoryFile = "trajectory.tjt";          // Distance, velocity, id & lane per step
+  std::string trajectorySnapshotFile = "trajectory.tjs";  // State awal (warna, jenis, road)
+  int replaySeekSteps = 600;  // Lompatan seek dengan panah kiri/kanan
+  void startRecording();
+  void stopRecording();
+  void recordStep();
+  bool startReplay();
+  void replayStep();
+  void applyReplayFrame();  // Step player saat ini ke semua track
+
+  // Telemetry lalu lintas per track → CSV + Prometheus textfile ('E')
+  TelemetryExporter telemetryExporter;
+  std::string telemetryCsvFile = "telemetry.csv";    // Relatif ke folder data/
+  std::string telemetryPromFile = "telemetry.prom";  // Untuk node_exporter textfile collector
+  int telemetryIntervalMs = 1000;
+  void toggleTelemetry();
+
+  // Array kendaraan tiap step → shared memory untuk proses lain ('M',
+  // layout di io/SharedStateFormat.h)
+  SharedStateExporter stateExporter;
+  std::string stateExportName = "trafficjam-state";  // TJ_STATE_NAME tanpa '/'
+  void toggleStateExport();
+  void exportState();
+
+  // ===== Pipelining: simulasi di thread sendiri, render dari snapshot =====
+  // Thread simulasi memiliki SEMUA state simulasi (tracks, network,
+  // recorder, player, curveIntensity*, dll). Main thread hanya mengirim
+  // perintah dan membaca RenderSnapshot terbaru, keduanya tanpa lock.
+  struct SimCommand {
+    enum Type {
+      STEP,  // Satu step simulasi (dikirim update() tiap frame)
+      KEY,   // Tombol yang mengubah state simulasi (lihat applyKey)
+      FOCUS  // Region micro track hybrid ke titik layar (x, y), lihat 'F'
+    };
+    Type type;
+    int key;
+    float x = 0.0f, y = 0.0f;
+  };
+  SpscQueue<SimCommand> commands{256};  // main → simulasi
+  TripleBuffer<RenderSnapshot> frames;  // simulasi → render
+  std::thread simThread;
+  std::atomic<bool> simRunning{false};
+  std::atomic<int> stepsInFlight{0};  // STEP terkirim yang belum dijalankan
+  int maxStepsInFlight = 2;           // Lebih dari ini: frame tidak menambah STEP
+
+  // Pool khusus thread simulasi (workerPool dipakai draw() di saat yang sama,
+  // WorkerPool hanya boleh dipanggil satu thread). Setengah core supaya
+  // tidak berebut dengan geometry bezier
+  WorkerPool simPool{std::max(0, (int)std::thread::hardware_concurrency() / 2 - 1)};
+
+  // ===== Frame tanpa alokasi heap =====
+  // Data sementara satu step (body point dll) diambil dari simArena, yang
+  // di-reset sebelum tiap perintah simulasi. Steady state (hanya STEP,
+  // setelah warm-up) diawasi alloc_counter: alokasi heap = warning
+  FrameArena simArena;
+  alloc_counter::SteadyStateCheck simAllocCheck;   // Thread simulasi
+  alloc_counter::SteadyStateCheck drawAllocCheck;  // Main thread (draw)
+  bool keyThisFrame = false;  // Main thread: ada tombol sejak draw() terakhir
+
+  void setupTracks();  // Buat semua track dari activeScenario (juga dipakai reset 'r')
+  void startSimulationThread();
+  void stopSimulationThread();
+  void simulationLoop();
+  void simulationStep();    // Satu step ring / network / replay
+  void applyKey(int key);   // Bagian keyPressed yang mengubah state simulasi
+  void applyFocus(vec2 point);  // Region micro semua track hybrid ke titik layar
+  void publishSnapshot();
 
   // Simulation control
-  bool simulationStarted = false;  // Simulasi belum mulai sampai tekan 's' atau 'S'
+  uint64_t simStep = 0;  // Jumlah step simulasi ring sejak setup()
+  std::atomic<bool> simulationStarted{false};  // Simulasi belum mulai sampai tekan 's' atau 'S'
   bool tabMode = false;  // TAB mode: draw inter-track bezier instead of center→car
+
+  // 'F': region micro track hybrid mengikuti mouse (dikirim paling banyak
+  // sekali per frame dari update())
+  bool focusFollowMouse = false;
+  bool focusMoved = false;
+  vec2 focusPoint;
+  bool networkMode = false;  // Network mode: simulasi road network, bukan ring
+  bool replayMode = false;   // Replay mode: posisi kendaraan dari file rekaman
 };
@@ -0,0 +1,249 @@
+#include "BezierBatch.h"
+#include "BezierKernel.h"
+#include <algorithm>
+#include <cmath>
+
+BezierBatch::BezierBatch()
+    : built(false), curveCount(0), flatnessTolerance(0.25f), vertexBudget(1000000), budgetScale(1.0f),
+      vertexCount(0), indexCount(0),
+      vboVertexCapacity(0), vboIndexCapacity(0) {}
+
+void BezierBatch::begin() {
+  for (Bucket& b : buckets) {
+    b.curves.clear();  // Kapasitas tetap
+    b.indexOffset = 0;
+    b.indexCount = 0;
+  }
+  vertexCount = 0;
+  indexCount = 0;
+  curveCount = 0;
+  built = false;
+}
+
+BezierBatch::Bucket& BezierBatch::findBucket(float lineWidth) {
+  // Jumlah bucket kecil → linear search cukup
+  for (Bucket& b : buckets) {
+    if (b.lineWidth == lineWidth) return b;
+  }
+  buckets.push_back({lineWidth, {}, 0, 0});
+  return buckets.back();
+}
+
+void BezierBatch::addCurve(vec2 p0, vec2 p1, vec2 p2, vec2 p3,
+                           const ofFloatColor& colorStart, const ofFloatColor& colorEnd,
+                           float lineWidth, int segments) {
+  int maxSegments = std::max(1, segments);
+  findBucket(lineWidth).curves.push_back({p0, p1, p2, p3, colorStart, colorEnd, maxSegments, maxSegments});
+  curveCount++;
+  built = false;
+}
+
+int BezierBatch::getDrawCallCount() const {
+  int count = 0;
+  for (const Bucket& b : buckets) count += (b.indexCount > 0) ? 1 : 0;
+  return count;
+}
+
+//--------------------------------------------------------------
+int BezierBatch::flatnessSegments(const Curve& c) const {
+  if (flatnessTolerance <= 0.0f) return c.maxSegments;
+
+  // Batas Wang untuk cubic: dengan n segmen, jarak polyline ke kurva
+  // <= 3/4 * M / n², M = beda kedua terbesar dari control point
+  vec2 dd1 = c.p0 - 2.0f * c.p1 + c.p2;
+  vec2 dd2 = c.p1 - 2.0f * c.p2 + c.p3;
+  float m = std::sqrt(std::max(glm::dot(dd1, dd1), glm::dot(dd2, dd2)));
+
+  int n = (int)std::ceil(std::sqrt(0.75f * m / flatnessTolerance));
+  return std::min(std::max(n, 1), c.maxSegments);
+}
+
+void BezierBatch::build() {
+  int requestedSegments = measure();
+  build(budgetScaleFor(vertexBudget, requestedSegments, curveCount));
+}
+
+int BezierBatch::measure() {
+  // 1. Segmen adaptif per kurva dari flatness
+  int requestedSegments = 0;
+  for (Bucket& b : buckets) {
+    for (Curve& c : b.curves) {
+      c.segments = flatnessSegments(c);
+      requestedSegments += c.segments;
+    }
+  }
+  return requestedSegments;
+}
+
+float BezierBatch::budgetScaleFor(int budget, int requestedSegments, int curveCount) {
+  // Vertex = segments + 1 per kurva, minimal 1 segmen per kurva
+  if (budget <= 0 || requestedSegments + curveCount <= budget) return 1.0f;
+  int available = std::max(budget - curveCount, curveCount);
+  return (float)available / requestedSegments;
+}
+
+void BezierBatch::build(float scale) {
+  // 2. Budget vertex: kurangi semua kurva secara proporsional
+  budgetScale = scale;
+  if (scale < 1.0f) {
+    for (Bucket& b : buckets) {
+      for (Curve& c : b.curves) {
+        c.segments = std::max(1, (int)(c.segments * scale));
+      }
+    }
+  }
+
+  // 3. Hitung total vertex & index supaya buffer cukup sekali resize
+  int totalVerts = 0;
+  int totalIndices = 0;
+  for (const Bucket& b : buckets) {
+    for (const Curve& c : b.curves) {
+      totalVerts += c.segments + 1;
+      totalIndices += c.segments * 2;
+    }
+  }
+  if ((int)vertices.size() < totalVerts) {
+    vertices.resize(totalVerts);
+    colors.resize(totalVerts);
+  }
+  if ((int)indices.size() < totalIndices) {
+    indices.resize(totalIndices);
+  }
+
+  // 4. Tessellate per bucket; index GL_LINES (k, k+1) per segmen
+  int v = 0;
+  int idx = 0;
+  for (Bucket& b : buckets) {
+    b.indexOffset = idx;
+    for (const Curve& c : b.curves) {
+      tessellate(c, vertices.data() + v, colors.data() + v);
+
+      ofIndexType* out = indices.data() + idx;
+      for (int k = 0; k < c.segments; k++) {
+        out[k * 2] = (ofIndexType)(v + k);
+        out[k * 2 + 1] = (ofIndexType)(v + k + 1);
+      }
+
+      v += c.segments + 1;
+      idx += c.segments * 2;
+    }
+    b.indexCount = idx - b.indexOffset;
+  }
+
+  vertexCount = v;
+  indexCount = idx;
+  built = true;
+}
+
+void BezierBatch::tessellate(const Curve& c, vec2* outVerts, ofFloatColor* outColors) {
+  const int n = c.segments;
+
+  // Posisi: forward differencing langsung ke buffer vertex
+  bezier::forwardDifference(c.p0, c.p1, c.p2, c.p3, n, outVerts);
+
+  // Warna linear terhadap t → juga cukup satu penjumlahan per vertex
+  const float invN = 1.0f / n;
+  ofFloatColor col = c.colorStart;
+  const ofFloatColor step((c.colorEnd.r - c.colorStart.r) * invN,
+                          (c.colorEnd.g - c.colorStart.g) * invN,
+                          (c.colorEnd.b - c.colorStart.b) * invN,
+                          (c.colorEnd.a - c.colorStart.a) * invN);
+  for (int k = 0; k < n; k++) {
+    outColors[k] = col;
+    col.r += step.r;
+    col.g += step.g;
+    col.b += step.b;
+    col.a += step.a;
+  }
+  outColors[n] = c.colorEnd;
+}
+
+//--------------------------------------------------------------
+void BezierBatch::gather(const std::vector<BezierBatch>& parts) {
+  begin();
+
+  // 1. Total ukuran + bucket gabungan (urutan lebar garis = kemunculan pertama)
+  int totalVerts = 0;
+  int totalIndices = 0;
+  budgetScale = 1.0f;
+  for (const BezierBatch& part : parts) {
+    totalVerts += part.vertexCount;
+    totalIndices += part.indexCount;
+    curveCount += part.curveCount;
+    budgetScale = std::min(budgetScale, part.budgetScale);
+    for (const Bucket& pb : part.buckets) {
+      if (pb.indexCount > 0) findBucket(pb.lineWidth);
+    }
+  }
+  if ((int)vertices.size() < totalVerts) {
+    vertices.resize(totalVerts);
+    colors.resize(totalVerts);
+  }
+  if ((int)indices.size() < totalIndices) {
+    indices.resize(totalIndices);
+  }
+
+  // 2. Vertex + warna: salin blok tiap part berurutan (memcpy-able)
+  int v = 0;
+  for (const BezierBatch& part : parts) {
+    std::copy(part.vertices.begin(), part.vertices.begin() + part.vertexCount, vertices.begin() + v);
+    std::copy(part.colors.begin(), part.colors.begin() + part.vertexCount, colors.begin() + v);
+    v += part.vertexCount;
+  }
+
+  // 3. Index per bucket: semua part untuk lebar garis yang sama bersebelahan,
+  //    digeser dengan offset vertex part tersebut
+  int idx = 0;
+  for (Bucket& b : buckets) {
+    b.indexOffset = idx;
+    int base = 0;
+    for (const BezierBatch& part : parts) {
+      for (const Bucket& pb : part.buckets) {
+        if (pb.lineWidth != b.lineWidth || pb.indexCount == 0) continue;
+        const ofIndexType* src = part.indices.data() + pb.indexOffset;
+        ofIndexType* dst = indices.data() + idx;
+        for (int k = 0; k < pb.indexCount; k++) {
+          dst[k] = src[k] + (ofIndexType)base;
+        }
+        idx += pb.indexCount;
+      }
+      base += part.vertexCount;
+    }
+    b.indexCount = idx - b.indexOffset;
+  }
+
+  vertexCount = v;
+  indexCount = idx;
+  built = true;
+}
+
+//--------------------------------------------------------------
+void BezierBatch::draw() {
+  if (!built) build();
+  if (vertexCount == 0) return;
+
+  // Alokasi ulang buffer GPU hanya kalau kapasitas kurang, selain itu update
+  if (vertexCount > vboVertexCapacity) {
+    vboVertexCapacity = (int)vertices.size();
+    vbo.setVertexData(vertices.data(), vboVertexCapacity, GL_DYNAMIC_DRAW);
+    vbo.setColorData(colors.data(), vboVertexCapacity, GL_DYNAMIC_DRAW);
+  } else {
+    vbo.updateVertexData(&vertices[0].x, vertexCount);
+    vbo.updateColorData(colors.data(), vertexCount);
+  }
+
+  if (indexCount > vboIndexCapacity) {
+    vboIndexCapacity = (int)indices.size();
+    vbo.setIndexData(indices.data(), vboIndexCapacity, GL_DYNAMIC_DRAW);
+  } else {
+    vbo.updateIndexData(indices.data(), indexCount);
+  }
+
+  // Warna dari vertex color, jadi ofSetColor() tidak berpengaruh
+  ofSetColor(255);
+  for (const Bucket& b : buckets) {
+    if (b.indexCount == 0) continue;
+    ofSetLineWidth(b.lineWidth);
+    vbo.drawElements(GL_LINES, b.indexCount, b.indexOffset);
+  }
+}
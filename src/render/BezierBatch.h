@@ -0,0 +1,154 @@
+#pragma once
+#include "ofMain.h"
+#include <cstdint>
+#include <vector>
+
+using glm::vec2;
+
+/**
+ * BezierBatch - Semua kurva bezier satu frame dalam SATU vertex buffer
+ *
+ * Sebelumnya tiap garis radial membuat ofPolyline/ofMesh baru (alokasi
+ * heap) + ofSetColor + ofSetLineWidth + satu draw call. Dengan batch:
+ *
+ * 1. begin()     - kosongkan daftar kurva (buffer tetap dipakai ulang)
+ * 2. addCurve()  - catat kontrol point, warna awal/akhir, lebar garis
+ * 3. build()     - tessellate semua kurva (forward differencing, lihat
+ *                  BezierKernel.h) ke vertex + warna per vertex + index GL_LINES. MURNI CPU, tidak butuh GL context,
+ *                  jadi bisa dites/di-benchmark tanpa window
+ * 4. draw()      - upload ke satu ofVbo persisten, satu draw call per
+ *                  lebar garis (biasanya cuma satu)
+ *
+ * Warna di-interpolasi per vertex dari colorStart (t = 0) ke colorEnd
+ * (t = 1), jadi mode normal (warna tetap) dan gradient mode (putih → gelap)
+ * memakai jalur yang sama.
+ *
+ * Tessellation adaptif (di build()):
+ * - Jumlah segmen per kurva dari toleransi flatness (pixel): kurva hampir
+ *   lurus / pendek cukup beberapa segmen, S-curve panjang dapat lebih banyak
+ * - Dibatasi maxSegments per kurva (parameter addCurve)
+ * - Kalau total vertex melebihi vertexBudget, semua kurva dikurangi
+ *   segmennya secara proporsional (setara menaikkan toleransi), jadi
+ *   kualitas turun merata alih-alih ada kurva yang hilang
+ *
+ * Buffer CPU hanya tumbuh (tidak pernah shrink), jadi setelah beberapa
+ * frame pertama tidak ada alokasi lagi.
+ *
+ * Build paralel: tiap worker thread punya BezierBatch sendiri (addCurve +
+ * measure() tanpa lock), main thread menjumlah hasil measure() untuk
+ * satu budgetScale global, worker memanggil build(scale), lalu main
+ * thread memanggil gather() dan draw() sekali. Hasilnya identik dengan
+ * build() serial atas semua kurva.
+ */
+class BezierBatch {
+public:
+  struct Curve {
+    vec2 p0, p1, p2, p3;
+    ofFloatColor colorStart;
+    ofFloatColor colorEnd;
+    int maxSegments;  // Batas dari addCurve()
+    int segments;     // Hasil adaptif, diisi build()
+  };
+
+  BezierBatch();
+
+  // Mulai frame baru
+  void begin();
+
+  /**
+   * Tambah satu kurva cubic bezier
+   * @param segments Jumlah segmen MAKSIMAL (vertex = segments + 1); jumlah
+   *                 sebenarnya ditentukan toleransi flatness di build()
+   */
+  void addCurve(vec2 p0, vec2 p1, vec2 p2, vec2 p3,
+                const ofFloatColor& colorStart, const ofFloatColor& colorEnd,
+                float lineWidth, int segments = 100);
+
+  // Warna sama sepanjang kurva
+  void addCurve(vec2 p0, vec2 p1, vec2 p2, vec2 p3, const ofFloatColor& color,
+                float lineWidth, int segments = 100) {
+    addCurve(p0, p1, p2, p3, color, color, lineWidth, segments);
+  }
+
+  // Tessellate semua kurva ke buffer CPU (tanpa GL) = measure() + build(scale)
+  void build();
+
+  // Tahap 1: segmen adaptif per kurva dari flatness. Return total segmen
+  int measure();
+
+  // Tahap 2: kurangi segmen dengan scale (dari budgetScaleFor), lalu tessellate
+  void build(float scale);
+
+  // Faktor pengurangan supaya total vertex <= budget (1 = tidak perlu)
+  static float budgetScaleFor(int budget, int requestedSegments, int curveCount);
+
+  /**
+   * Konfigurasi tessellation adaptif
+   * @param pixels Jarak maksimal garis ke kurva asli (<= 0: selalu maxSegments)
+   * @param vertices Total vertex maksimal per frame (<= 0: tanpa batas)
+   */
+  void setFlatnessTolerance(float pixels) { flatnessTolerance = pixels; }
+  void setVertexBudget(int vertices) { vertexBudget = vertices; }
+  float getFlatnessTolerance() const { return flatnessTolerance; }
+  int getVertexBudget() const { return vertexBudget; }
+
+  // Faktor pengurangan segmen frame terakhir (1 = budget tidak tercapai)
+  float getBudgetScale() const { return budgetScale; }
+
+  /**
+   * Gabungkan hasil build() beberapa batch (misal satu per worker thread)
+   * ke batch ini, berurutan sesuai vector. Index per lebar garis tetap
+   * bersebelahan, jadi jumlah draw call sama dengan build() serial.
+   * Menggantikan isi batch ini (seperti begin() + build())
+   */
+  void gather(const std::vector<BezierBatch>& parts);
+
+  // Upload + gambar (butuh GL context). Memanggil build() kalau belum
+  void draw();
+
+  // ===== Hasil build() (untuk test / benchmark tanpa GL) =====
+  int getCurveCount() const { return curveCount; }
+  int getVertexCount() const { return vertexCount; }
+  int getIndexCount() const { return indexCount; }
+  int getDrawCallCount() const;
+  const vec2* getVertices() const { return vertices.data(); }
+  const ofFloatColor* getColors() const { return colors.data(); }
+  const ofIndexType* getIndices() const { return indices.data(); }
+
+private:
+  // Kurva dikelompokkan per lebar garis → satu draw call per bucket
+  struct Bucket {
+    float lineWidth;
+    std::vector<Curve> curves;
+    int indexOffset;  // Diisi build()
+    int indexCount;
+  };
+
+  std::vector<Bucket> buckets;  // Bucket lama dipakai ulang antar frame (yang kosong di-skip)
+  bool built;
+  int curveCount;
+
+  // Bucket untuk lebar garis tertentu (dibuat kalau belum ada)
+  Bucket& findBucket(float lineWidth);
+
+  float flatnessTolerance;
+  int vertexBudget;
+  float budgetScale;
+
+  // Buffer CPU (ukuran = kapasitas, yang terpakai = vertexCount/indexCount)
+  std::vector<vec2> vertices;
+  std::vector<ofFloatColor> colors;
+  std::vector<ofIndexType> indices;
+  int vertexCount;
+  int indexCount;
+
+  // Buffer GPU persisten
+  ofVbo vbo;
+  int vboVertexCapacity;
+  int vboIndexCapacity;
+
+  void tessellate(const Curve& curve, vec2* outVerts, ofFloatColor* outColors);
+
+  // Jumlah segmen supaya error <= flatnessTolerance (sebelum budget)
+  int flatnessSegments(const Curve& curve) const;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * BezierKernel - Tessellation cubic bezier dengan forward differencing
+ *
+ * Evaluasi Bernstein langsung butuh ~20 perkalian per titik. Forward
+ * differencing menulis polinom dalam bentuk beda hingga: setelah setup
+ * (sekali per kurva), tiap titik berikutnya cukup 3 penjumlahan vec2:
+ *
+ *   P(t)     = A t³ + B t² + C t + D
+ *   p       += d1;  d1 += d2;  d2 += d3   (d3 konstan)
+ *
+ * Titik langsung ditulis ke buffer vertex milik caller (vec2, tanpa
+ * ofPoint/vec3 perantara). Titik terakhir di-set persis ke P3 supaya
+ * akumulasi error float tidak membuat ujung kurva bergeser.
+ */
+namespace bezier {
+
+/**
+ * Tessellate satu cubic bezier ke out[0 .. segments] (segments + 1 titik)
+ *
+ * @param p0 Titik awal
+ * @param p1 Control point 1
+ * @param p2 Control point 2
+ * @param p3 Titik akhir
+ */
+inline void forwardDifference(glm::vec2 p0, glm::vec2 p1, glm::vec2 p2, glm::vec2 p3,
+                              int segments, glm::vec2* out) {
+  // Koefisien polinom (bentuk power basis)
+  const glm::vec2 a = -p0 + 3.0f * p1 - 3.0f * p2 + p3;
+  const glm::vec2 b = 3.0f * p0 - 6.0f * p1 + 3.0f * p2;
+  const glm::vec2 c = -3.0f * p0 + 3.0f * p1;
+
+  const float h = 1.0f / segments;
+  const float h2 = h * h;
+  const float h3 = h2 * h;
+
+  // Beda hingga awal di t = 0
+  glm::vec2 p = p0;
+  glm::vec2 d1 = a * h3 + b * h2 + c * h;
+  glm::vec2 d2 = 6.0f * a * h3 + 2.0f * b * h2;
+  const glm::vec2 d3 = 6.0f * a * h3;
+
+  for (int k = 0; k < segments; k++) {
+    out[k] = p;
+    p += d1;
+    d1 += d2;
+    d2 += d3;
+  }
+  out[segments] = p3;
+}
+
+} // namespace bezier
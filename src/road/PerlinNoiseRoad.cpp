@@ -1,4 +1,26 @@
 #include "PerlinNoiseRoad.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Hash integer (lowbias32) untuk gradient di titik lattice
+inline uint32_t hashLattice(uint32_t seed, uint32_t octave, uint32_t cell) {
+    uint32_t h = seed ^ (octave * 0x9E3779B9u) ^ (cell * 0x85EBCA6Bu);
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// Gradient 1D dalam range [-1, 1]
+inline float latticeGradient(uint32_t seed, uint32_t octave, uint32_t cell) {
+    return (hashLattice(seed, octave, cell) >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+} // namespace
 
 //--------------------------------------------------------------
 PerlinNoiseRoad::PerlinNoiseRoad()
@@ -8,15 +30,40 @@ PerlinNoiseRoad::PerlinNoiseRoad()
     , numPoints(360)      // Satu titik per derajat untuk smoothness
     , noiseScale(2.f)    // Kontrol frekuensi noise
     , deformAmount(0.2f)  // 20% deformasi (tengah dari range 20-40%) bentuk lingkaran
+    , noiseSeed(0x5EED7A11u)
+    , octaveWeights({ 0.3f })  // Fitur sedang (weight 30%), sama seperti versi lama
+    , profileDirty(true)
 {
 }
 
 //--------------------------------------------------------------
-void PerlinNoiseRoad::generatePath(ofRectangle bounds) {
-    // Bersihkan path yang sudah ada
-    polyline.clear();
-    path.clear();
+void PerlinNoiseRoad::setResolution(int points) {
+    numPoints = std::max(3, points);
+    profileDirty = true;
+}
+
+void PerlinNoiseRoad::setOctaves(const std::vector<float>& weights) {
+    octaveWeights = weights;
+    profileDirty = true;
+}
+
+void PerlinNoiseRoad::setNoiseScale(float scale) {
+    noiseScale = scale;
+    profileDirty = true;
+}
+
+void PerlinNoiseRoad::setDeformAmount(float amount) {
+    deformAmount = amount;
+    profileDirty = true;
+}
+
+void PerlinNoiseRoad::setNoiseSeed(uint32_t seed) {
+    noiseSeed = seed;
+    profileDirty = true;
+}
 
+//--------------------------------------------------------------
+void PerlinNoiseRoad::generatePath(ofRectangle bounds) {
     // Hitung titik pusat dari bounds (sama seperti CircleRoad)
     centerX = bounds.x + bounds.width / 2.0f;
     centerY = bounds.y + bounds.height / 2.0f;
@@ -24,39 +71,141 @@ void PerlinNoiseRoad::generatePath(ofRectangle bounds) {
     // Hitung radius dasar dari bounds (sama seperti CircleRoad)
     baseRadius = std::min(bounds.width / 2.0f, bounds.height / 2.0f);
 
-    // Generate titik-titik di sekeliling lingkaran menggunakan Perlin noise untuk deformasi
-    for (int i = 0; i < numPoints; i++) {
-        // Hitung sudut (0 sampai TWO_PI)
-        float angle = ofMap(i, 0, numPoints, 0.0f, TWO_PI);
+    // Profil noise tidak bergantung pada bounds → hanya dihitung ulang
+    // kalau parameter noise/resolusi berubah
+    if (profileDirty || (int)unitRadius.size() != numPoints) {
+        generateProfile();
+    }
 
-        // Multi-octave Perlin noise untuk detail yang terlihat natural
-        // Setiap octave menambah detail pada skala yang berbeda
-        float n = 0.0f;
-        //n += ofNoise(angle * noiseScale, 0.0f) * 0.5f;        // Fitur besar (weight 50%)
-        n += ofNoise(angle * noiseScale * 2.0f, 1.0f) * 0.3f; // Fitur sedang (weight 30%)
-        //n += ofNoise(angle * noiseScale * 4.0f, 2.0f) * 0.2f; // Detail kecil (weight 20%)
+    buildPolarPath();
+}
 
-        // Map noise dari [0,1] ke [-1,1] untuk deformasi simetris
-        // Ini memungkinkan radius untuk membesar DAN mengecil
-        n = n * 2.0f - 1.0f;
+//--------------------------------------------------------------
+void PerlinNoiseRoad::generateProfile() {
+    const int n = numPoints;
+
+    // Tabel cos/sin hanya bergantung pada jumlah titik
+    if ((int)cosTable.size() != n) {
+        cosTable.resize(n);
+        sinTable.resize(n);
+        const double angleStep = TWO_PI / n;
+        for (int i = 0; i < n; i++) {
+            cosTable[i] = (float)std::cos(i * angleStep);
+            sinTable[i] = (float)std::sin(i * angleStep);
+        }
+    }
 
-        // Hitung radius yang sudah dideformasi (baseRadius +/- deformasi)
-        float radius = baseRadius * (1.0f + n * deformAmount);
+    // Noise gradient ada di range [-0.5, 0.5]; geser ke [0, 1] seperti ofNoise()
+    // dengan menjumlahkan bias 0.5 * weight di awal
+    float bias = 0.0f;
+    for (float w : octaveWeights) {
+        bias += w * 0.5f;
+    }
+    unitRadius.assign(n, bias);
+    float* acc = unitRadius.data();
+
+    std::vector<float> gradients;
+    for (int o = 0; o < (int)octaveWeights.size(); o++) {
+        const float w = octaveWeights[o];
+        if (w == 0.0f) continue;
+
+        // Jumlah sel lattice di sekeliling lingkaran (integer → noise periodik)
+        const int lattice = std::max(1, (int)std::lround(TWO_PI * noiseScale * std::ldexp(1.0, o + 1)));
+
+        gradients.resize(lattice + 1);
+        for (int c = 0; c < lattice; c++) {
+            gradients[c] = w * latticeGradient(noiseSeed, (uint32_t)o, (uint32_t)c);
+        }
+        gradients[lattice] = gradients[0];  // Wrap: sel terakhir nyambung ke sel 0
+
+        // Iterasi per sel lattice: semua titik di dalam satu sel berbagi gradient
+        // yang sama, jadi loop dalam murni aritmatika (tanpa gather/branch) dan
+        // bisa di-vectorize di SIMD lanes
+        const float step = (float)lattice / n;
+        for (int c = 0; c < lattice; c++) {
+            const int64_t i0 = ((int64_t)c * n + lattice - 1) / lattice;
+            const int64_t i1 = ((int64_t)(c + 1) * n + lattice - 1) / lattice;
+            const int count = (int)(i1 - i0);
+            if (count <= 0) continue;
+
+            const float u0 = (float)((double)(i0 * lattice - (int64_t)c * n) / n);
+            const float g0 = gradients[c];
+            const float g1 = gradients[c + 1];
+            float* out = acc + i0;
+
+            for (int k = 0; k < count; k++) {
+                float u = u0 + k * step;
+                float fade = u * u * u * (u * (u * 6.0f - 15.0f) + 10.0f);
+                float a = g0 * u;
+                float b = g1 * (u - 1.0f);
+                out[k] += a + fade * (b - a);
+            }
+        }
+    }
+
+    // Map noise dari [0,1] ke [-1,1] untuk deformasi simetris, lalu ke radius relatif
+    for (int i = 0; i < n; i++) {
+        acc[i] = 1.0f + (acc[i] * 2.0f - 1.0f) * deformAmount;
+    }
 
-        // Hitung posisi menggunakan koordinat polar
-        float x = centerX + cos(angle) * radius;
-        float y = centerY + sin(angle) * radius;
+    profileDirty = false;
+}
 
-        // Tambah titik ke polyline dan path
-        polyline.addVertex(x, y);
-        path.push_back(vec2(x, y));
+//--------------------------------------------------------------
+void PerlinNoiseRoad::buildPolarPath() {
+    const int n = numPoints;
+    path.resize(n);
+    arcLength.resize(n + 1);
+
+    const float* cosT = cosTable.data();
+    const float* sinT = sinTable.data();
+    const float* unitR = unitRadius.data();
+    float* segLen = arcLength.data() + 1;
+
+    // Satu pass: posisi titik i + panjang segmen i → i+1 (titik i+1 dihitung
+    // ulang dari tabel supaya tidak ada dependency antar iterasi)
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1 < n) ? i + 1 : 0;
+
+        float ri = baseRadius * unitR[i];
+        float rj = baseRadius * unitR[j];
+        float xi = cosT[i] * ri;
+        float yi = sinT[i] * ri;
+        float dx = cosT[j] * rj - xi;
+        float dy = sinT[j] * rj - yi;
+
+        path[i] = vec2(centerX + xi, centerY + yi);
+        segLen[i] = std::sqrt(dx * dx + dy * dy);
     }
 
-    // Tutup polyline untuk membentuk loop lengkap
-    polyline.close();
+    // Prefix sum → tabel arc-length kumulatif
+    double running = 0.0;
+    arcLength[0] = 0.0f;
+    for (int i = 1; i <= n; i++) {
+        running += arcLength[i];
+        arcLength[i] = (float)running;
+    }
 
-    // Hitung total panjang dari perimeter
-    totalLength = polyline.getPerimeter();
+    // Polyline hanya untuk rendering, isi langsung tanpa addVertex() per titik
+    polyline.clear();
+    polyline.resize(n);
+    auto& verts = polyline.getVertices();
+    for (int i = 0; i < n; i++) {
+        verts[i] = glm::vec3(path[i].x, path[i].y, 0.0f);
+    }
+    polyline.setClosed(true);
+    polyline.flagHasChanged();
+
+    // Total panjang = arc-length sampai kembali ke titik 0
+    totalLength = arcLength[n];
+}
+
+//--------------------------------------------------------------
+int PerlinNoiseRoad::findSegment(float dist) const {
+    const int n = numPoints;
+    auto it = std::upper_bound(arcLength.begin(), arcLength.begin() + n + 1, dist);
+    int idx = (int)(it - arcLength.begin()) - 1;
+    return std::min(std::max(idx, 0), n - 1);
 }
 
 //--------------------------------------------------------------
@@ -67,19 +216,25 @@ vec2 PerlinNoiseRoad::getPointAtDistance(float dist) {
         dist += totalLength;
     }
 
-    // Gunakan method bawaan OpenFrameworks untuk interpolasi smooth
-    ofPoint pt = polyline.getPointAtLength(dist);
-    return vec2(pt.x, pt.y);
+    // Binary search di tabel arc-length, lalu interpolasi linear di segmen
+    int i = findSegment(dist);
+    int j = (i + 1 < numPoints) ? i + 1 : 0;
+    float segLen = arcLength[i + 1] - arcLength[i];
+    float t = (segLen > 0.0f) ? (dist - arcLength[i]) / segLen : 0.0f;
+
+    return glm::mix(path[i], path[j], t);
 }
 
 //--------------------------------------------------------------
 vec2 PerlinNoiseRoad::getTangentAtDistance(float dist) {
-    // Ambil dua titik berdekatan untuk menghitung vektor arah
-    float delta = 1.0f;
-    vec2 p1 = getPointAtDistance(dist);
-    vec2 p2 = getPointAtDistance(dist + delta);
+    dist = fmod(dist, totalLength);
+    if (dist < 0) {
+        dist += totalLength;
+    }
 
-    // Hitung arah dan normalize
-    vec2 dir = p2 - p1;
+    // Tangent = arah segmen tempat distance berada (tanpa sampling 2 titik)
+    int i = findSegment(dist);
+    int j = (i + 1 < numPoints) ? i + 1 : 0;
+    vec2 dir = path[j] - path[i];
     return normalize(dir);
 }
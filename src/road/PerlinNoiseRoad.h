@@ -3,6 +3,8 @@
 #include "Road.h"
 #include "ofMain.h"
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
 
 using glm::vec2;
 
@@ -18,15 +20,49 @@ using glm::vec2;
  * - Deformation configurable (20-40% variasi radius)
  * - Noise statis (tidak animasi seiring waktu)
  * - Interpolasi smooth antara titik-titik noise
+ *
+ * Generator batch:
+ * - Noise dihitung per octave untuk SEMUA sudut sekaligus (loop kontigu tanpa
+ *   branch, jadi compiler bisa pakai SIMD lanes), bukan ofNoise() per titik
+ * - Noise periodik di sekeliling lingkaran (tidak ada "jahitan" di sudut 0/360)
+ * - Profil radius (unit) dan tabel cos/sin di-cache: kalau cuma bounds yang
+ *   berubah (window resize), yang dihitung ulang hanya konversi polar
+ * - Tabel arc-length dibangun di pass yang sama dengan konversi polar, jadi
+ *   getPointAtDistance() cukup binary search + lerp (tanpa ofPolyline)
  */
 class PerlinNoiseRoad : public Road {
 private:
     float centerX;        // Koordinat X pusat track
     float centerY;        // Koordinat Y pusat track
     float baseRadius;     // Radius dasar sebelum deformasi
-    int numPoints;        // Jumlah titik yang digenerate (default: 360)
-    float noiseScale;     // Kontrol frekuensi noise (default: 1.5)
-    float deformAmount;   // Jumlah deformasi 0.0-1.0 (default: 0.3 = 30%)
+    int numPoints;        // Jumlah titik yang digenerate (default: 360, bisa 100k+)
+    float noiseScale;     // Kontrol frekuensi noise (default: 2.0)
+    float deformAmount;   // Jumlah deformasi 0.0-1.0 (default: 0.2 = 20%)
+    uint32_t noiseSeed;   // Seed untuk gradient noise (bentuk track)
+
+    // Octave ke-o punya frekuensi noiseScale * 2^(o+1) per radian
+    // (octave 0 = "fitur sedang" dari versi lama)
+    std::vector<float> octaveWeights;  // Bobot per octave (size = jumlah octave)
+
+    // ===== CACHE =====
+    // unitRadius[i] = 1 + n * deformAmount (radius relatif terhadap baseRadius)
+    std::vector<float> unitRadius;
+    std::vector<float> cosTable;       // cos(angle_i), hanya bergantung numPoints
+    std::vector<float> sinTable;       // sin(angle_i)
+    bool profileDirty;                 // true: parameter noise berubah, hitung ulang profil
+
+    // arcLength[i] = panjang path dari titik 0 sampai titik i
+    // arcLength[numPoints] = totalLength (termasuk segmen penutup i = N-1 → 0)
+    std::vector<float> arcLength;
+
+    // Hitung profil noise semua octave untuk semua sudut (batch)
+    void generateProfile();
+
+    // Konversi polar + tabel arc-length dalam satu pass
+    void buildPolarPath();
+
+    // Cari indeks segmen untuk distance (binary search di arcLength)
+    int findSegment(float dist) const;
 
 public:
     // Constructor dengan default parameters
@@ -41,4 +77,19 @@ public:
 
     // Dapatkan vektor tangent (arah) pada jarak tertentu
     vec2 getTangentAtDistance(float dist) override;
+
+    /**
+     * Konfigurasi generator (berlaku di generatePath() berikutnya)
+     *
+     * @param points Jumlah vertex di sekeliling track (minimal 3)
+     * @param weights Bobot per octave, jumlah octave = weights.size()
+     */
+    void setResolution(int points);
+    void setOctaves(const std::vector<float>& weights);
+    void setNoiseScale(float scale);
+    void setDeformAmount(float amount);
+    void setNoiseSeed(uint32_t seed);
+
+    int getResolution() const { return numPoints; }
+    int getOctaveCount() const { return (int)octaveWeights.size(); }
 };
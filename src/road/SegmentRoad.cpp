@@ -0,0 +1,40 @@
+#include "SegmentRoad.h"
+
+SegmentRoad::SegmentRoad(vec2 fromNorm, vec2 toNorm, float laneOffset)
+    : fromNorm(fromNorm), toNorm(toNorm), laneOffset(laneOffset),
+      start(0, 0), dir(1, 0) {
+  totalLength = 0;
+}
+
+void SegmentRoad::generatePath(ofRectangle bounds) {
+  polyline.clear();
+  path.clear();
+
+  vec2 a(bounds.x + fromNorm.x * bounds.width, bounds.y + fromNorm.y * bounds.height);
+  vec2 b(bounds.x + toNorm.x * bounds.width, bounds.y + toNorm.y * bounds.height);
+
+  vec2 d = b - a;
+  totalLength = glm::length(d);
+  dir = (totalLength > 0.0f) ? d / totalLength : vec2(1, 0);
+
+  // Normal kanan dari arah jalan (layar: y ke bawah)
+  vec2 right(-dir.y, dir.x);
+  start = a + right * laneOffset;
+  vec2 end = b + right * laneOffset;
+
+  path.push_back(start);
+  path.push_back(end);
+  polyline.addVertex(start.x, start.y);
+  polyline.addVertex(end.x, end.y);
+}
+
+vec2 SegmentRoad::getPointAtDistance(float dist) {
+  // Jalan terbuka: clamp, bukan wrap
+  dist = ofClamp(dist, 0.0f, totalLength);
+  return start + dir * dist;
+}
+
+vec2 SegmentRoad::getTangentAtDistance(float dist) {
+  // Garis lurus: tangent sama di semua titik
+  return dir;
+}
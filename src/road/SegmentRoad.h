@@ -0,0 +1,35 @@
+#pragma once
+#include "Road.h"
+
+/**
+ * SegmentRoad - Jalan TERBUKA (bukan loop) dari titik A ke titik B
+ *
+ * Dipakai sebagai geometri edge di RoadNetwork. Titik A dan B disimpan
+ * dalam koordinat normal (0.0 - 1.0) relatif terhadap bounds, jadi
+ * generatePath(bounds) bisa dipanggil ulang saat window berubah ukuran.
+ *
+ * Beda dengan road lain:
+ * - Distance TIDAK di-wrap, tapi di-clamp ke [0, totalLength]
+ * - laneOffset menggeser jalan ke kanan (arah jalan) supaya jalan dua arah
+ *   tidak saling tumpuk
+ */
+class SegmentRoad : public Road {
+public:
+  /**
+   * @param fromNorm Titik awal (koordinat normal 0-1 di dalam bounds)
+   * @param toNorm Titik akhir (koordinat normal 0-1 di dalam bounds)
+   * @param laneOffset Geser ke kanan dalam pixels (0 = tepat di tengah)
+   */
+  SegmentRoad(vec2 fromNorm, vec2 toNorm, float laneOffset = 0.0f);
+  ~SegmentRoad() = default;
+
+  void generatePath(ofRectangle bounds) override;
+  vec2 getPointAtDistance(float dist) override;
+  vec2 getTangentAtDistance(float dist) override;
+
+private:
+  vec2 fromNorm, toNorm;  // Titik awal/akhir (normal)
+  float laneOffset;       // Offset ke kanan (pixels)
+  vec2 start;             // Titik awal (pixels, sudah termasuk offset)
+  vec2 dir;               // Unit vector arah jalan
+};
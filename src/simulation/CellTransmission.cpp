@@ -0,0 +1,176 @@
+#include "CellTransmission.h"
+#include <algorithm>
+#include <cmath>
+
+void CellTransmission::setup(int ringLength, int cellLength, int numLanes, float freeSpeed, float waveSpeed,
+                             float jamDensity) {
+  this->ringLength = std::max(1, ringLength);
+  this->numLanes = std::max(1, numLanes);
+  this->jamDensity = std::max(jamDensity, 1e-6f);
+  if (waveSpeed <= 0.0f) waveSpeed = freeSpeed * 0.25f;
+
+  // CFL: kendaraan tidak boleh melompati satu cell CTM dalam satu step
+  const int minLength = (int)std::ceil(std::max(std::max(freeSpeed, waveSpeed), 1.0f));
+  const int length = std::max(cellLength, minLength);
+  const int cells = std::max(1, this->ringLength / length);
+  cellSize = this->ringLength / (float)cells;
+
+  vehicles.assign(cells, 0.0f);
+  flow.assign(cells, 0.0f);
+  setSpeeds(freeSpeed, waveSpeed);
+}
+
+void CellTransmission::setSpeeds(float freeSpeed, float waveSpeed) {
+  if (waveSpeed <= 0.0f) waveSpeed = freeSpeed * 0.25f;
+  this->freeSpeed = std::min(std::max(freeSpeed, 0.0f), cellSize);
+  this->waveSpeed = std::min(std::max(waveSpeed, 1e-6f), cellSize);
+  updateRates();
+}
+
+void CellTransmission::updateRates() {
+  const float vf = freeSpeed;
+  const float w = waveSpeed;
+  capacity = numLanes * vf * w * jamDensity / std::max(vf + w, 1e-6f);
+  maxVehicles = jamDensity * cellSize * numLanes;
+  sendRate = vf / cellSize;
+  receiveRate = w / cellSize;
+}
+
+void CellTransmission::addVehicles(int from, int length, float count) {
+  if (length <= 0 || count <= 0.0f) return;
+  const int cells = (int)vehicles.size();
+  length = std::min(length, ringLength);
+  const float perCell = count / length;  // Per cell NaSch
+
+  // Potongan [from, from + length) per cell CTM
+  int m = ((from % ringLength) + ringLength) % ringLength;
+  int remaining = length;
+  while (remaining > 0) {
+    int k = std::min((int)(m / cellSize), cells - 1);
+    int cellEnd = (k == cells - 1) ? ringLength : (int)std::ceil((k + 1) * cellSize);
+    int take = std::max(1, std::min(remaining, cellEnd - m));
+    vehicles[k] += perCell * take;
+    remaining -= take;
+    m += take;
+    if (m >= ringLength) m -= ringLength;
+  }
+
+  // Kelebihan di atas N diteruskan ke depan (paling banyak dua putaran)
+  for (int pass = 0; pass < 2 * cells; pass++) {
+    bool overflow = false;
+    for (int k = 0; k < cells; k++) {
+      float extra = vehicles[k] - maxVehicles;
+      if (extra > 0.0f) {
+        vehicles[k] = maxVehicles;
+        vehicles[(k + 1) % cells] += extra;
+        overflow = true;
+      }
+    }
+    if (!overflow) break;
+  }
+}
+
+void CellTransmission::computeFlows() {
+  const int cells = (int)vehicles.size();
+  if (cells < 2) {  // Satu cell: keluar = masuk ke cell yang sama
+    if (cells == 1) flow[0] = 0.0f;
+    return;
+  }
+
+  const float* n = vehicles.data();
+  float* y = flow.data();
+  const float q = capacity;
+  const float big = maxVehicles;
+  const float send = sendRate;
+  const float receive = receiveRate;
+
+  // Flow tiap batas cell (dari state lama semua cell). Receiving tidak
+  // negatif: cell hybrid bisa sedikit di atas N setelah handoff
+  for (int i = 0; i + 1 < cells; i++) {
+    float s = std::min(send * n[i], q);
+    float r = std::max(std::min(q, receive * (big - n[i + 1])), 0.0f);
+    y[i] = std::min(s, r);
+  }
+  {
+    float s = std::min(send * n[cells - 1], q);
+    float r = std::max(std::min(q, receive * (big - n[0])), 0.0f);
+    y[cells - 1] = std::min(s, r);
+  }
+}
+
+void CellTransmission::applyFlows(int first, int count) {
+  const int cells = (int)vehicles.size();
+  if (cells < 2) return;
+  count = std::min(std::max(count, 0), cells);
+  first = ((first % cells) + cells) % cells;
+
+  // Konservasi: masuk dari cell belakang, keluar ke cell depan. Range
+  // dipecah di cell 0 (wrap) supaya loop dalam tetap berurutan
+  float* n = vehicles.data();
+  const float* y = flow.data();
+  for (int k = 0; k < count;) {
+    const int i = (first + k) % cells;
+    if (i == 0) {
+      n[0] += y[cells - 1] - y[0];
+      k++;
+      continue;
+    }
+    const int run = std::min(count - k, cells - i);
+    for (int j = i; j < i + run; j++) {
+      n[j] += y[j - 1] - y[j];
+    }
+    k += run;
+  }
+}
+
+float CellTransmission::receiving(int cell) const {
+  return std::max(std::min(capacity, receiveRate * (maxVehicles - vehicles[cell])), 0.0f);
+}
+
+float CellTransmission::speed(int cell) const {
+  const float n = vehicles[cell];
+  return (n > 1e-6f) ? std::min(flow[cell] * cellSize / n, freeSpeed) : freeSpeed;
+}
+
+float CellTransmission::getTotalVehicles() const {
+  double total = 0.0;
+  for (float n : vehicles) total += n;
+  return (float)total;
+}
+
+void CellTransmission::sample(float detectorCell, TrackSample& out, int first, int count) const {
+  const int cells = (int)vehicles.size();
+  const float* n = vehicles.data();
+  const float* y = flow.data();
+  count = std::min(std::max(count, 0), cells);
+  first = (cells > 0) ? ((first % cells) + cells) % cells : 0;
+
+  // Mean velocity per kendaraan = total jarak / total kendaraan
+  double total = 0.0, moved = 0.0;
+  for (int k = 0, i = first; k < count; k++, i = (i + 1 == cells) ? 0 : i + 1) {
+    total += n[i];
+    moved += y[i];
+  }
+  moved *= cellSize;
+  const double mean = (total > 0.0) ? moved / total : 0.0;
+
+  // Variance antar kendaraan (dua lintasan) + fraksi berhenti
+  double m2 = 0.0, stopped = 0.0;
+  for (int k = 0, i = first; k < count; k++, i = (i + 1 == cells) ? 0 : i + 1) {
+    if (n[i] <= 0.0f) continue;
+    double v = (double)y[i] * cellSize / n[i];
+    m2 += n[i] * (v - mean) * (v - mean);
+    if (v < STOPPED_VELOCITY) stopped += n[i];
+  }
+
+  int detector = std::min(std::max((int)(detectorCell / cellSize), 0), cells - 1);
+  int detectorOffset = detector - first;
+  if (detectorOffset < 0) detectorOffset += cells;
+
+  out.cars = (int)std::lround(total);
+  out.density = (float)(total / ((double)ringLength * numLanes));
+  out.flow = (detectorOffset < count) ? y[detector] : 0.0f;
+  out.meanVelocity = (float)mean;
+  out.velocityVariance = (total > 0.0) ? (float)(m2 / total) : 0.0f;
+  out.stoppedFraction = (total > 0.0) ? (float)(stopped / total) : 0.0f;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "TrafficStats.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * CellTransmission - Model makroskopik satu track (Cell Transmission Model
+ * Daganzo, diskretisasi LWR dengan fundamental diagram segitiga)
+ *
+ * Pengganti kendaraan individual untuk road yang sangat panjang: state
+ * hanya jumlah kendaraan per cell CTM (float), satu cell CTM = L cell
+ * NaSch (ring dibagi rata, L >= cellLength). Biaya per step = jumlah
+ * cell CTM, tidak bergantung pada jumlah kendaraan.
+ *
+ * Satuan sama dengan model mikroskopik (cell NaSch, step simulasi):
+ * - freeSpeed vf: kecepatan bebas (= maxV track)
+ * - waveSpeed w:  kecepatan gelombang macet ke belakang
+ * - jamDensity kj: kendaraan per cell per lajur saat macet (1 / panjang rata-rata)
+ * Kapasitas per lajur Q = vf w kj / (vf + w) kendaraan per step.
+ *
+ * Step (semua cell sekaligus, ring):
+ *   sending  S_i = min(vf / L * n_i, Q)
+ *   receiving R_i = min(Q, w / L * (N - n_i))       N = kj * L * lajur
+ *   flow     y_i = min(S_i, R_{i+1})                 (cell i → i + 1)
+ *   n_i     += y_{i-1} - y_i
+ * Dua loop tanpa branch (flow lalu update), bisa di-vectorize. Syarat CFL:
+ * vf <= L dan w <= L (dicek setup(), L dinaikkan kalau perlu).
+ *
+ * Track hybrid memakai kedua loop terpisah: computeFlows() untuk semua
+ * cell, flow di batas region micro diganti (kendaraan yang benar-benar
+ * keluar / masuk), lalu applyFlows() hanya untuk cell macro.
+ */
+class CellTransmission {
+public:
+  /**
+   * @param ringLength  Panjang ring (maxCells, cell NaSch)
+   * @param cellLength  Cell NaSch minimal per cell CTM (0 = otomatis: terkecil yang memenuhi CFL)
+   * @param numLanes    Lajur (kapasitas & N dikali lajur)
+   * @param freeSpeed, waveSpeed  Cells per step (waveSpeed <= 0 → freeSpeed / 4)
+   * @param jamDensity  Kendaraan per cell NaSch per lajur saat macet
+   */
+  void setup(int ringLength, int cellLength, int numLanes, float freeSpeed, float waveSpeed, float jamDensity);
+
+  // Ganti kecepatan (mis. SpiralRoad), cellLength tetap: dibatasi CFL.
+  // waveSpeed <= 0 → freeSpeed / 4
+  void setSpeeds(float freeSpeed, float waveSpeed);
+
+  // Tambah count kendaraan merata di [from, from + length) cell NaSch (ring).
+  // Cell yang melebihi N meneruskan sisanya ke cell berikutnya
+  void addVehicles(int from, int length, float count);
+
+  void step() {
+    computeFlows();
+    applyFlows(0, getCellCount());
+  }
+
+  // Flow y_i semua batas cell dari state sekarang (tanpa mengubah n)
+  void computeFlows();
+
+  // n_i += y_{i-1} - y_i untuk count cell mulai first (melingkar)
+  void applyFlows(int first, int count);
+
+  // Receiving R_i (kendaraan per step yang masih bisa masuk cell)
+  float receiving(int cell) const;
+
+  // Kecepatan kendaraan di cell step terakhir (y_i L / n_i, kosong → vf)
+  float speed(int cell) const;
+
+  /**
+   * Telemetry sama dengan model mikroskopik: density per cell NaSch,
+   * flow melewati batas cell CTM tempat detector, velocity per kendaraan
+   * (kendaraan di cell i bergerak y_i L / n_i), fraksi berhenti.
+   * out.step dan out.track tidak diubah.
+   */
+  void sample(float detectorCell, TrackSample& out) const { sample(detectorCell, out, 0, getCellCount()); }
+
+  // Hanya count cell mulai first (melingkar); flow 0 kalau detector di luar range
+  void sample(float detectorCell, TrackSample& out, int first, int count) const;
+
+  int getCellCount() const { return (int)vehicles.size(); }
+  float getCellSize() const { return cellSize; }        // L (cell NaSch)
+  int getRingLength() const { return ringLength; }
+  float getCapacity() const { return capacity; }        // Kendaraan per step, semua lajur
+  float getCellMaximum() const { return maxVehicles; }  // N
+  float getTotalVehicles() const;
+
+  const float* data() const { return vehicles.data(); }
+  float* data() { return vehicles.data(); }
+  const float* flows() const { return flow.data(); }  // y_i step terakhir
+  float* flows() { return flow.data(); }
+
+private:
+  int ringLength = 1;
+  float cellSize = 1.0f;  // L = ringLength / jumlah cell CTM
+  int numLanes = 1;
+  float freeSpeed = 1.0f;
+  float waveSpeed = 0.25f;
+  float jamDensity = 1.0f;
+
+  float capacity = 0.0f;     // Q semua lajur
+  float maxVehicles = 0.0f;  // N per cell CTM
+  float sendRate = 0.0f;     // vf / L
+  float receiveRate = 0.0f;  // w / L
+
+  std::vector<float> vehicles;  // n_i
+  std::vector<float> flow;      // y_i
+
+  void updateRates();
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * CounterRng - Random generator berbasis counter (tanpa state internal)
+ *
+ * Setiap angka random adalah hash dari (seed, stream, step, index):
+ * - stream: jenis keputusan (randomize, lane change, pilih rute, dll)
+ * - step:   nomor langkah simulasi
+ * - index:  id kendaraan/elemen
+ *
+ * Berbeda dengan ofRandom(), hasilnya TIDAK bergantung pada urutan
+ * pemanggilan. Jadi aman dipakai dari banyak thread sekaligus dan
+ * simulasi bisa diulang persis dengan seed yang sama.
+ */
+struct CounterRng {
+  // Stream id standar (supaya keputusan berbeda tidak berkorelasi)
+  enum Stream : uint32_t {
+    STREAM_RANDOMIZE = 1,
+    STREAM_LANE_CHANGE = 2,
+    STREAM_ROUTE = 3,
+    STREAM_SPAWN = 4,
+    STREAM_SLOW_START = 5,
+    STREAM_HANDOFF = 6  // Jenis & warna kendaraan dari density (track hybrid)
+  };
+
+  uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+  CounterRng() = default;
+  explicit CounterRng(uint64_t s) : seed(s) {}
+
+  // Finalizer SplitMix64
+  static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  // 64 bit random untuk (stream, step, index)
+  inline uint64_t bits(uint32_t stream, uint64_t step, uint32_t index) const {
+    uint64_t h = mix64(seed ^ ((uint64_t)stream << 32 | index));
+    return mix64(h + step * 0x9E3779B97F4A7C15ull);
+  }
+
+  // Uniform float di [0, 1)
+  inline float uniform(uint32_t stream, uint64_t step, uint32_t index) const {
+    return (float)(bits(stream, step, index) >> 40) * (1.0f / 16777216.0f);
+  }
+
+  // Integer uniform di [0, n)
+  inline uint32_t below(uint32_t n, uint32_t stream, uint64_t step, uint32_t index) const {
+    return (uint32_t)(((bits(stream, step, index) >> 32) * (uint64_t)n) >> 32);
+  }
+};
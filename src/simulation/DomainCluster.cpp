@@ -0,0 +1,232 @@
+#include "DomainCluster.h"
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(DomainCluster::Sample) == 16, "Sample dikirim apa adanya antar proses");
+
+namespace {
+
+const uint32_t CLUSTER_MAGIC = 0x43444a54u;  // "TJDC"
+const uint32_t CLUSTER_VERSION = 1;
+
+// Awal region; transport mulai di TRANSPORT_OFFSET
+struct ClusterHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t domainCount;
+  uint32_t reserved;
+  uint64_t seed;
+  uint64_t steps;
+  uint64_t coordinatorPid;
+  uint64_t queueCapacity;
+};
+
+const size_t TRANSPORT_OFFSET = 4096;
+
+static_assert(sizeof(ClusterHeader) <= TRANSPORT_OFFSET, "ClusterHeader terlalu besar");
+
+void appendBytes(std::vector<uint8_t>& out, const void* data, size_t bytes) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  out.insert(out.end(), p, p + bytes);
+}
+
+}  // namespace
+
+DomainCluster::~DomainCluster() {
+  // Koordinator yang berhenti sebelum finish() (error): batalkan transport
+  // supaya worker keluar, lalu tunggu (~ChildProcess)
+  bool running = false;
+  for (ChildProcess& worker : workers) {
+    running |= worker.isRunning();
+  }
+  if (running) transport.abort();
+  workers.clear();
+}
+
+bool DomainCluster::start(int domainCount, uint64_t runSeed, uint64_t runSteps, const std::string& executable,
+                          const std::vector<std::string>& workerArgs, std::string& error) {
+  if (domainCount < 1 || domainCount > SharedMemoryTransport::MAX_DOMAINS) {
+    error = "Jumlah domain harus 1.." + std::to_string(SharedMemoryTransport::MAX_DOMAINS);
+    return false;
+  }
+
+  const std::string channel = SharedMemory::uniqueName("trafficjam-domain");
+  const size_t bytes = TRANSPORT_OFFSET + SharedMemoryTransport::requiredBytes(domainCount, QUEUE_CAPACITY);
+  if (!memory.create(channel, bytes)) {
+    error = "Gagal membuat shared memory " + channel + " (" + std::to_string(bytes) + " bytes)";
+    return false;
+  }
+
+  seed = runSeed;
+  steps = runSteps;
+  coordinatorPid = ChildProcess::currentProcessId();
+
+  ClusterHeader* header = reinterpret_cast<ClusterHeader*>(memory.data());
+  header->magic = CLUSTER_MAGIC;
+  header->version = CLUSTER_VERSION;
+  header->domainCount = (uint32_t)domainCount;
+  header->seed = seed;
+  header->steps = steps;
+  header->coordinatorPid = coordinatorPid;
+  header->queueCapacity = QUEUE_CAPACITY;
+  transport.attach(memory.data() + TRANSPORT_OFFSET, memory.size() - TRANSPORT_OFFSET, domainCount, QUEUE_CAPACITY,
+                   0, true);
+
+  // Worker yang keluar dengan error (atau crash) tidak akan pernah
+  // mengirim lagi: batalkan daripada menunggu selamanya
+  transport.setIdleCheck([this]() {
+    for (ChildProcess& worker : workers) {
+      if (!worker.isRunning() && worker.wait() != 0) return false;
+    }
+    return true;
+  });
+
+  workers.resize(domainCount - 1);
+  for (int r = 1; r < domainCount; r++) {
+    std::vector<std::string> args = {"--domain-worker", channel, "--rank", std::to_string(r)};
+    args.insert(args.end(), workerArgs.begin(), workerArgs.end());
+    if (!workers[r - 1].start(executable, args)) {
+      error = "Gagal menjalankan worker rank " + std::to_string(r) + ": " + executable;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DomainCluster::attach(const std::string& channel, int rank, std::string& error) {
+  if (!memory.open(channel) || memory.size() < TRANSPORT_OFFSET) {
+    error = "Shared memory domain tidak ditemukan: " + channel;
+    return false;
+  }
+
+  const ClusterHeader* header = reinterpret_cast<const ClusterHeader*>(memory.data());
+  if (header->magic != CLUSTER_MAGIC || header->version != CLUSTER_VERSION) {
+    error = "Shared memory " + channel + " bukan cluster domain (versi berbeda?)";
+    return false;
+  }
+  if (rank < 1 || !transport.attach(memory.data() + TRANSPORT_OFFSET, memory.size() - TRANSPORT_OFFSET,
+                                    (int)header->domainCount, (size_t)header->queueCapacity, rank, false)) {
+    error = "Rank " + std::to_string(rank) + " tidak valid untuk " + std::to_string(header->domainCount) + " domain";
+    return false;
+  }
+
+  seed = header->seed;
+  steps = header->steps;
+  coordinatorPid = header->coordinatorPid;
+
+  // Koordinator mati (crash / dibunuh) → tidak ada yang membatalkan transport
+  const uint64_t pid = coordinatorPid;
+  transport.setIdleCheck([pid]() { return ChildProcess::isProcessAlive(pid); });
+  return true;
+}
+
+bool DomainCluster::setupTracks(const std::vector<RingDomainSpec>& specs, std::string& error) {
+  const int domainCount = getDomainCount();
+  domains.assign(specs.size(), RingDomain());
+  samples.assign(specs.size(), std::vector<Sample>());
+  received.assign(specs.size(), 0);
+
+  for (size_t t = 0; t < specs.size(); t++) {
+    if (!RingDomain::validate(specs[t], domainCount, error)) {
+      error = "Track " + std::to_string(t) + ": " + error;
+      return false;
+    }
+    domains[t].setup(specs[t], getRank(), domainCount);
+    if (getRank() == 0) {
+      samples[t].resize((size_t)std::max(1, specs[t].numLanes) * specs[t].numCars);
+    }
+  }
+  return true;
+}
+
+bool DomainCluster::step(uint64_t stepIndex) {
+  for (RingDomain& domain : domains) {
+    if (!domain.step(transport, stepIndex)) {
+      transport.abort();  // Pesan rusak di rank ini: rank lain jangan menunggu
+      return false;
+    }
+  }
+  if (getRank() != 0) return sendSamples();
+  if (!gatherSamples()) return false;
+
+  // Semua worker sudah mengirim = sudah attach: nama region tidak dipakai lagi
+  if (stepIndex == 0) memory.unlink();
+  return true;
+}
+
+bool DomainCluster::sendSamples() {
+  // Per track: uint32 jumlah, lalu Sample
+  message.clear();
+  for (const RingDomain& domain : domains) {
+    const uint32_t count = (uint32_t)domain.getOwnedCount();
+    appendBytes(message, &count, sizeof(count));
+    domain.forEachOwned([this](uint32_t key, float distance, float velocity, int lane, VehicleType type) {
+      const Sample s = {key, distance, velocity, (uint16_t)lane, (uint8_t)type, 0};
+      appendBytes(message, &s, sizeof(s));
+    });
+  }
+  return transport.send(0, message.data(), message.size());
+}
+
+bool DomainCluster::gatherSamples() {
+  std::fill(received.begin(), received.end(), 0);
+  for (size_t t = 0; t < domains.size(); t++) {
+    std::vector<Sample>& out = samples[t];
+    uint32_t& count = received[t];
+    domains[t].forEachOwned([&out, &count](uint32_t key, float distance, float velocity, int lane, VehicleType type) {
+      out[key] = {key, distance, velocity, (uint16_t)lane, (uint8_t)type, 0};
+      count++;
+    });
+  }
+
+  for (int r = 1; r < getDomainCount(); r++) {
+    if (!transport.receive(r, message)) return false;
+    if (!storeSamples(message.data(), message.size())) {
+      transport.abort();
+      return false;
+    }
+  }
+
+  // Setiap kendaraan dimiliki tepat satu rank
+  for (size_t t = 0; t < domains.size(); t++) {
+    if (received[t] != samples[t].size()) {
+      transport.abort();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DomainCluster::storeSamples(const uint8_t* data, size_t bytes) {
+  size_t at = 0;
+  for (size_t t = 0; t < domains.size(); t++) {
+    uint32_t count;
+    if (bytes - at < sizeof(count)) return false;
+    std::memcpy(&count, data + at, sizeof(count));
+    at += sizeof(count);
+    if ((bytes - at) / sizeof(Sample) < count) return false;
+
+    for (uint32_t i = 0; i < count; i++, at += sizeof(Sample)) {
+      Sample s;
+      std::memcpy(&s, data + at, sizeof(s));
+      if (s.key >= samples[t].size()) return false;
+      samples[t][s.key] = s;
+      received[t]++;
+    }
+  }
+  return at == bytes;
+}
+
+bool DomainCluster::finish(std::string& error) {
+  bool ok = true;
+  for (size_t i = 0; i < workers.size(); i++) {
+    const int code = workers[i].wait();
+    if (code != 0 && ok) {
+      error = "Worker rank " + std::to_string(i + 1) + " keluar dengan kode " + std::to_string(code);
+      ok = false;
+    }
+  }
+  workers.clear();
+  memory.close();
+  return ok;
+}
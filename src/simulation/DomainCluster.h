@@ -0,0 +1,87 @@
+#pragma once
+#include "../util/ChildProcess.h"
+#include "../util/SharedMemory.h"
+#include "DomainTransport.h"
+#include "RingDomain.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * DomainCluster - Beberapa proses yang bersama-sama menjalankan track
+ * physics integer, masing-masing track dipecah jadi RingDomain per rank
+ *
+ * Rank 0 (koordinator, proses harness) membuat region SharedMemory dan
+ * menjalankan domainCount - 1 worker dari executable yang sama:
+ *
+ *   <exe> --domain-worker <channel> --rank <r> [argumen worker]
+ *
+ * Seed dan jumlah step ada di header region, jadi worker hanya perlu
+ * scenario yang sama. Tiap step semua rank menjalankan RingDomain::step()
+ * untuk semua track dengan urutan sama, lalu rank lain mengirim kendaraan
+ * miliknya ke rank 0 (getSamples(), urut kunci = urutan traffic track utuh).
+ *
+ * Error di proses mana pun membatalkan transport: step() return false di
+ * semua rank, koordinator menunggu semua worker sebelum keluar.
+ */
+class DomainCluster {
+public:
+  // Satu kendaraan hasil step (dikumpulkan di rank 0)
+  struct Sample {
+    uint32_t key;
+    float distance;
+    float velocity;
+    uint16_t lane;
+    uint8_t type;
+    uint8_t reserved;
+  };
+
+  static const size_t QUEUE_CAPACITY = 1 << 18;  // Byte per antrian transport (pesan lebih besar dialirkan)
+
+  DomainCluster() = default;
+  ~DomainCluster();
+
+  DomainCluster(const DomainCluster&) = delete;
+  DomainCluster& operator=(const DomainCluster&) = delete;
+
+  // Koordinator: buat region + jalankan worker
+  bool start(int domainCount, uint64_t seed, uint64_t steps, const std::string& executable,
+             const std::vector<std::string>& workerArgs, std::string& error);
+
+  // Worker: buka region dari koordinator
+  bool attach(const std::string& channel, int rank, std::string& error);
+
+  int getRank() const { return transport.getRank(); }
+  int getDomainCount() const { return transport.getDomainCount(); }
+  uint64_t getSeed() const { return seed; }
+  uint64_t getSteps() const { return steps; }
+
+  // Sama di semua rank (spec dari scenario + seed region)
+  bool setupTracks(const std::vector<RingDomainSpec>& specs, std::string& error);
+
+  // Satu step semua track + kumpulkan hasil di rank 0
+  bool step(uint64_t stepIndex);
+
+  // Rank 0: kendaraan track setelah step terakhir, indeks = kunci
+  const std::vector<Sample>& getSamples(int track) const { return samples[track]; }
+
+  // Koordinator: tunggu semua worker (false kalau ada yang gagal)
+  bool finish(std::string& error);
+
+private:
+  SharedMemory memory;
+  SharedMemoryTransport transport;
+  std::vector<ChildProcess> workers;
+  std::vector<RingDomain> domains;
+  uint64_t seed = 0;
+  uint64_t steps = 0;
+  uint64_t coordinatorPid = 0;
+
+  std::vector<std::vector<Sample>> samples;  // Rank 0, per track
+  std::vector<uint32_t> received;            // Rank 0, per track (cek semua kendaraan datang)
+  std::vector<uint8_t> message;
+
+  bool sendSamples();
+  bool gatherSamples();
+  bool storeSamples(const uint8_t* data, size_t bytes);
+};
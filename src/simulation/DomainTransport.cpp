@@ -0,0 +1,256 @@
+#include "DomainTransport.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Antrian shared memory butuh atomic 64 bit lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Antrian shared memory butuh atomic 32 bit lock-free");
+
+const uint32_t TRANSPORT_MAGIC = 0x54444a54u;  // "TJDT"
+
+struct TransportHeader {
+  uint32_t magic;
+  uint32_t domainCount;
+  uint64_t queueCapacity;
+  std::atomic<uint32_t> aborted;
+};
+
+// head = byte yang sudah dibaca (consumer), tail = byte yang sudah ditulis (producer)
+struct QueueHeader {
+  alignas(64) std::atomic<uint64_t> head;
+  alignas(64) std::atomic<uint64_t> tail;
+};
+
+const size_t HEADER_BYTES = 256;
+const size_t QUEUE_HEADER_BYTES = sizeof(QueueHeader);
+
+static_assert(sizeof(TransportHeader) <= HEADER_BYTES, "TransportHeader terlalu besar");
+
+TransportHeader* headerOf(uint8_t* base) {
+  return reinterpret_cast<TransportHeader*>(base);
+}
+
+}  // namespace
+
+struct SharedMemoryTransport::Queue {
+  QueueHeader* header = nullptr;
+  uint8_t* ring = nullptr;
+  uint64_t mask = 0;
+
+  // Tulis sebanyak yang muat, return jumlah byte
+  size_t write(const uint8_t* src, size_t n) {
+    const uint64_t t = header->tail.load(std::memory_order_relaxed);
+    const uint64_t h = header->head.load(std::memory_order_acquire);
+    n = (size_t)std::min<uint64_t>(n, mask + 1 - (t - h));
+    if (n == 0) return 0;
+
+    const size_t at = (size_t)(t & mask);
+    const size_t first = std::min(n, (size_t)(mask + 1) - at);
+    std::memcpy(ring + at, src, first);
+    std::memcpy(ring, src + first, n - first);
+    header->tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  // Baca sebanyak yang tersedia (paling banyak n), return jumlah byte
+  size_t read(uint8_t* dst, size_t n) {
+    const uint64_t h = header->head.load(std::memory_order_relaxed);
+    const uint64_t t = header->tail.load(std::memory_order_acquire);
+    n = (size_t)std::min<uint64_t>(n, t - h);
+    if (n == 0) return 0;
+
+    const size_t at = (size_t)(h & mask);
+    const size_t first = std::min(n, (size_t)(mask + 1) - at);
+    std::memcpy(dst, ring + at, first);
+    std::memcpy(dst + first, ring, n - first);
+    header->head.store(h + n, std::memory_order_release);
+    return n;
+  }
+};
+
+// Pesan keluar: 8 byte panjang lalu isi
+struct SharedMemoryTransport::Sending {
+  Queue queue;
+  uint8_t length[8];
+  const uint8_t* data;
+  size_t bytes;
+  size_t done = 0;  // Termasuk 8 byte panjang
+
+  Sending(Queue q, const void* src, size_t n) : queue(q), data(static_cast<const uint8_t*>(src)), bytes(n) {
+    uint64_t len = n;
+    std::memcpy(length, &len, sizeof(len));
+  }
+
+  bool finished() const { return done == bytes + sizeof(length); }
+
+  bool progress() {
+    size_t moved = 0;
+    if (done < sizeof(length)) {
+      size_t n = queue.write(length + done, sizeof(length) - done);
+      done += n;
+      moved += n;
+      if (done < sizeof(length)) return moved > 0;
+    }
+    size_t n = queue.write(data + (done - sizeof(length)), bytes + sizeof(length) - done);
+    done += n;
+    return moved + n > 0;
+  }
+};
+
+struct SharedMemoryTransport::Receiving {
+  Queue queue;
+  std::vector<uint8_t>& message;
+  uint8_t length[8];
+  size_t lengthDone = 0;
+  size_t bytes = 0;
+  size_t done = 0;
+
+  Receiving(Queue q, std::vector<uint8_t>& out) : queue(q), message(out) {}
+
+  bool finished() const { return lengthDone == sizeof(length) && done == bytes; }
+
+  bool progress() {
+    size_t moved = 0;
+    if (lengthDone < sizeof(length)) {
+      size_t n = queue.read(length + lengthDone, sizeof(length) - lengthDone);
+      lengthDone += n;
+      moved += n;
+      if (lengthDone < sizeof(length)) return moved > 0;
+      uint64_t len;
+      std::memcpy(&len, length, sizeof(len));
+      bytes = (size_t)len;
+      message.resize(bytes);
+    }
+    size_t n = queue.read(message.data() + done, bytes - done);
+    done += n;
+    return moved + n > 0;
+  }
+};
+
+bool SharedMemoryTransport::linked(int from, int to, int domainCount) {
+  if (from == to) return false;
+  return from == 0 || to == 0 || to == (from + 1) % domainCount || from == (to + 1) % domainCount;
+}
+
+size_t SharedMemoryTransport::requiredBytes(int domainCount, size_t queueCapacity) {
+  size_t queues = 0;
+  for (int from = 0; from < domainCount; from++) {
+    for (int to = 0; to < domainCount; to++) {
+      queues += linked(from, to, domainCount) ? 1 : 0;
+    }
+  }
+  return HEADER_BYTES + queues * (QUEUE_HEADER_BYTES + queueCapacity);
+}
+
+bool SharedMemoryTransport::attach(uint8_t* region, size_t regionBytes, int count, size_t queueCapacity,
+                                   int thisRank, bool initialize) {
+  if (count < 1 || count > MAX_DOMAINS || thisRank < 0 || thisRank >= count) return false;
+  if (queueCapacity < 64 || (queueCapacity & (queueCapacity - 1)) != 0) return false;
+  if (regionBytes < requiredBytes(count, queueCapacity)) return false;
+
+  TransportHeader* header = headerOf(region);
+  if (initialize) {
+    new (header) TransportHeader();
+    header->magic = TRANSPORT_MAGIC;
+    header->domainCount = (uint32_t)count;
+    header->queueCapacity = queueCapacity;
+    header->aborted.store(0);
+  } else if (header->magic != TRANSPORT_MAGIC || header->domainCount != (uint32_t)count ||
+             header->queueCapacity != queueCapacity) {
+    return false;
+  }
+
+  base = region;
+  domainCount = count;
+  rank = thisRank;
+  capacity = queueCapacity;
+
+  queueIndex.assign((size_t)count * count, -1);
+  int next = 0;
+  for (int from = 0; from < count; from++) {
+    for (int to = 0; to < count; to++) {
+      if (!linked(from, to, count)) continue;
+      const int index = next++;
+      queueIndex[(size_t)from * count + to] = index;
+      if (initialize) {
+        new (base + HEADER_BYTES + (size_t)index * (QUEUE_HEADER_BYTES + capacity)) QueueHeader();
+      }
+    }
+  }
+  return true;
+}
+
+SharedMemoryTransport::Queue SharedMemoryTransport::queue(int from, int to) const {
+  Queue q;
+  const int index = queueIndex[(size_t)from * domainCount + to];
+  uint8_t* at = base + HEADER_BYTES + (size_t)index * (QUEUE_HEADER_BYTES + capacity);
+  q.header = reinterpret_cast<QueueHeader*>(at);
+  q.ring = at + QUEUE_HEADER_BYTES;
+  q.mask = capacity - 1;
+  return q;
+}
+
+bool SharedMemoryTransport::isAborted() const {
+  return base && headerOf(base)->aborted.load(std::memory_order_acquire) != 0;
+}
+
+void SharedMemoryTransport::abort() {
+  if (base) headerOf(base)->aborted.store(1, std::memory_order_release);
+}
+
+bool SharedMemoryTransport::run(Sending* out, Receiving* in) {
+  using clock = std::chrono::steady_clock;
+  int spins = 0;
+  clock::time_point lastCheck = clock::now();
+
+  while ((out && !out->finished()) || (in && !in->finished())) {
+    bool moved = false;
+    if (out && !out->finished()) moved |= out->progress();
+    if (in && !in->finished()) moved |= in->progress();
+    if (moved) {
+      spins = 0;
+      continue;
+    }
+
+    // Tidak ada kemajuan: spin sebentar, lalu yield + cek abort / idle
+    if (++spins < 256) continue;
+    std::this_thread::yield();
+    if (isAborted()) return false;
+    if (clock::now() - lastCheck > std::chrono::milliseconds(10)) {
+      lastCheck = clock::now();
+      if (idle && !idle()) {
+        abort();
+        return false;
+      }
+    }
+  }
+  return !isAborted();
+}
+
+bool SharedMemoryTransport::send(int to, const void* data, size_t bytes) {
+  if (to < 0 || to >= domainCount || queueIndex[(size_t)rank * domainCount + to] < 0) return false;
+  Sending out(queue(rank, to), data, bytes);
+  return run(&out, nullptr);
+}
+
+bool SharedMemoryTransport::receive(int from, std::vector<uint8_t>& message) {
+  if (from < 0 || from >= domainCount || queueIndex[(size_t)from * domainCount + rank] < 0) return false;
+  Receiving in(queue(from, rank), message);
+  return run(nullptr, &in);
+}
+
+bool SharedMemoryTransport::exchange(int sendTo, const void* data, size_t bytes, int receiveFrom,
+                                     std::vector<uint8_t>& message) {
+  if (sendTo < 0 || sendTo >= domainCount || queueIndex[(size_t)rank * domainCount + sendTo] < 0) return false;
+  if (receiveFrom < 0 || receiveFrom >= domainCount || queueIndex[(size_t)receiveFrom * domainCount + rank] < 0) {
+    return false;
+  }
+  Sending out(queue(rank, sendTo), data, bytes);
+  Receiving in(queue(receiveFrom, rank), message);
+  return run(&out, &in);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * DomainTransport - Pesan antar proses domain (RingDomain / DomainCluster)
+ *
+ * Setiap proses punya rank 0 .. domainCount - 1. Pesan antar satu pasangan
+ * rank diterima dengan urutan kirim (FIFO); tidak ada tag, karena semua
+ * rank menjalankan urutan pesan yang sama tiap step. Interface sengaja
+ * sekecil point-to-point MPI supaya backend lain (MPI antar mesin) cukup
+ * mengimplementasi empat method ini.
+ *
+ * Semua method blocking. false = transport dibatalkan (abort() di rank
+ * mana pun, atau rank lain mati): pemanggil berhenti dan keluar dengan error.
+ */
+class DomainTransport {
+public:
+  virtual ~DomainTransport() = default;
+
+  virtual int getRank() const = 0;
+  virtual int getDomainCount() const = 0;
+
+  virtual bool send(int rank, const void* data, size_t bytes) = 0;
+
+  // Pesan berikutnya dari rank (message di-resize, kapasitasnya dipakai ulang)
+  virtual bool receive(int rank, std::vector<uint8_t>& message) = 0;
+
+  /**
+   * Kirim ke sendTo sambil menerima dari receiveFrom (seperti MPI_Sendrecv).
+   * Tidak deadlock walau semua rank mengirim sebelum menerima dan pesannya
+   * lebih besar dari buffer transport (tukar halo di ring)
+   */
+  virtual bool exchange(int sendTo, const void* data, size_t bytes, int receiveFrom,
+                        std::vector<uint8_t>& message) = 0;
+
+  // Batalkan transport di semua rank
+  virtual void abort() = 0;
+};
+
+/**
+ * SharedMemoryTransport - DomainTransport lewat antrian byte di shared memory
+ *
+ * Satu antrian SPSC (ring byte, kapasitas pangkat 2) per arah untuk pasangan
+ * yang dipakai RingDomain: tetangga ring (r ± 1) dan rank 0 ↔ semua rank
+ * (kumpulan hasil). Pesan = panjang uint64 + isi, dialirkan sepotong-sepotong
+ * kalau lebih besar dari antrian. head / tail std::atomic lock-free di
+ * region bersama (cache line terpisah, seperti SpscQueue).
+ *
+ * Menunggu = spin lalu yield; tiap ~10 ms idle() dipanggil (mis. cek proses
+ * lain masih hidup), false → abort().
+ */
+class SharedMemoryTransport : public DomainTransport {
+public:
+  static const int MAX_DOMAINS = 64;
+
+  // Byte region untuk domainCount rank (header + semua antrian)
+  static size_t requiredBytes(int domainCount, size_t queueCapacity);
+
+  /**
+   * Pakai region (dari SharedMemory) sebagai transport rank ini.
+   * initialize = true hanya di pembuat region, sebelum proses lain attach
+   */
+  bool attach(uint8_t* region, size_t regionBytes, int domainCount, size_t queueCapacity, int rank, bool initialize);
+
+  void setIdleCheck(std::function<bool()> check) { idle = std::move(check); }
+
+  int getRank() const override { return rank; }
+  int getDomainCount() const override { return domainCount; }
+
+  bool send(int rank, const void* data, size_t bytes) override;
+  bool receive(int rank, std::vector<uint8_t>& message) override;
+  bool exchange(int sendTo, const void* data, size_t bytes, int receiveFrom,
+                std::vector<uint8_t>& message) override;
+  void abort() override;
+
+  bool isAborted() const;
+
+private:
+  struct Queue;
+  struct Sending;
+  struct Receiving;
+
+  uint8_t* base = nullptr;
+  int domainCount = 0;
+  int rank = 0;
+  size_t capacity = 0;
+  std::vector<int> queueIndex;  // from * domainCount + to → indeks antrian (-1 = tidak ada)
+  std::function<bool()> idle;
+
+  static bool linked(int from, int to, int domainCount);
+  Queue queue(int from, int to) const;
+  bool run(Sending* out, Receiving* in);
+};
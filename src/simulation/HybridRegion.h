@@ -0,0 +1,54 @@
+#pragma once
+#include <algorithm>
+
+/**
+ * HybridRegion - Interval micro di track hybrid, dalam cell CTM
+ *
+ * Cell [firstCell, firstCell + cellCount) (melingkar) dijalankan NaSch per
+ * kendaraan, sisanya CellTransmission. Batas selalu di batas cell CTM,
+ * jadi satu cell CTM seluruhnya micro atau seluruhnya macro.
+ *
+ * - entryCell: cell macro tepat sebelum region (flow masuk → spawn kendaraan)
+ * - exitCell:  cell macro tepat sesudah region (kendaraan keluar → density)
+ *
+ * cellCount = 0: semua macro, cellCount = cells: semua micro (tanpa batas).
+ */
+struct HybridRegion {
+  int firstCell = 0;
+  int cellCount = 0;
+
+  // Normalisasi ke [0, cells) dan 0 .. cells
+  static HybridRegion make(int first, int count, int cells) {
+    HybridRegion r;
+    if (cells <= 0) return r;
+    r.firstCell = ((first % cells) + cells) % cells;
+    r.cellCount = std::min(std::max(count, 0), cells);
+    return r;
+  }
+
+  bool hasBoundary(int cells) const { return cellCount > 0 && cellCount < cells; }
+
+  bool containsCell(int cell, int cells) const {
+    int k = cell - firstCell;
+    if (k < 0) k += cells;
+    return k < cellCount;
+  }
+
+  int entryCell(int cells) const { return (firstCell + cells - 1) % cells; }
+  int exitCell(int cells) const { return (firstCell + cellCount) % cells; }
+  int lastCell(int cells) const { return (firstCell + cellCount + cells - 1) % cells; }
+
+  // Distance (cell NaSch) relatif terhadap awal region, di [0, ringLength)
+  float localDistance(float distance, float cellSize, float ringLength) const {
+    float d = distance - firstCell * cellSize;
+    if (d < 0.0f) d += ringLength;
+    return d;
+  }
+
+  bool containsDistance(float distance, float cellSize, float ringLength) const {
+    return localDistance(distance, cellSize, ringLength) < cellCount * cellSize;
+  }
+
+  bool operator==(const HybridRegion& o) const { return firstCell == o.firstCell && cellCount == o.cellCount; }
+  bool operator!=(const HybridRegion& o) const { return !(*this == o); }
+};
@@ -0,0 +1,191 @@
+#include "IntegerNaSch.h"
+#include <algorithm>
+
+void IntegerNaSch::reset(uint32_t ringLength, int numLanes) {
+  this->ringLength = std::max(1u, ringLength);
+  laneBegin.assign((size_t)std::max(1, numLanes) + 1, 0);
+  position.clear();
+  velocity.clear();
+  type.clear();
+  key.clear();
+}
+
+void IntegerNaSch::setType(VehicleType t, int maxV, int len, float probSlow) {
+  maxVelocity[t] = (uint8_t)std::min(std::max(maxV, 1), (int)MAX_VELOCITY);
+  length[t] = (uint32_t)std::max(len, 0);
+
+  slowThreshold[t] = probabilityThreshold(probSlow);
+}
+
+namespace {
+
+using StepFn = void (IntegerNaSch::*)(const CounterRng&, uint64_t);
+
+template <class Randomization, class Start>
+StepFn pickBrake(const NaSchRules& rules) {
+  if (rules.anticipation) return &IntegerNaSch::stepWith<Randomization, Start, AnticipationBrake>;
+  return &IntegerNaSch::stepWith<Randomization, Start, PlainBrake>;
+}
+
+template <class Randomization>
+StepFn pickStart(const NaSchRules& rules) {
+  if (rules.slowToStart) return pickBrake<Randomization, SlowToStart>(rules);
+  return pickBrake<Randomization, NoSlowToStart>(rules);
+}
+
+}  // namespace
+
+void IntegerNaSch::setRules(const NaSchRules& rules) {
+  params = RuleParams(rules);
+  stepFn = rules.velocityDependent ? pickStart<VelocityDependentRandomization>(rules)
+                                   : pickStart<ConstantRandomization>(rules);
+  if (!rules.any()) {
+    previous.clear();
+    gaps.clear();
+  }
+}
+
+void IntegerNaSch::addCar(int lane, uint32_t pos, int v, VehicleType t) {
+  const size_t lanes = laneBegin.size() - 1;
+  const size_t l = std::min((size_t)std::max(lane, 0), lanes - 1);
+
+  // Lajur l dan setelahnya bertambah satu kendaraan di akhir
+  for (size_t k = l + 1; k <= lanes; k++) {
+    laneBegin[k]++;
+  }
+  position.push_back(pos % ringLength);
+  velocity.push_back((uint8_t)std::min(std::max(v, 0), (int)maxVelocity[t]));
+  type.push_back((uint8_t)t);
+}
+
+void IntegerNaSch::addCar(int lane, uint32_t pos, int v, VehicleType t, uint32_t k) {
+  addCar(lane, pos, v, t);
+  key.push_back(k);
+}
+
+bool IntegerNaSch::isOrdered() const {
+  for (size_t lane = 0; lane + 1 < laneBegin.size(); lane++) {
+    const uint32_t begin = laneBegin[lane];
+    const uint32_t end = laneBegin[lane + 1];
+    if (end - begin < 2) continue;
+
+    int descents = position[begin] < position[end - 1];  // Terakhir → pertama
+    for (uint32_t i = begin; i + 1 < end; i++) {
+      descents += position[i + 1] < position[i];
+    }
+    if (descents > 1) return false;
+  }
+  return true;
+}
+
+template <class Randomization, class Start, class Brake>
+void IntegerNaSch::stepWith(const CounterRng& rng, uint64_t stepIndex) {
+  // Array tambahan hanya kalau policy memakainya (NaSch dasar: tidak ada)
+  constexpr bool NEEDS_GAPS = Start::ENABLED || Brake::USES_LEADER;
+  constexpr bool NEEDS_PREVIOUS = NEEDS_GAPS || Randomization::USES_PREVIOUS_VELOCITY;
+
+  const size_t count = position.size();
+  const uint32_t* pos = position.data();
+  const uint8_t* types = type.data();
+  uint8_t* vel = velocity.data();
+  const uint32_t* keys = key.empty() ? nullptr : key.data();
+
+  // Tabel jenis disalin ke lokal: store uint8 ke vel boleh alias apa saja,
+  // tanpa ini compiler membaca ulang tabel member tiap kendaraan
+  int32_t vmaxOf[VEHICLE_TYPE_COUNT], lengthOf[VEHICLE_TYPE_COUNT];
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    vmaxOf[k] = maxVelocity[k];
+    lengthOf[k] = (int32_t)length[k];
+  }
+  const int32_t ring = (int32_t)ringLength;
+  const RuleParams rules = params;
+
+  // Gap bersih ke ekor kendaraan depan (dari posisi sebelum step)
+  auto gapTo = [&](size_t self, size_t ahead) {
+    int32_t d = (int32_t)(pos[ahead] - pos[self]);
+    if (d <= 0) d += ring;  // Depan sudah wrap (atau satu-satunya di lajur)
+    int32_t gap = d - lengthOf[types[ahead]];
+    return (gap < 0) ? 0 : gap;  // Tumpang tindih (spawn terlalu rapat)
+  };
+
+  // 0. Velocity step lalu + gap semua kendaraan, sebelum ada yang diubah
+  const uint8_t* prev = vel;
+  const int32_t* gap = nullptr;
+  if constexpr (NEEDS_PREVIOUS) {
+    previous.assign(vel, vel + count);
+    prev = previous.data();
+  }
+  if constexpr (NEEDS_GAPS) {
+    gaps.resize(count);
+    for (size_t lane = 0; lane + 1 < laneBegin.size(); lane++) {
+      const size_t begin = laneBegin[lane];
+      const size_t end = laneBegin[lane + 1];
+      if (begin == end) continue;
+      for (size_t i = begin; i + 1 < end; i++) {
+        gaps[i] = gapTo(i, i + 1);
+      }
+      gaps[end - 1] = gapTo(end - 1, begin);
+    }
+    gap = gaps.data();
+  }
+
+  // 1 + 2. Accelerate + brake: velocity baru dari posisi lama semua kendaraan.
+  //    Kendaraan depan = i + 1, kendaraan terakhir lajur → pertama
+  auto limit = [&](size_t self, size_t ahead) {
+    int32_t g;
+    if constexpr (NEEDS_GAPS) {
+      g = gap[self];
+    } else {
+      g = gapTo(self, ahead);
+    }
+    if constexpr (Brake::USES_LEADER) {
+      if (ahead != self) g = Brake::effectiveGap(rules, g, prev[ahead], gap[ahead]);
+    }
+
+    int32_t v = vel[self] + 1;
+    v = std::min(v, vmaxOf[types[self]]);
+    return (uint8_t)std::min(v, g);
+  };
+  for (size_t lane = 0; lane + 1 < laneBegin.size(); lane++) {
+    const size_t begin = laneBegin[lane];
+    const size_t end = laneBegin[lane + 1];
+    if (begin == end) continue;
+
+    for (size_t i = begin; i + 1 < end; i++) {
+      vel[i] = limit(i, i + 1);
+    }
+    vel[end - 1] = limit(end - 1, begin);
+  }
+
+  // 2b. Slow-to-start: kendaraan yang diam tertahan walau ada gap kecil
+  if constexpr (Start::ENABLED) {
+    for (size_t i = 0; i < count; i++) {
+      if (vel[i] == 0 || !Start::applies(rules, prev[i], gap[i])) continue;
+      const uint32_t k = keys ? keys[i] : (uint32_t)i;
+      if ((uint32_t)(rng.bits(CounterRng::STREAM_SLOW_START, stepIndex, k) >> 40) <
+          rules.slowToStartThreshold) {
+        vel[i] = 0;
+      }
+    }
+  }
+
+  // 3. Randomize (hash hanya untuk kendaraan yang masih bisa diperlambat)
+  for (size_t i = 0; i < count; i++) {
+    uint32_t threshold = slowThreshold[types[i]];
+    if constexpr (Randomization::USES_PREVIOUS_VELOCITY) {
+      threshold = Randomization::threshold(rules, threshold, prev[i]);
+    }
+    if (vel[i] == 0 || threshold == 0) continue;
+    const uint32_t k = keys ? keys[i] : (uint32_t)i;
+    if ((uint32_t)(rng.bits(CounterRng::STREAM_RANDOMIZE, stepIndex, k) >> 40) < threshold) {
+      vel[i]--;
+    }
+  }
+
+  // 4. Move dengan wrap (velocity < ringLength, cukup satu kali kurang)
+  uint32_t* out = position.data();
+  for (size_t i = 0; i < count; i++) {
+    uint32_t x = out[i] + vel[i];
+    out[i] = (x >= ringLength) ? x - ringLength : x;
+  }
+}
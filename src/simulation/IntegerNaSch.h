@@ -0,0 +1,151 @@
+#pragma once
+#include "../entities/VehicleSpec.h"
+#include "CounterRng.h"
+#include "NaSchRules.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * IntegerNaSch - Automaton Nagel-Schreckenberg klasik (integer, exact) satu track
+ *
+ * Alternatif NaSchMovement (distance / velocity float, akselerasi 0.02,
+ * grid dari (int)distance). Semua state integer, jadi hasil tidak
+ * bergantung pada rounding float dan loop per kendaraan bisa di-vectorize.
+ *
+ * State per kendaraan (SoA, 6 byte):
+ * - position: uint32, cell kepala di [0, ringLength)
+ * - velocity: uint8, cells per step CA, 0 .. vmax
+ * - type:     uint8, VehicleType → vmax / length / probSlow dari tabel
+ *             per track (setType), bukan array per kendaraan
+ * Satu juta kendaraan = 4 MB position + 1 MB velocity + 1 MB type.
+ *
+ * Aturan (update paralel: semua gap dihitung dari posisi sebelum step):
+ * 1. v = min(v + 1, vmax)
+ * 2. v = min(v, gap)          gap = cell kosong sampai ekor kendaraan depan
+ * 3. dengan probabilitas p:   v = max(v - 1, 0)
+ * 4. x = (x + v) mod ringLength
+ *
+ * Tanpa grid: di satu lajur kendaraan tidak pernah saling menyalip, jadi
+ * kendaraan depan i adalah i + 1 (kendaraan terakhir lajur → pertama).
+ * Syaratnya urutan = lajur menaik, lalu posisi menaik melingkar (sama
+ * seperti traffic hasil TrackInstance::setup), lihat isOrdered().
+ * Tidak ada lane change.
+ *
+ * Random: (CounterRng::bits >> 40) < p * 2^24, sama dengan uniform() < p
+ * tapi dibandingkan sebagai integer. Indeks CounterRng = indeks array,
+ * atau kunci per kendaraan kalau kendaraan ditambah dengan kunci
+ * (RingDomain: indeks kendaraan di track utuh, sehingga domain yang
+ * memegang sebagian kendaraan menarik angka random yang sama).
+ *
+ * Varian aturan (VDR, slow-to-start, anticipation) adalah policy
+ * compile-time di stepWith<>() (lihat NaSchRules.h). setRules() memilih
+ * instansiasi sekali; step() hanya memanggilnya.
+ */
+class IntegerNaSch {
+public:
+  static const int MAX_VELOCITY = 255;  // velocity uint8
+
+  // Kosongkan semua kendaraan. ringLength = maxCells (< 2^31)
+  void reset(uint32_t ringLength, int numLanes);
+
+  /**
+   * Parameter satu jenis kendaraan
+   * @param maxVelocity Cells per step CA (1 .. MAX_VELOCITY)
+   * @param probSlow    Probabilitas random braking per step CA (0 .. 1)
+   */
+  void setType(VehicleType type, int maxVelocity, int length, float probSlow);
+
+  // Varian aturan; berlaku mulai step() berikutnya
+  void setRules(const NaSchRules& rules);
+
+  // Tambah kendaraan di akhir. Lajur harus menaik (>= lajur kendaraan sebelumnya).
+  // Velocity dibatasi vmax jenisnya (setType dulu)
+  void addCar(int lane, uint32_t position, int velocity, VehicleType type);
+
+  // Idem dengan kunci random sendiri. Jangan dicampur dengan addCar() tanpa kunci
+  void addCar(int lane, uint32_t position, int velocity, VehicleType type, uint32_t key);
+
+  // Posisi tiap lajur menaik melingkar (paling banyak satu kali turun, termasuk
+  // dari kendaraan terakhir ke pertama): syarat kendaraan depan = i + 1
+  bool isOrdered() const;
+
+  // Satu step CA semua kendaraan dengan aturan dari setRules()
+  void step(const CounterRng& rng, uint64_t step) { (this->*stepFn)(rng, step); }
+
+  /**
+   * Satu step CA dengan policy tertentu (semua 8 kombinasi diinstansiasi
+   * di IntegerNaSch.cpp). Random braking dari stream RANDOMIZE,
+   * slow-to-start dari stream SLOW_START, keduanya di step ini.
+   */
+  template <class Randomization, class Start, class Brake>
+  void stepWith(const CounterRng& rng, uint64_t step);
+
+  // Hapus kendaraan i yang remove(i) == true; urutan sisanya tetap
+  template <typename RemoveFn>
+  void compact(RemoveFn remove) {
+    size_t kept = 0;
+    size_t lane = 0;
+    for (size_t i = 0; i < position.size(); i++) {
+      while (lane + 1 < laneBegin.size() && laneBegin[lane + 1] <= i) {
+        laneBegin[++lane] = (uint32_t)kept;
+      }
+      if (remove((int)i)) continue;
+      position[kept] = position[i];
+      velocity[kept] = velocity[i];
+      type[kept] = type[i];
+      if (!key.empty()) key[kept] = key[i];
+      kept++;
+    }
+    while (++lane < laneBegin.size()) laneBegin[lane] = (uint32_t)kept;
+    position.resize(kept);
+    velocity.resize(kept);
+    type.resize(kept);
+    if (!key.empty()) key.resize(kept);
+  }
+
+  int getCarCount() const { return (int)position.size(); }
+  uint32_t getRingLength() const { return ringLength; }
+  uint32_t getPosition(int car) const { return position[car]; }
+  int getVelocity(int car) const { return velocity[car]; }
+  VehicleType getType(int car) const { return (VehicleType)type[car]; }
+  uint32_t getKey(int car) const { return key.empty() ? (uint32_t)car : key[car]; }
+
+  // Kendaraan lajur l = [getLaneBegin(l), getLaneBegin(l + 1))
+  int getLaneCount() const { return (int)laneBegin.size() - 1; }
+  int getLaneBegin(int lane) const { return (int)laneBegin[lane]; }
+  uint32_t getLength(VehicleType t) const { return length[t]; }
+
+  const uint32_t* positions() const { return position.data(); }
+  const uint8_t* velocities() const { return velocity.data(); }
+
+  // Posisi di antara dua step CA untuk render: t = 0 sebelum step terakhir,
+  // t = 1 sesudahnya (posisi sebelum = position - velocity, melingkar)
+  float interpolated(int car, float t) const {
+    float d = (float)position[car] - (float)velocity[car] * (1.0f - t);
+    return (d < 0.0f) ? d + (float)ringLength : d;
+  }
+
+private:
+  uint32_t ringLength = 1;
+  std::vector<uint32_t> laneBegin;  // numLanes + 1, lajur l = [laneBegin[l], laneBegin[l + 1])
+
+  std::vector<uint32_t> position;
+  std::vector<uint8_t> velocity;
+  std::vector<uint8_t> type;
+  std::vector<uint32_t> key;  // Kunci random (kosong = indeks array)
+
+  // Tabel per jenis kendaraan
+  uint8_t maxVelocity[VEHICLE_TYPE_COUNT] = {};
+  uint32_t length[VEHICLE_TYPE_COUNT] = {};
+  uint32_t slowThreshold[VEHICLE_TYPE_COUNT] = {};  // probSlow * 2^24
+
+  // Varian aturan aktif
+  using StepFn = void (IntegerNaSch::*)(const CounterRng&, uint64_t);
+  StepFn stepFn = &IntegerNaSch::stepWith<ConstantRandomization, NoSlowToStart, PlainBrake>;
+  RuleParams params;
+
+  // Hanya untuk varian (kosong di NaSch dasar): velocity step lalu, gap semua kendaraan
+  std::vector<uint8_t> previous;
+  std::vector<int32_t> gaps;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * NaSchRules - Varian aturan NaSch per track (dari scenario "rules")
+ *
+ * - velocityDependent (VDR, Barlovic et al.): kendaraan yang diam di step
+ *   sebelumnya memakai probSlowStopped, bukan probSlow → jam metastabil
+ * - slowToStart (T², Takayasu): kendaraan diam dengan gap <= slowToStartGap
+ *   baru mulai jalan dengan probabilitas 1 - probSlowToStart
+ * - anticipation: gap ditambah perkiraan gerak kendaraan depan,
+ *   max(min(v depan, gap depan) - anticipationSafety, 0)
+ *
+ * Probabilitas per step CA (seperti probSlow), sama untuk semua jenis
+ * kendaraan. anticipationSafety >= 1 menjamin tidak ada tabrakan: kendaraan
+ * depan paling banyak melambat 1 dari perkiraan itu.
+ */
+struct NaSchRules {
+  bool velocityDependent = false;
+  float probSlowStopped = 0.5f;
+  bool slowToStart = false;
+  float probSlowToStart = 0.5f;
+  int slowToStartGap = 1;
+  bool anticipation = false;
+  int anticipationSafety = 1;
+
+  bool any() const { return velocityDependent || slowToStart || anticipation; }
+
+  bool operator==(const NaSchRules& o) const {
+    return velocityDependent == o.velocityDependent && probSlowStopped == o.probSlowStopped &&
+           slowToStart == o.slowToStart && probSlowToStart == o.probSlowToStart &&
+           slowToStartGap == o.slowToStartGap && anticipation == o.anticipation &&
+           anticipationSafety == o.anticipationSafety;
+  }
+  bool operator!=(const NaSchRules& o) const { return !(*this == o); }
+};
+
+// Probabilitas → threshold 24 bit: (CounterRng::bits >> 40) < threshold ⇔ uniform() < p
+inline uint32_t probabilityThreshold(float p) {
+  return (uint32_t)(std::min(std::max(p, 0.0f), 1.0f) * 16777216.0f);
+}
+
+/**
+ * RuleParams - NaSchRules dalam bentuk yang dipakai kernel (threshold integer)
+ */
+struct RuleParams {
+  uint32_t stoppedThreshold = 0;
+  uint32_t slowToStartThreshold = 0;
+  int32_t slowToStartGap = 1;
+  int32_t anticipationSafety = 1;
+
+  explicit RuleParams(const NaSchRules& r = NaSchRules())
+      : stoppedThreshold(probabilityThreshold(r.probSlowStopped)),
+        slowToStartThreshold(probabilityThreshold(r.probSlowToStart)),
+        slowToStartGap(r.slowToStartGap), anticipationSafety(std::max(1, r.anticipationSafety)) {}
+};
+
+/**
+ * Policy compile-time untuk IntegerNaSch::stepWith<Randomization, Start, Brake>
+ *
+ * Tanpa state (parameter dari RuleParams). Flag constexpr menentukan
+ * array yang disiapkan kernel sebelum step:
+ * - USES_PREVIOUS_VELOCITY / ENABLED / USES_LEADER → salinan velocity step lalu
+ * - Start::ENABLED / Brake::USES_LEADER           → gap semua kendaraan
+ * Kombinasi dasar <ConstantRandomization, NoSlowToStart, PlainBrake> tidak
+ * butuh keduanya: kernelnya sama dengan NaSch tanpa varian.
+ */
+
+// Aturan 3: probabilitas random braking per jenis kendaraan (NaSch dasar)
+struct ConstantRandomization {
+  static constexpr bool USES_PREVIOUS_VELOCITY = false;
+  static uint32_t threshold(const RuleParams&, uint32_t typeThreshold, int32_t) { return typeThreshold; }
+};
+
+// VDR: kendaraan yang diam step lalu memakai threshold sendiri
+struct VelocityDependentRandomization {
+  static constexpr bool USES_PREVIOUS_VELOCITY = true;
+  static uint32_t threshold(const RuleParams& p, uint32_t typeThreshold, int32_t previousVelocity) {
+    return (previousVelocity == 0) ? p.stoppedThreshold : typeThreshold;
+  }
+};
+
+// Kendaraan diam langsung jalan kalau ada gap
+struct NoSlowToStart {
+  static constexpr bool ENABLED = false;
+};
+
+// T²: kendaraan diam yang baru dapat gap kecil tertahan dengan probabilitas
+struct SlowToStart {
+  static constexpr bool ENABLED = true;
+  static bool applies(const RuleParams& p, int32_t previousVelocity, int32_t gap) {
+    return previousVelocity == 0 && gap <= p.slowToStartGap;
+  }
+};
+
+// Aturan 2: velocity dibatasi gap ke ekor kendaraan depan
+struct PlainBrake {
+  static constexpr bool USES_LEADER = false;
+  static int32_t effectiveGap(const RuleParams&, int32_t gap, int32_t, int32_t) { return gap; }
+};
+
+// Anticipation: kendaraan depan pasti maju >= min(v depan, gap depan) - 1
+struct AnticipationBrake {
+  static constexpr bool USES_LEADER = true;
+  static int32_t effectiveGap(const RuleParams& p, int32_t gap, int32_t leaderVelocity, int32_t leaderGap) {
+    int32_t anticipated = std::min(leaderVelocity, leaderGap);
+    return gap + std::max(anticipated - p.anticipationSafety, 0);
+  }
+};
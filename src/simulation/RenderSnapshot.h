@@ -0,0 +1,82 @@
+#pragma once
+#include "ofMain.h"
+#include <cstdint>
+#include <vector>
+
+using glm::vec2;
+using glm::vec3;
+
+/**
+ * TrackSnapshot - Semua yang dibutuhkan draw() dari satu track di satu step
+ *
+ * Diisi thread simulasi (TrackInstance::fillSnapshot), dibaca thread
+ * render. Posisi sudah dalam koordinat layar (lajur + arah sudah
+ * diterapkan), jadi render tidak perlu mengakses Road atau Vehicle.
+ *
+ * Data kendaraan disimpan SoA; body point kendaraan i ada di
+ * bodyPoints[bodyOffset[i] .. bodyOffset[i + 1]).
+ */
+struct TrackSnapshot {
+  // Parameter render track (disalin dari TrackInstance tiap step)
+  vec2 center;
+  bool spiral = false;
+  bool visible = true;
+  bool drawFromCenter = true;
+  bool gradientMode = false;
+  bool macro = false;  // Physics macro: tidak ada kendaraan (hybrid: false, ada kendaraan micro)
+  int numLinesPerCar = 0;
+  float curveIntensity = 0.0f;
+  float curveAngle1 = 0.0f;
+  float curveAngle2 = 0.0f;
+
+  // Per kendaraan
+  std::vector<vec2> position;      // Titik kepala di lajur (ujung garis bezier)
+  std::vector<vec2> tangent;       // Arah road di posisi kepala (orientasi mobil)
+  std::vector<vec3> color;
+  std::vector<float> velocity;
+  std::vector<float> drawSize;     // Radius lingkaran mobil (pixels)
+  std::vector<uint8_t> blackHole;  // 1 = di GAP area SpiralRoad (digambar hitam)
+  std::vector<uint32_t> bodyOffset;
+  std::vector<vec2> bodyPoints;
+
+  // Physics macro / hybrid: bin b = segmen road dari
+  // densityPoints[b] ke densityPoints[b + 1], density[b] = n / N (0 .. 1,
+  // -1 = region micro track hybrid, tidak digambar)
+  std::vector<vec2> densityPoints;
+  std::vector<float> density;
+  float densityWidth = 0.0f;  // Tebal garis (pixels, semua lajur)
+
+  int size() const { return (int)position.size(); }
+
+  // Kosongkan array tanpa melepas kapasitas
+  void clear() {
+    position.clear();
+    tangent.clear();
+    color.clear();
+    velocity.clear();
+    drawSize.clear();
+    blackHole.clear();
+    bodyOffset.clear();
+    bodyPoints.clear();
+    densityPoints.clear();
+    density.clear();
+  }
+};
+
+/**
+ * RenderSnapshot - State satu step simulasi untuk render
+ *
+ * Dipublikasikan lewat TripleBuffer: setelah publish() isinya tidak
+ * diubah lagi sampai render selesai memakainya.
+ */
+struct RenderSnapshot {
+  uint64_t step = 0;
+  bool networkMode = false;
+  bool replayMode = false;
+  std::vector<TrackSnapshot> tracks;
+
+  // Network mode: garis edge (pasangan titik) + kendaraan
+  std::vector<vec2> networkLines;
+  std::vector<vec2> networkPositions;
+  std::vector<ofFloatColor> networkColors;
+};
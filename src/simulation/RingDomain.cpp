@@ -0,0 +1,247 @@
+#include "RingDomain.h"
+#include "SpawnSequence.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+static_assert(sizeof(RingDomain::Record) == 12, "Record dikirim apa adanya antar proses");
+
+namespace {
+
+// vmax CA jenis kendaraan, sama dengan TrackInstance::syncIntegerPhysics
+int caMaxVelocity(const RingDomainSpec& spec, const VehicleSpec& vehicle) {
+  return (int)std::lround(spec.maxV * vehicle.maxVScale * spec.caInterval);
+}
+
+RingDomain::Record recordOf(const IntegerNaSch& ca, int car) {
+  RingDomain::Record r = {};
+  r.position = ca.getPosition(car);
+  r.key = ca.getKey(car);
+  r.velocity = (uint8_t)ca.getVelocity(car);
+  r.type = (uint8_t)ca.getType(car);
+  return r;
+}
+
+}  // namespace
+
+uint32_t RingDomain::haloCells(const RingDomainSpec& spec) {
+  // Jenis yang bisa muncul: bobot fleetMix > 0 (sedan kalau semua 0)
+  int vmax = 1;
+  int longest = 0;
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    if (spec.fleetMix[k] <= 0.0f && k != VEHICLE_SEDAN) continue;
+    const VehicleSpec& vehicle = VEHICLE_SPECS[k];
+    vmax = std::max(vmax, std::min(caMaxVelocity(spec, vehicle), (int)IntegerNaSch::MAX_VELOCITY));
+    longest = std::max(longest, vehicle.length);
+  }
+
+  // Gap >= vmax tidak membatasi velocity; slow-to-start masih melihat gap
+  // sampai slowToStartGap
+  int reach = vmax;
+  if (spec.rules.slowToStart) reach = std::max(reach, spec.rules.slowToStartGap + 1);
+  uint32_t cells = (uint32_t)(reach + longest);
+  return spec.rules.anticipation ? cells * 2 : cells;
+}
+
+uint32_t RingDomain::domainBegin(uint32_t maxCells, int rank, int domainCount) {
+  return (uint32_t)((uint64_t)maxCells * (uint64_t)rank / (uint64_t)domainCount);
+}
+
+bool RingDomain::validate(const RingDomainSpec& spec, int domainCount, std::string& error) {
+  if (domainCount < 1) {
+    error = "Jumlah domain minimal 1";
+    return false;
+  }
+
+  if (domainCount > 1) {
+    const uint32_t minimum = 2 * haloCells(spec);
+    for (int r = 0; r < domainCount; r++) {
+      const uint32_t cells = domainBegin(spec.maxCells, r + 1, domainCount) - domainBegin(spec.maxCells, r, domainCount);
+      if (cells < minimum) {
+        error = "Domain " + std::to_string(r) + " hanya " + std::to_string(cells) + " cell, minimal " +
+                std::to_string(minimum) + " (2 x halo); kurangi jumlah domain";
+        return false;
+      }
+    }
+  }
+
+  // Urutan kendaraan = urutan posisi hanya kalau spawn tidak melewati ujung ring
+  CounterRng rng(spec.seed);
+  for (int lane = 0; lane < spec.numLanes && spec.numCars > 0; lane++) {
+    SpawnSequence spawn(rng, spec.fleetMix, spec.spacing, lane);
+    for (int i = 0; i < spec.numCars; i++) {
+      spawn.next();
+    }
+    if ((uint32_t)std::max(0.0f, spawn.getDistance()) >= spec.maxCells) {
+      error = "Kendaraan awal lajur " + std::to_string(lane) + " melewati maxCells (numCars x spacing terlalu besar)";
+      return false;
+    }
+  }
+  return true;
+}
+
+void RingDomain::configure(IntegerNaSch& target) const {
+  target.reset(spec.maxCells, spec.numLanes);
+  target.setRules(spec.rules);
+  for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+    const VehicleSpec& vehicle = VEHICLE_SPECS[k];
+    target.setType((VehicleType)k, caMaxVelocity(spec, vehicle), vehicle.length,
+                   spec.probSlow * vehicle.probSlowScale);
+  }
+}
+
+void RingDomain::setup(const RingDomainSpec& domainSpec, int domainRank, int count) {
+  spec = domainSpec;
+  spec.numLanes = std::max(1, spec.numLanes);
+  spec.caInterval = std::max(1, spec.caInterval);
+  rng = CounterRng(spec.seed);
+  rank = domainRank;
+  domainCount = count;
+  begin = domainBegin(spec.maxCells, rank, count);
+  length = domainBegin(spec.maxCells, rank + 1, count) - begin;
+  halo = haloCells(spec);
+  caPhase = 0;
+
+  configure(ca);
+  configure(spare);
+  owned.assign(spec.numLanes, 0);
+  leaving.assign(spec.numLanes, 0);
+  arriving.clear();
+  arrivingBegin.assign(spec.numLanes + 1, 0);
+  ghosts.clear();
+  ghostBegin.assign(spec.numLanes + 1, 0);
+
+  // Semua kendaraan track dihitung ulang (tanpa disimpan), hanya yang
+  // kepalanya di domain ini yang masuk. Kunci = indeks di track utuh
+  const int startVelocity = (int)std::lround(SpawnSequence::START_VELOCITY * spec.caInterval);
+  for (int lane = 0; lane < spec.numLanes; lane++) {
+    SpawnSequence spawn(rng, spec.fleetMix, spec.spacing, lane);
+    for (int i = 0; i < spec.numCars; i++) {
+      spawn.next();
+      const uint32_t position = (uint32_t)std::max(0.0f, spawn.getDistance()) % spec.maxCells;
+      if (relative(position) >= length) continue;
+      ca.addCar(lane, position, startVelocity, spawn.getType(), (uint32_t)(lane * spec.numCars + i));
+      owned[lane]++;
+    }
+  }
+}
+
+int RingDomain::getOwnedCount() const {
+  int count = 0;
+  for (int n : owned) count += n;
+  return count;
+}
+
+bool RingDomain::step(DomainTransport& transport, uint64_t stepIndex) {
+  // Step CA di awal interval; di antaranya forEachOwned() hanya interpolasi
+  if (caPhase == 0) {
+    if (domainCount > 1 && !exchangeHalo(transport)) return false;
+    ca.step(rng, stepIndex);
+    if (domainCount > 1 && !handOff(transport)) return false;
+  }
+  caPhase = (caPhase + 1) % spec.caInterval;
+  return true;
+}
+
+bool RingDomain::exchangeHalo(DomainTransport& transport) {
+  const int previous = (rank + domainCount - 1) % domainCount;
+  const int next = (rank + 1) % domainCount;
+
+  // 1. Halo untuk rank sebelumnya: kendaraan di halo cell pertama domain,
+  //    urut dari belakang (kedatangan dulu, lalu owned yang tetap)
+  beginMessage();
+  for (int lane = 0; lane < spec.numLanes; lane++) {
+    bool inside = true;
+    for (uint32_t k = arrivingBegin[lane]; inside && k < arrivingBegin[lane + 1]; k++) {
+      inside = relative(arriving[k].position) < halo;
+      if (inside) appendRecord(lane, arriving[k]);
+    }
+    const int first = ca.getLaneBegin(lane);
+    const int kept = owned[lane] - leaving[lane];
+    for (int i = first; inside && i < first + kept; i++) {
+      inside = relative(ca.getPosition(i)) < halo;
+      if (inside) appendRecord(lane, recordOf(ca, i));
+    }
+  }
+  if (!transport.exchange(previous, outgoing.data(), outgoing.size(), next, incoming)) return false;
+  if (!readMessage(incoming, ghosts, ghostBegin)) return false;
+
+  // 2. Susun ulang per lajur: kedatangan + owned yang tetap + ghost
+  spare.reset(spec.maxCells, spec.numLanes);
+  for (int lane = 0; lane < spec.numLanes; lane++) {
+    for (uint32_t k = arrivingBegin[lane]; k < arrivingBegin[lane + 1]; k++) {
+      const Record& r = arriving[k];
+      spare.addCar(lane, r.position, r.velocity, (VehicleType)r.type, r.key);
+    }
+    const int first = ca.getLaneBegin(lane);
+    const int kept = owned[lane] - leaving[lane];
+    for (int i = first; i < first + kept; i++) {
+      spare.addCar(lane, ca.getPosition(i), ca.getVelocity(i), ca.getType(i), ca.getKey(i));
+    }
+    owned[lane] = (int)(arrivingBegin[lane + 1] - arrivingBegin[lane]) + kept;
+    leaving[lane] = 0;
+
+    for (uint32_t k = ghostBegin[lane]; k < ghostBegin[lane + 1]; k++) {
+      const Record& r = ghosts[k];
+      spare.addCar(lane, r.position, r.velocity, (VehicleType)r.type, r.key);
+    }
+  }
+  std::swap(ca, spare);
+  return true;
+}
+
+bool RingDomain::handOff(DomainTransport& transport) {
+  const int previous = (rank + domainCount - 1) % domainCount;
+  const int next = (rank + 1) % domainCount;
+
+  // Kendaraan tidak saling menyalip: yang lewat ujung domain = owned terakhir
+  beginMessage();
+  for (int lane = 0; lane < spec.numLanes; lane++) {
+    const int first = ca.getLaneBegin(lane);
+    const int end = first + owned[lane];
+    int i = end;
+    while (i > first && relative(ca.getPosition(i - 1)) >= length) {
+      i--;
+    }
+    leaving[lane] = end - i;
+    for (; i < end; i++) {
+      appendRecord(lane, recordOf(ca, i));
+    }
+  }
+  if (!transport.exchange(next, outgoing.data(), outgoing.size(), previous, incoming)) return false;
+  return readMessage(incoming, arriving, arrivingBegin);
+}
+
+void RingDomain::beginMessage() {
+  outgoing.assign((size_t)spec.numLanes * sizeof(uint32_t), 0);
+}
+
+void RingDomain::appendRecord(int lane, const Record& record) {
+  uint32_t count;
+  std::memcpy(&count, outgoing.data() + lane * sizeof(uint32_t), sizeof(count));
+  count++;
+  std::memcpy(outgoing.data() + lane * sizeof(uint32_t), &count, sizeof(count));
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+  outgoing.insert(outgoing.end(), bytes, bytes + sizeof(Record));
+}
+
+bool RingDomain::readMessage(const std::vector<uint8_t>& message, std::vector<Record>& records,
+                             std::vector<uint32_t>& laneBegin) const {
+  const size_t headerBytes = (size_t)spec.numLanes * sizeof(uint32_t);
+  if (message.size() < headerBytes) return false;
+
+  laneBegin.assign(spec.numLanes + 1, 0);
+  for (int lane = 0; lane < spec.numLanes; lane++) {
+    uint32_t count;
+    std::memcpy(&count, message.data() + lane * sizeof(uint32_t), sizeof(count));
+    laneBegin[lane + 1] = laneBegin[lane] + count;
+  }
+  const size_t count = laneBegin[spec.numLanes];
+  if (message.size() != headerBytes + count * sizeof(Record)) return false;
+
+  records.resize(count);
+  if (count > 0) std::memcpy(records.data(), message.data() + headerBytes, count * sizeof(Record));
+  return true;
+}
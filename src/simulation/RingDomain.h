@@ -0,0 +1,144 @@
+#pragma once
+#include "CounterRng.h"
+#include "DomainTransport.h"
+#include "IntegerNaSch.h"
+#include "NaSchRules.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * RingDomainSpec - Satu track physics integer yang dipecah ke beberapa proses
+ *
+ * Field yang menentukan kendaraan awal dan aturan CA, sama dengan yang
+ * dipakai TrackInstance::setup() + syncIntegerPhysics() (dari TrackConfig).
+ */
+struct RingDomainSpec {
+  uint32_t maxCells = 1500;
+  int numLanes = 1;
+  int numCars = 20;       // Per lajur
+  int spacing = 50;
+  float fleetMix[VEHICLE_TYPE_COUNT] = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  float maxV = 20.0f;     // Cells per step simulasi
+  float probSlow = 0.03f;
+  int caInterval = 1;
+  NaSchRules rules;
+  uint64_t seed = 1;      // Seed CounterRng track
+};
+
+/**
+ * RingDomain - Potongan [begin, begin + length) satu ring IntegerNaSch
+ *
+ * Ring maxCells dibagi rata ke domainCount rank; tiap rank hanya menyimpan
+ * kendaraan yang kepalanya di domainnya. Tiap step CA:
+ *
+ * 1. Halo: kendaraan di haloCells() cell pertama domain dikirim ke rank
+ *    sebelumnya, kendaraan rank berikutnya diterima sebagai ghost di ujung
+ *    tiap lajur. Kendaraan depan kendaraan terakhir domain = ghost pertama
+ * 2. Step CA lokal (ghost ikut dihitung, hasilnya dibuang)
+ * 3. Handoff: kendaraan yang lewat ujung domain dikirim ke rank berikutnya
+ *    dan jadi kendaraan pertama lajurnya di step CA berikutnya
+ *
+ * Hasil identik dengan satu IntegerNaSch untuk seluruh ring:
+ * - random per kendaraan dari kunci = indeks kendaraan di track utuh
+ *   (urutan lajur + spawn, tidak pernah berubah karena tidak ada yang
+ *   menyalip), bukan indeks array lokal
+ * - halo = vmax + kendaraan terpanjang (+ gap slow-to-start): kendaraan
+ *   depan di luar halo tidak bisa membatasi velocity. Anticipation memakai
+ *   gap kendaraan depan juga, jadi halonya dua kali lipat
+ * - domain minimal dua kali halo (validate()), jadi ghost hanya dari rank
+ *   berikutnya dan kendaraan melewati paling banyak satu batas per step
+ *
+ * Hanya physics integer: kendaraan float membawa strategy, lane change dan
+ * body per kendaraan, dan physics macro sudah tidak bergantung jumlah
+ * kendaraan. SpiralRoad (black hole dari posisi layar) tidak didukung.
+ */
+class RingDomain {
+public:
+  // Satu kendaraan di pesan halo / handoff (12 byte, tanpa padding implisit)
+  struct Record {
+    uint32_t position;
+    uint32_t key;
+    uint8_t velocity;
+    uint8_t type;
+    uint8_t reserved[2];
+  };
+
+  // vmax CA kendaraan tercepat + kendaraan terpanjang (lihat di atas)
+  static uint32_t haloCells(const RingDomainSpec& spec);
+
+  // Cell pertama domain rank (rank = domainCount → maxCells)
+  static uint32_t domainBegin(uint32_t maxCells, int rank, int domainCount);
+
+  // Syarat dekomposisi: domain >= 2 x halo, kendaraan awal tidak melewati maxCells
+  static bool validate(const RingDomainSpec& spec, int domainCount, std::string& error);
+
+  // Kendaraan awal domain rank (spawn sama dengan TrackInstance::setup)
+  void setup(const RingDomainSpec& spec, int rank, int domainCount);
+
+  // Satu step simulasi. Step CA (dengan tukar halo + handoff) tiap caInterval step
+  bool step(DomainTransport& transport, uint64_t stepIndex);
+
+  /**
+   * Kendaraan milik domain setelah step terakhir (tanpa ghost, termasuk
+   * yang baru dikirim ke rank berikutnya): fn(key, distance, velocity, lane,
+   * type) dengan distance / velocity sama seperti Vehicle di TrackInstance
+   */
+  template <typename Fn>
+  void forEachOwned(Fn fn) const {
+    const float t = (caPhase == 0) ? 1.0f : caPhase / (float)spec.caInterval;
+    const float perStep = 1.0f / spec.caInterval;
+    for (int lane = 0; lane < spec.numLanes; lane++) {
+      const int first = ca.getLaneBegin(lane);
+      for (int i = first; i < first + owned[lane]; i++) {
+        fn(ca.getKey(i), ca.interpolated(i, t), ca.getVelocity(i) * perStep, lane, ca.getType(i));
+      }
+    }
+  }
+
+  int getOwnedCount() const;
+  uint32_t getBegin() const { return begin; }
+  uint32_t getLength() const { return length; }
+
+private:
+  RingDomainSpec spec;
+  CounterRng rng;
+  int rank = 0;
+  int domainCount = 1;
+  uint32_t begin = 0;
+  uint32_t length = 0;
+  uint32_t halo = 0;
+  int caPhase = 0;
+
+  // ca: per lajur [owned kendaraan milik domain | ghost dari rank berikutnya].
+  // spare: buffer susun ulang tiap step CA (ditukar dengan ca)
+  IntegerNaSch ca;
+  IntegerNaSch spare;
+  std::vector<int> owned;    // Per lajur
+  std::vector<int> leaving;  // Per lajur: owned terakhir yang sudah lewat ujung domain
+
+  // Kedatangan dari rank sebelumnya (handoff step CA lalu) dan ghost dari
+  // rank berikutnya, urut lajur: lajur l = [begin[l], begin[l + 1])
+  std::vector<Record> arriving;
+  std::vector<uint32_t> arrivingBegin;
+  std::vector<Record> ghosts;
+  std::vector<uint32_t> ghostBegin;
+
+  std::vector<uint8_t> outgoing;
+  std::vector<uint8_t> incoming;
+
+  // Posisi relatif terhadap awal domain, [0, maxCells)
+  uint32_t relative(uint32_t position) const {
+    return (position >= begin) ? position - begin : position + spec.maxCells - begin;
+  }
+
+  void configure(IntegerNaSch& target) const;
+  bool exchangeHalo(DomainTransport& transport);
+  bool handOff(DomainTransport& transport);
+
+  // Pesan: uint32 jumlah per lajur, lalu Record urut lajur
+  void beginMessage();
+  void appendRecord(int lane, const Record& record);
+  bool readMessage(const std::vector<uint8_t>& message, std::vector<Record>& records,
+                   std::vector<uint32_t>& laneBegin) const;
+};
@@ -0,0 +1,97 @@
+#include "SegmentFollower.h"
+#include <algorithm>
+#include <cmath>
+
+void SegmentFollower::reset(int count) {
+  segmentCount = std::max(1, count);
+  carCount = 0;
+  stride = 0;
+  distances.clear();
+  spacing.assign(segmentCount, 0.0f);
+}
+
+void SegmentFollower::reserveCars(size_t count) {
+  if (count <= stride) return;
+
+  // Kapasitas tumbuh 2x supaya addCar() berulang tetap linear
+  size_t newStride = std::max<size_t>(std::max<size_t>(count, stride * 2), 16);
+  std::vector<float> grown((size_t)segmentCount * newStride, 0.0f);
+  for (int j = 0; j < segmentCount; j++) {
+    std::copy(row(j), row(j) + carCount, grown.data() + (size_t)j * newStride);
+  }
+  distances.swap(grown);
+  stride = newStride;
+}
+
+void SegmentFollower::addCar(float headDistance) {
+  reserveCars(carCount + 1);
+  for (int j = 0; j < segmentCount; j++) {
+    // Awalnya berjejer ke belakang dari head
+    row(j)[carCount] = headDistance - (j * 2.0f);
+  }
+  carCount++;
+}
+
+void SegmentFollower::addCar(const float* segments, int count) {
+  reserveCars(carCount + 1);
+  for (int j = 0; j < segmentCount; j++) {
+    row(j)[carCount] = (j < count) ? segments[j] : 0.0f;
+  }
+  carCount++;
+}
+
+void SegmentFollower::truncate(int count) {
+  carCount = std::max(0, std::min(count, carCount));
+}
+
+void SegmentFollower::copyCar(int car, float* out) const {
+  for (int j = 0; j < segmentCount; j++) {
+    out[j] = row(j)[car];
+  }
+}
+
+void SegmentFollower::step(float time, float ringLength) {
+  if (carCount == 0) return;
+  if ((int)spacing.size() != segmentCount) spacing.assign(segmentCount, 0.0f);
+
+  // Gelombang spacing tidak bergantung pada kendaraan: sekali per step
+  spacingWave(time, segmentCount, spacing.data());
+  follow(distances.data(), stride, carCount, segmentCount, spacing.data(), ringLength);
+}
+
+void SegmentFollower::spacingWave(float time, int count, float* out) {
+  if (count > 0) out[0] = 0.0f;  // Head tidak mengikuti siapa-siapa
+  for (int j = 1; j < count; j++) {
+    out[j] = 5.0f + std::sin(time - j * 0.5f) * 2.0f;
+  }
+}
+
+void SegmentFollower::follow(float* rows, size_t stride, int carCount, int segmentCount,
+                             const float* spacing, float ringLength) {
+  const float half = ringLength / 2.0f;
+
+  for (int j = 1; j < segmentCount; j++) {
+    const float* leader = rows + (size_t)(j - 1) * stride;
+    float* follower = rows + (size_t)j * stride;
+    const float target = spacing[j];
+
+    // Wrap tanpa branch: hasil compare jadi mask int 0/1 lalu dikali
+    // ringLength, supaya loop ini jadi SIMD (compare + convert + add)
+    for (int i = 0; i < carCount; i++) {
+      float diff = leader[i] - follower[i];
+      int wrapUp = diff < -half;
+      diff += ringLength * (float)wrapUp;
+      int wrapDown = diff > half;
+      diff -= ringLength * (float)wrapDown;
+
+      float d = follower[i] + (diff - target) * 0.2f;
+
+      // Range check
+      int over = d >= ringLength;
+      d -= ringLength * (float)over;
+      int under = d < 0.0f;
+      d += ringLength * (float)under;
+      follower[i] = d;
+    }
+  }
+}
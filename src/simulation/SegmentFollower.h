@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * SegmentFollower - Physics body "ular" semua kendaraan satu track sekaligus
+ *
+ * Tiap kendaraan punya segmentCount distance (index 0 = HEAD, terakhir =
+ * TAIL). Segment j mengejar segment j - 1 sampai jaraknya mendekati
+ * spacing[j] (gelombang 5 ± 2 cell yang sama untuk SEMUA kendaraan).
+ *
+ * Layout segment-major: distance segment j kendaraan i ada di
+ * row(j)[i], jadi satu baris = segment yang sama dari semua kendaraan
+ * berurutan di memory. Kernel follow() berjalan per baris (j bergantung
+ * pada j - 1 yang sudah di-update), dan loop dalam per kendaraan tanpa
+ * branch sehingga bisa di-vectorize compiler. Biaya = segmentCount *
+ * carCount, linear di kedua arah.
+ *
+ * Urutan kendaraan sama dengan TrackInstance::traffic: setiap kali
+ * traffic ditambah / dihapus, SegmentFollower harus ikut (addCar,
+ * compact, truncate).
+ */
+class SegmentFollower {
+public:
+  static const int DEFAULT_SEGMENTS = 15;
+
+  // Fase gelombang spacing per step (6 rad/detik pada 60 step/detik)
+  static constexpr float WAVE_PHASE_PER_STEP = 0.1f;
+
+  // Kosongkan semua kendaraan dan pakai jumlah segment baru
+  void reset(int segmentCount);
+
+  // Tambah kendaraan di akhir; segment awal berjejer ke belakang dari head
+  void addCar(float headDistance);
+
+  // Tambah kendaraan dengan distance segment dari snapshot (count <= segmentCount)
+  void addCar(const float* segments, int count);
+
+  // Hapus kendaraan i yang remove(i) == true; urutan sisanya tetap
+  template <typename RemoveFn>
+  void compact(RemoveFn remove) {
+    int kept = carCount;
+    for (int j = 0; j < segmentCount; j++) {
+      float* r = row(j);
+      kept = 0;
+      for (int i = 0; i < carCount; i++) {
+        if (!remove(i)) r[kept++] = r[i];
+      }
+    }
+    carCount = kept;
+  }
+
+  // Buang kendaraan di indeks >= count
+  void truncate(int count);
+
+  /**
+   * Satu step follow semua kendaraan
+   * @param time       Fase gelombang spacing (sama untuk semua kendaraan)
+   * @param ringLength Panjang ring (maxCells), untuk wrap distance
+   *
+   * Row 0 (head) harus sudah diisi distance kendaraan sebelum dipanggil.
+   */
+  void step(float time, float ringLength);
+
+  int getCarCount() const { return carCount; }
+  int getSegmentCount() const { return segmentCount; }
+
+  float* row(int segment) { return distances.data() + (size_t)segment * stride; }
+  const float* row(int segment) const { return distances.data() + (size_t)segment * stride; }
+  float at(int car, int segment) const { return row(segment)[car]; }
+
+  // Salin distance segment kendaraan i ke out[0 .. segmentCount)
+  void copyCar(int car, float* out) const;
+
+  /**
+   * Kernel (tanpa state): spacing[j] = 5 + sin(time - 0.5 j) * 2 untuk j >= 1
+   */
+  static void spacingWave(float time, int segmentCount, float* spacing);
+
+  /**
+   * Kernel (tanpa state): follow row 1..segmentCount-1 untuk carCount kendaraan
+   * @param rows   Baris segment-major, baris j di rows + j * stride
+   */
+  static void follow(float* rows, size_t stride, int carCount, int segmentCount,
+                     const float* spacing, float ringLength);
+
+private:
+  std::vector<float> distances;  // segmentCount baris x stride
+  std::vector<float> spacing;    // Gelombang spacing step ini (per segment)
+  size_t stride = 0;             // Kapasitas kendaraan per baris
+  int carCount = 0;
+  int segmentCount = DEFAULT_SEGMENTS;
+
+  void reserveCars(size_t count);
+};
@@ -0,0 +1,201 @@
+#include "SparseOccupancy.h"
+#include "../entities/Vehicle.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// Lebih dari ini run menaik per lajur (urutan rusak, bukan hanya wrap /
+// pindah lajur) → std::sort lebih murah daripada merge berulang
+const int MAX_MERGE_RUNS = 8;
+
+}  // namespace
+
+void SparseOccupancy::reset(int numLanes, int ringLength) {
+  this->ringLength = std::max(1, ringLength);
+  wall = -1;
+  longest = 1;
+  entries.clear();
+  slot.clear();
+  laneBegin.assign((size_t)std::max(1, numLanes) + 1, 0);
+}
+
+void SparseOccupancy::rebuild(const std::vector<std::shared_ptr<Vehicle>> &traffic) {
+  const int lanes = getLaneCount();
+  const size_t n = traffic.size();
+
+  // 1. Entry + lajur per kendaraan. Jumlah sama dengan rebuild lalu →
+  //    entries masih permutasi indeks traffic, urutannya dipakai ulang
+  //    (sudah hampir terurut); kalau tidak, urutan traffic
+  const bool reuse = (entries.size() == n);
+  next.resize(n);
+  merged.resize(n);
+  fill.assign(lanes, 0);
+  nextBegin.assign(lanes + 1, 0);
+  longest = 1;
+
+  for (size_t k = 0; k < n; k++) {
+    const int32_t index = reuse ? entries[k].index : (int32_t)k;
+    const Vehicle &vehicle = *traffic[index];
+    Entry &e = next[k];
+    e.head = wrap((int)vehicle.getDistance());
+    e.length = std::min(vehicle.getLength(), ringLength);
+    e.index = index;
+    longest = std::max(longest, e.length);
+    nextBegin[std::min(std::max(vehicle.getLane(), 0), lanes - 1) + 1]++;
+  }
+  for (int l = 0; l < lanes; l++) {
+    nextBegin[l + 1] += nextBegin[l];
+  }
+
+  // 2. Bucket per lajur (stabil: urutan lama tetap dalam lajur) ke merged,
+  //    lalu tiap lajur diurutkan di tempat
+  for (size_t k = 0; k < n; k++) {
+    const int lane = std::min(std::max(traffic[next[k].index]->getLane(), 0), lanes - 1);
+    merged[nextBegin[lane] + fill[lane]++] = next[k];
+  }
+  next.swap(merged);
+  for (int l = 0; l < lanes; l++) {
+    sortLane(nextBegin[l], nextBegin[l + 1]);
+  }
+
+  entries.swap(next);
+  laneBegin.swap(nextBegin);
+  slot.resize(n);
+  for (size_t p = 0; p < n; p++) {
+    slot[entries[p].index] = (uint32_t)p;
+  }
+}
+
+void SparseOccupancy::sortLane(uint32_t begin, uint32_t end) {
+  Entry *a = next.data();
+  auto byHead = [](const Entry &x, const Entry &y) { return x.head < y.head; };
+
+  int runs = 1;
+  for (uint32_t i = begin + 1; i < end; i++) {
+    runs += a[i].head < a[i - 1].head;
+  }
+  if (runs == 1) return;
+  if (runs > MAX_MERGE_RUNS) {
+    std::sort(a + begin, a + end, byHead);
+    return;
+  }
+
+  // Run pertama digabung dengan run berikutnya satu per satu (biasanya
+  // hanya 2-3 run: kendaraan yang wrap, kendaraan dari lajur tetangga)
+  uint32_t sorted = begin + 1;
+  while (sorted < end && a[sorted].head >= a[sorted - 1].head) sorted++;
+  while (sorted < end) {
+    uint32_t runEnd = sorted + 1;
+    while (runEnd < end && a[runEnd].head >= a[runEnd - 1].head) runEnd++;
+    Entry *out = merged.data() + begin;
+    std::merge(a + begin, a + sorted, a + sorted, a + runEnd, out, byHead);
+    std::copy(out, out + (runEnd - begin), a + begin);
+    sorted = runEnd;
+  }
+}
+
+int32_t SparseOccupancy::aheadOf(const Entry &e, int pos) const {
+  if (e.length <= 0) return INT32_MAX;
+  const int32_t relHead = wrap((int64_t)e.head - pos);
+  const int32_t relTail = wrap((int64_t)e.head - e.length + 1 - pos);
+  if (relTail == 0) return (relHead >= 1) ? 1 : INT32_MAX;  // Ekor tepat di pos
+  if (relTail <= relHead) return relTail;
+  return (relHead >= 1) ? 1 : relTail;  // Body melewati pos
+}
+
+int32_t SparseOccupancy::scanAhead(int lane, uint32_t first, int pos) const {
+  const uint32_t begin = laneBegin[lane];
+  const uint32_t count = laneBegin[lane + 1] - begin;
+
+  // Head menaik dari first: kendaraan dengan head - longest + 1 >= best
+  // (dan semua sesudahnya) tidak mungkin punya cell lebih dekat
+  int32_t best = INT32_MAX;
+  uint32_t k = first;
+  for (uint32_t visited = 0; visited < count; visited++) {
+    const Entry &e = entries[begin + k];
+    if ((int64_t)wrap((int64_t)e.head - pos) - longest + 1 >= best) break;
+    best = std::min(best, aheadOf(e, pos));
+    if (++k == count) k = 0;
+  }
+
+  if (wall >= 0) {
+    const int32_t d = wrap((int64_t)wall - pos);
+    best = std::min(best, (d == 0) ? ringLength : d);
+  }
+  return best;
+}
+
+uint32_t SparseOccupancy::upperBound(int lane, int pos) const {
+  const Entry *b = entries.data() + laneBegin[lane];
+  const Entry *e = entries.data() + laneBegin[lane + 1];
+  return (uint32_t)(std::upper_bound(b, e, pos, [](int p, const Entry &x) { return p < x.head; }) - b);
+}
+
+uint32_t SparseOccupancy::lowerBound(int lane, int pos) const {
+  const Entry *b = entries.data() + laneBegin[lane];
+  const Entry *e = entries.data() + laneBegin[lane + 1];
+  return (uint32_t)(std::lower_bound(b, e, pos, [](const Entry &x, int p) { return x.head < p; }) - b);
+}
+
+int SparseOccupancy::leaderDistance(int vehicle) const {
+  const uint32_t p = slot[vehicle];
+  int lane = 0;
+  while (laneBegin[lane + 1] <= p) lane++;
+
+  // Mulai dari kendaraan berikutnya di lajur; dirinya sendiri terakhir
+  const uint32_t begin = laneBegin[lane];
+  const uint32_t count = laneBegin[lane + 1] - begin;
+  return scanAhead(lane, (p - begin + 1) % count, entries[p].head);
+}
+
+int SparseOccupancy::distanceAhead(int lane, int pos, int limit) const {
+  pos = wrap(pos);
+  const uint32_t count = laneBegin[lane + 1] - laneBegin[lane];
+  const uint32_t first = (count > 0) ? upperBound(lane, pos) % count : 0;
+  const int32_t d = scanAhead(lane, first, pos);
+  return (d <= limit) ? d : limit + 1;
+}
+
+int SparseOccupancy::distanceBehind(int lane, int pos, int limit) const {
+  pos = wrap(pos);
+  const uint32_t begin = laneBegin[lane];
+  const uint32_t count = laneBegin[lane + 1] - begin;
+
+  // Jarak ke cell body pertama di belakang pos (kebalikan aheadOf)
+  auto behindOf = [&](const Entry &e) -> int32_t {
+    if (e.length <= 0) return INT32_MAX;
+    const int32_t relHead = wrap((int64_t)pos - e.head);
+    const int32_t relTail = wrap((int64_t)pos - e.head + e.length - 1);
+    if (relHead == 0) return (relTail >= 1) ? 1 : INT32_MAX;  // Head tepat di pos
+    if (relHead <= relTail) return relHead;
+    return (relTail >= 1) ? 1 : relHead;  // Body melewati pos
+  };
+
+  int32_t best = INT32_MAX;
+  if (count > 0) {
+    // Head terdekat di belakang pos: cell terdekat semua kendaraan di belakang
+    const uint32_t first = lowerBound(lane, pos);
+    best = behindOf(entries[begin + (first + count - 1) % count]);
+
+    // Kendaraan dengan head di pos .. pos + longest bisa menutupi pos - 1
+    uint32_t k = first % count;
+    for (uint32_t visited = 0; visited < count; visited++) {
+      const Entry &e = entries[begin + k];
+      if (wrap((int64_t)e.head - pos) >= longest) break;
+      best = std::min(best, behindOf(e));
+      if (++k == count) k = 0;
+    }
+  }
+
+  if (wall >= 0) {
+    const int32_t d = wrap((int64_t)pos - wall);
+    best = std::min(best, (d == 0) ? ringLength : d);
+  }
+  return (best <= limit) ? best : limit + 1;
+}
+
+size_t SparseOccupancy::getMemoryBytes() const {
+  return (entries.capacity() + next.capacity() + merged.capacity()) * sizeof(Entry) +
+         (slot.capacity() + laneBegin.capacity() + nextBegin.capacity() + fill.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Vehicle;
+
+/**
+ * SparseOccupancy - Pengganti grid per cell untuk road sangat panjang
+ *
+ * Grid dense (TrackInstance::grid) menyimpan satu int per cell per lajur:
+ * ring 16M cell = 64 MB per lajur walau kendaraannya sedikit. Di sini
+ * yang disimpan hanya kendaraan: per lajur array (head, length, index)
+ * terurut menurut head, ditambah slot tiap kendaraan di array itu.
+ * Memori ~40 byte per kendaraan (entry + buffer rebuild + slot), tidak
+ * bergantung pada panjang road.
+ *
+ * Jawaban query sama persis dengan scan grid (body = cell head - length + 1
+ * .. head, ditandai seperti rebuildGrid()):
+ * - leaderDistance(i): jarak ke cell terisi pertama di depan kendaraan i.
+ *   O(1): mulai dari slot i + 1, berhenti begitu head kendaraan berikutnya
+ *   tidak mungkin lebih dekat (head - panjang terpanjang)
+ * - distanceAhead / distanceBehind: sama dengan LaneChangeRule versi grid,
+ *   untuk posisi sembarang (binary search, O(log kendaraan per lajur))
+ *
+ * rebuild() tiap step O(n): di satu lajur kendaraan tidak saling menyalip,
+ * jadi urutan step lalu (head di-refresh) tinggal beberapa run terurut
+ * (kendaraan yang wrap lewat cell 0, yang pindah dari lajur tetangga) yang
+ * di-merge. Sort penuh hanya kalau jumlah kendaraan berubah (spawn, black
+ * hole, handoff hybrid) atau urutan rusak.
+ *
+ * Dinding (ujung region hybrid, GRID_WALL di grid dense) = satu cell
+ * terisi tanpa kendaraan di semua lajur.
+ */
+class SparseOccupancy {
+public:
+  // Scenario "occupancy": "auto" → sparse mulai numLanes * maxCells ini (grid 16 MB)
+  static const int64_t AUTO_MIN_CELLS = int64_t(1) << 22;
+
+  void reset(int numLanes, int ringLength);
+
+  // Semua kendaraan dari traffic (lajur, (int)distance, panjang), urutan indeks = traffic
+  void rebuild(const std::vector<std::shared_ptr<Vehicle>>& traffic);
+
+  // Cell dinding di semua lajur (-1 = tanpa dinding), berlaku langsung
+  void setWall(int cell) { wall = cell; }
+
+  // Jarak ke cell terisi pertama di depan head kendaraan (>= 1; ring kosong
+  // → ekornya sendiri setelah satu putaran)
+  int leaderDistance(int vehicle) const;
+
+  // Jarak (cell) ke cell terisi pertama di depan / belakang pos, maksimal
+  // limit. Return limit + 1 kalau tidak ada dalam jangkauan
+  int distanceAhead(int lane, int pos, int limit) const;
+  int distanceBehind(int lane, int pos, int limit) const;
+
+  int getLaneCount() const { return (int)laneBegin.size() - 1; }
+  int getRingLength() const { return ringLength; }
+  size_t getVehicleCount() const { return entries.size(); }
+  size_t getMemoryBytes() const;
+
+private:
+  struct Entry {
+    int32_t head;    // (int)distance % ringLength
+    int32_t length;  // min(panjang kendaraan, ringLength)
+    int32_t index;   // Indeks traffic
+  };
+
+  int ringLength = 1;
+  int wall = -1;
+  int32_t longest = 1;  // Panjang terpanjang di rebuild terakhir (batas scan)
+
+  std::vector<Entry> entries;        // Lajur l = [laneBegin[l], laneBegin[l + 1]), head menaik
+  std::vector<uint32_t> laneBegin;   // numLanes + 1
+  std::vector<uint32_t> slot;        // Per kendaraan: posisi di entries
+
+  // Buffer rebuild (dipakai ulang tiap step, tanpa alokasi setelah warm-up)
+  std::vector<Entry> next;
+  std::vector<Entry> merged;
+  std::vector<uint32_t> nextBegin;
+  std::vector<uint32_t> fill;
+
+  int wrap(int64_t cell) const {
+    int64_t c = cell % ringLength;
+    return (int)((c < 0) ? c + ringLength : c);
+  }
+
+  // Jarak ke cell body e pertama di depan pos (>= 1), INT32_MAX kalau body
+  // hanya di pos dan di belakangnya
+  int32_t aheadOf(const Entry& e, int pos) const;
+
+  // Scan lajur mulai entry ke-first (melingkar) untuk cell terisi pertama di depan pos
+  int32_t scanAhead(int lane, uint32_t first, int pos) const;
+
+  // Entry pertama dengan head > pos / >= pos di lajur (relatif laneBegin)
+  uint32_t upperBound(int lane, int pos) const;
+  uint32_t lowerBound(int lane, int pos) const;
+
+  // Urutkan lajur [begin, end) dari next: merge run menaik, sort kalau terlalu banyak
+  void sortLane(uint32_t begin, uint32_t end);
+};
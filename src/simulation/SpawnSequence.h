@@ -0,0 +1,70 @@
+#pragma once
+#include "../entities/VehicleSpec.h"
+#include "CounterRng.h"
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * SpawnSequence - Kendaraan awal satu lajur (jenis + distance) urut spawn
+ *
+ * Dipakai TrackInstance::setup() dan RingDomain: proses domain menghitung
+ * ulang urutan yang sama tanpa membuat kendaraan di luar domainnya.
+ * Distance dijumlahkan dalam float dengan urutan operasi yang sama,
+ * jadi hasilnya identik bit per bit di semua proses.
+ *
+ * - Kendaraan pertama lajur l di l * (spacing / 2), sisanya di belakang
+ *   kendaraan sebelumnya ditambah panjangnya sendiri
+ * - spacing dihitung untuk SedanCar; sisa jarak di luar panjang sedan
+ *   dipakai sebagai jarak bebas antar kendaraan semua jenis
+ * - Jenis dipilih acak sesuai bobot fleetMix (stream SPAWN, indeks
+ *   getSpawnIndex(); +1 .. +3 dipakai untuk warna)
+ */
+class SpawnSequence {
+public:
+  // Velocity awal kendaraan (selain SpiralRoad), cells per step
+  static constexpr float START_VELOCITY = 0.005f;
+
+  SpawnSequence(const CounterRng& rng, const float* fleetMix, int spacing, int lane)
+      : rng(rng), fleetMix(fleetMix), lane(lane),
+        freeSpacing(std::max(0, spacing - VEHICLE_SPECS[VEHICLE_SEDAN].length)),
+        distance((float)(lane * (spacing / 2))) {
+    for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+      mixTotal += fleetMix[k];
+    }
+  }
+
+  // Maju ke kendaraan berikutnya (panggil sekali sebelum kendaraan pertama)
+  void next() {
+    spawnIndex = (uint32_t)count * 4;
+    type = VEHICLE_SEDAN;
+    float pick = rng.uniform(CounterRng::STREAM_SPAWN, lane, spawnIndex) * mixTotal;
+    for (int k = 0; k < VEHICLE_TYPE_COUNT; k++) {
+      if (pick < fleetMix[k]) {
+        type = (VehicleType)k;
+        break;
+      }
+      pick -= fleetMix[k];
+    }
+
+    if (count > 0) {
+      distance += getVehicleSpec(type).length + freeSpacing;
+    }
+    count++;
+  }
+
+  VehicleType getType() const { return type; }
+  float getDistance() const { return distance; }
+  uint32_t getSpawnIndex() const { return spawnIndex; }
+
+private:
+  const CounterRng& rng;
+  const float* fleetMix;
+  float mixTotal = 0.0f;
+  int lane;
+  int freeSpacing;
+
+  int count = 0;
+  uint32_t spawnIndex = 0;
+  VehicleType type = VEHICLE_SEDAN;
+  float distance;
+};
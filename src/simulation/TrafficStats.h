@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * RunningStats - Mean & variance satu kali jalan (metode Welford)
+ *
+ * Tidak menyimpan sampel dan stabil secara numerik (tidak ada
+ * sum(x^2) - sum(x)^2 yang saling menghapus). merge() menggabungkan
+ * dua kelompok (Chan et al.), dipakai untuk agregat window dari
+ * statistik per step.
+ */
+struct RunningStats {
+  uint64_t count = 0;
+  double mean = 0.0;
+  double m2 = 0.0;  // Jumlah kuadrat selisih terhadap mean
+
+  void clear() {
+    count = 0;
+    mean = 0.0;
+    m2 = 0.0;
+  }
+
+  void add(double x) {
+    count++;
+    double delta = x - mean;
+    mean += delta / (double)count;
+    m2 += delta * (x - mean);
+  }
+
+  // Gabung kelompok lain (n sampel, mean, m2)
+  void merge(uint64_t n, double otherMean, double otherM2) {
+    if (n == 0) return;
+    if (count == 0) {
+      count = n;
+      mean = otherMean;
+      m2 = otherM2;
+      return;
+    }
+    uint64_t total = count + n;
+    double delta = otherMean - mean;
+    mean += delta * (double)n / (double)total;
+    m2 += otherM2 + delta * delta * (double)count * (double)n / (double)total;
+    count = total;
+  }
+
+  void merge(const RunningStats& o) { merge(o.count, o.mean, o.m2); }
+
+  // Satu blok sekaligus: mean & m2 blok dengan dua lintasan tanpa
+  // pembagian per elemen (add() punya rantai pembagian serial), lalu
+  // digabung seperti merge(). Hasil sama dengan add() per elemen
+  void addBlock(const float* x, size_t n) {
+    if (n == 0) return;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += x[i];
+    double blockMean = sum / (double)n;
+
+    double blockM2 = 0.0;
+    for (size_t i = 0; i < n; i++) {
+      double d = x[i] - blockMean;
+      blockM2 += d * d;
+    }
+    merge(n, blockMean, blockM2);
+  }
+
+  // Variance populasi (semua kendaraan step ini, bukan sampel)
+  double variance() const { return count > 0 ? m2 / (double)count : 0.0; }
+};
+
+/**
+ * TrackSample - Pengukuran lalu lintas satu track di satu step
+ *
+ * Diisi TrackInstance::update() setiap step (thread simulasi), POD
+ * supaya bisa dikirim lewat SpscQueue ke thread exporter tanpa alokasi.
+ */
+struct TrackSample {
+  uint64_t step = 0;
+  uint32_t track = 0;            // Indeks di ofApp::tracks
+  int cars = 0;
+  float density = 0.0f;          // Kendaraan per cell (semua lajur)
+  float flow = 0.0f;             // Kendaraan yang melewati detector step ini (CTM: pecahan)
+  float meanVelocity = 0.0f;     // Cells per step
+  float velocityVariance = 0.0f;
+  float stoppedFraction = 0.0f;  // Kendaraan dengan velocity < STOPPED_VELOCITY
+};
+
+/**
+ * Gabung dua bagian track yang sama (mis. micro + macro di track hybrid):
+ * cars, density, flow dijumlah; mean, variance, fraksi berhenti berbobot
+ * jumlah kendaraan (variance lewat RunningStats::merge). Caller memastikan
+ * flow hanya diisi bagian yang memuat detector.
+ */
+inline TrackSample combineSamples(const TrackSample& a, const TrackSample& b) {
+  RunningStats v;
+  v.merge((uint64_t)a.cars, a.meanVelocity, (double)a.velocityVariance * a.cars);
+  v.merge((uint64_t)b.cars, b.meanVelocity, (double)b.velocityVariance * b.cars);
+
+  TrackSample out = a;
+  const int cars = a.cars + b.cars;
+  out.cars = cars;
+  out.density = a.density + b.density;
+  out.flow = a.flow + b.flow;
+  out.meanVelocity = (float)v.mean;
+  out.velocityVariance = (float)v.variance();
+  out.stoppedFraction = (cars > 0) ? (a.stoppedFraction * a.cars + b.stoppedFraction * b.cars) / cars : 0.0f;
+  return out;
+}
+
+// Di bawah ini kendaraan dianggap berhenti (cells per step)
+const float STOPPED_VELOCITY = 0.01f;
+
+/**
+ * Detector virtual di cell detector: true kalau kendaraan bergerak dari
+ * before ke after (maju, wrap di ringLength) dan melewati / tepat
+ * sampai di detector. Kendaraan yang diam tepat di detector tidak
+ * dihitung berulang.
+ */
+inline bool crossesDetector(float before, float after, float detector, float ringLength) {
+  // Semua nilai sudah di [0, ringLength): cukup satu kali wrap (tanpa fmod)
+  float moved = after - before;
+  if (moved < 0.0f) moved += ringLength;
+  float ahead = detector - before;
+  if (ahead < 0.0f) ahead += ringLength;
+  return ahead > 0.0f && ahead <= moved;
+}
+
+/**
+ * Kernel (tanpa state): isi out dari array per kendaraan satu step
+ * @param before, after  Distance kendaraan sebelum / sesudah step (cells)
+ * @param velocity       Velocity kendaraan setelah step
+ * @param cells          Jumlah cell semua lajur (maxCells * numLanes), untuk density
+ *
+ * out.step dan out.track tidak diubah.
+ */
+inline void sampleTraffic(const float* before, const float* after, const float* velocity, int count,
+                          float ringLength, int cells, float detector, TrackSample& out) {
+  int stopped = 0;
+  int flow = 0;
+  for (int i = 0; i < count; i++) {
+    stopped += velocity[i] < STOPPED_VELOCITY;
+    flow += crossesDetector(before[i], after[i], detector, ringLength);
+  }
+
+  RunningStats v;
+  v.addBlock(velocity, (size_t)count);
+
+  out.cars = count;
+  out.density = (cells > 0) ? count / (float)cells : 0.0f;
+  out.flow = (float)flow;
+  out.meanVelocity = (float)v.mean;
+  out.velocityVariance = (float)v.variance();
+  out.stoppedFraction = (count > 0) ? stopped / (float)count : 0.0f;
+}
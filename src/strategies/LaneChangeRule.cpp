@@ -0,0 +1,131 @@
+#include "LaneChangeRule.h"
+#include "../entities/Vehicle.h"
+#include "../simulation/SparseOccupancy.h"
+#include <algorithm>
+
+LaneChangeRule::LaneChangeRule(Mode mode, float probChange)
+    : mode(mode), probChange(probChange) {}
+
+int LaneChangeRule::distanceAhead(const int *laneGrid, int maxCells, int pos, int limit) {
+  for (int j = 1; j <= limit; j++) {
+    int checkPos = (pos + j) % maxCells;
+    if (laneGrid[checkPos] != -1) {
+      return j;
+    }
+  }
+  return limit + 1;
+}
+
+int LaneChangeRule::distanceBehind(const int *laneGrid, int maxCells, int pos, int limit) {
+  for (int j = 1; j <= limit; j++) {
+    int checkPos = ((pos - j) % maxCells + maxCells) % maxCells;
+    if (laneGrid[checkPos] != -1) {
+      return j;
+    }
+  }
+  return limit + 1;
+}
+
+namespace {
+
+// Grid dense: lajur l mulai di grid + l * maxCells
+struct GridLanes {
+  const int *grid;
+  int maxCells;
+
+  int ringLength() const { return maxCells; }
+  int distanceAhead(int lane, int pos, int limit) const {
+    return LaneChangeRule::distanceAhead(grid + lane * maxCells, maxCells, pos, limit);
+  }
+  int distanceBehind(int lane, int pos, int limit) const {
+    return LaneChangeRule::distanceBehind(grid + lane * maxCells, maxCells, pos, limit);
+  }
+};
+
+struct SparseLanes {
+  const SparseOccupancy &occupancy;
+
+  int ringLength() const { return occupancy.getRingLength(); }
+  int distanceAhead(int lane, int pos, int limit) const { return occupancy.distanceAhead(lane, pos, limit); }
+  int distanceBehind(int lane, int pos, int limit) const { return occupancy.distanceBehind(lane, pos, limit); }
+};
+
+template <class Lanes>
+void decideWith(const Lanes &lanes, LaneChangeRule::Mode mode, float probChange,
+                const std::vector<std::shared_ptr<Vehicle>> &traffic, int numLanes, float maxV,
+                const CounterRng &rng, uint64_t step, int8_t *decisions, int begin, int end) {
+  // Arah yang diizinkan di step ini: genap → kiri (+1), ganjil → kanan (-1)
+  const int dir = (step % 2 == 0) ? 1 : -1;
+  const int lookAhead = (int)maxV + 1;
+  const int maxCells = lanes.ringLength();
+
+  for (int i = begin; i < end; i++) {
+    decisions[i] = 0;
+
+    const Vehicle &vehicle = *traffic[i];
+    int lane = vehicle.getLane();
+    int target = lane + dir;
+    if (target < 0 || target >= numLanes) continue;
+
+    int pos = (int)vehicle.getDistance() % maxCells;
+
+    // Seluruh panjang kendaraan (ekor sampai kepala) di lajur sebelah harus kosong
+    int length = std::min(vehicle.getLength(), maxCells);
+    int tail = ((pos - length + 1) % maxCells + maxCells) % maxCells;
+    if (lanes.distanceAhead(target, (tail - 1 + maxCells) % maxCells, length) <= length) continue;
+
+    // Grid menandai seluruh panjang kendaraan → gap bersih = jarak - 1
+    float v = vehicle.getVelocity();
+    int gapOwn = lanes.distanceAhead(lane, pos, lookAhead) - 1;
+    int gapOther = lanes.distanceAhead(target, pos, lookAhead) - 1;
+    int gapBack = lanes.distanceBehind(target, tail, lookAhead) - 1;
+
+    // Safety: tidak nabrak mobil depan, mobil belakang sempat ngerem
+    bool safe = (gapOther >= 0) && (gapBack >= (int)maxV);
+    if (!safe) continue;
+
+    bool incentive = gapOwn < v + 1.0f;   // Terhalang mobil depan
+    bool benefit = gapOther > gapOwn;      // Lajur tetangga lebih lega
+
+    bool change;
+    if (mode == LaneChangeRule::ASYMMETRIC && dir == -1) {
+      // Keep right: balik ke kanan kalau di sana bisa jalan dengan kecepatan sekarang
+      change = gapOther >= v + 1.0f;
+    } else {
+      change = incentive && benefit;
+    }
+
+    if (change && rng.uniform(CounterRng::STREAM_LANE_CHANGE, step, (uint32_t)i) < probChange) {
+      decisions[i] = (int8_t)dir;
+    }
+  }
+}
+
+}  // namespace
+
+void LaneChangeRule::decide(const std::vector<std::shared_ptr<Vehicle>> &traffic,
+                            const int *grid, int maxCells, int numLanes, float maxV,
+                            const CounterRng &rng, uint64_t step, int8_t *decisions,
+                            int begin, int end) const {
+  decideWith(GridLanes{grid, maxCells}, mode, probChange, traffic, numLanes, maxV, rng, step, decisions,
+             begin, end);
+}
+
+void LaneChangeRule::decide(const std::vector<std::shared_ptr<Vehicle>> &traffic,
+                            const SparseOccupancy &occupancy, int numLanes, float maxV,
+                            const CounterRng &rng, uint64_t step, int8_t *decisions,
+                            int begin, int end) const {
+  decideWith(SparseLanes{occupancy}, mode, probChange, traffic, numLanes, maxV, rng, step, decisions,
+             begin, end);
+}
+
+int LaneChangeRule::apply(std::vector<std::shared_ptr<Vehicle>> &traffic, const int8_t *decisions) {
+  int changed = 0;
+  for (int i = 0; i < (int)traffic.size(); i++) {
+    if (decisions[i] != 0) {
+      traffic[i]->setLane(traffic[i]->getLane() + decisions[i]);
+      changed++;
+    }
+  }
+  return changed;
+}
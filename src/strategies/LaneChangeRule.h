@@ -0,0 +1,90 @@
+#pragma once
+#include "../simulation/CounterRng.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SparseOccupancy;
+class Vehicle;
+
+/**
+ * LaneChangeRule - Fase pindah lajur (sebelum 4 aturan Nagel-Schreckenberg)
+ *
+ * Model lane-change NaSch multi-lajur (Rickert et al.):
+ * - Incentive: mobil di depan terlalu dekat di lajur sendiri
+ * - Benefit:   gap di lajur tetangga lebih besar
+ * - Safety:    gap ke mobil di BELAKANG di lajur tetangga cukup besar
+ * - Random:    pindah dengan probabilitas probChange
+ *
+ * Dua varian:
+ * - SYMMETRIC:  aturan sama untuk pindah kiri dan kanan
+ * - ASYMMETRIC: "keep right" - kembali ke lajur kanan kapan pun aman,
+ *               pindah ke kiri hanya untuk menyalip
+ *
+ * Skema dua pass (parallel-safe):
+ * 1. decide(): hanya MEMBACA grid lama, menulis keputusan per kendaraan ke
+ *    array sendiri → range kendaraan bisa dibagi ke banyak thread
+ * 2. apply(): terapkan semua keputusan sekaligus
+ *
+ * Supaya tidak ada dua mobil dari kiri dan kanan masuk ke lajur yang sama
+ * di step yang sama, arah pindah bergantian: step genap hanya ke kiri
+ * (lane + 1), step ganjil hanya ke kanan (lane - 1).
+ *
+ * Lajur 0 = lajur paling kanan (lajur lambat).
+ */
+class LaneChangeRule {
+public:
+  enum Mode {
+    SYMMETRIC,
+    ASYMMETRIC
+  };
+
+  LaneChangeRule(Mode mode = SYMMETRIC, float probChange = 0.5f);
+
+  /**
+   * Pass 1: hitung keputusan pindah lajur untuk kendaraan [begin, end)
+   *
+   * @param traffic Semua kendaraan di track
+   * @param grid Grid semua lajur (lajur l mulai di grid + l * maxCells)
+   * @param maxCells Jumlah cells per lajur
+   * @param numLanes Jumlah lajur
+   * @param maxV Kecepatan maksimal track (untuk jarak aman)
+   * @param rng Random generator berbasis counter
+   * @param step Nomor step simulasi
+   * @param decisions Output: -1 (kanan), 0 (tetap), +1 (kiri) per kendaraan
+   */
+  void decide(const std::vector<std::shared_ptr<Vehicle>>& traffic,
+              const int* grid, int maxCells, int numLanes, float maxV,
+              const CounterRng& rng, uint64_t step, int8_t* decisions,
+              int begin, int end) const;
+
+  // Sama, dengan SparseOccupancy sebagai ganti grid (road sangat panjang)
+  void decide(const std::vector<std::shared_ptr<Vehicle>>& traffic,
+              const SparseOccupancy& occupancy, int numLanes, float maxV,
+              const CounterRng& rng, uint64_t step, int8_t* decisions,
+              int begin, int end) const;
+
+  /**
+   * Pass 2: terapkan keputusan ke kendaraan
+   * @return Jumlah kendaraan yang pindah lajur
+   */
+  static int apply(std::vector<std::shared_ptr<Vehicle>>& traffic, const int8_t* decisions);
+
+  void setMode(Mode m) { mode = m; }
+  void setProbChange(float p) { probChange = p; }
+  Mode getMode() const { return mode; }
+  float getProbChange() const { return probChange; }
+
+  /**
+   * Jarak (dalam cells) ke cell terisi pertama di depan pos, maksimal limit.
+   * Return limit + 1 kalau tidak ada kendaraan dalam jangkauan.
+   */
+  static int distanceAhead(const int* laneGrid, int maxCells, int pos, int limit);
+
+  // Sama seperti distanceAhead(), tapi ke belakang
+  static int distanceBehind(const int* laneGrid, int maxCells, int pos, int limit);
+
+private:
+  Mode mode;
+  float probChange;
+};
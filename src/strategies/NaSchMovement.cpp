@@ -14,7 +14,9 @@
 NaSchMovement::NaSchMovement(int maxCells, float maxV, float probSlow)
     : maxCells(maxCells), maxV(maxV), probSlow(probSlow),
       grid(nullptr),      // Belum di-set, nanti di-set via setGrid()
-      gridSize(0)         // Belum di-set, nanti di-set via setGrid()
+      gridSize(0),        // Belum di-set, nanti di-set via setGrid()
+      rng(nullptr),       // Belum di-set: pakai ofRandom()
+      rngStep(0), rngIndex(0)
 {}
 
 /**
@@ -30,6 +32,12 @@ void NaSchMovement::setGrid(const int *gridPtr, int size) {
   gridSize = size;
 }
 
+void NaSchMovement::setRandom(const CounterRng *rng, uint64_t step, uint32_t index) {
+  this->rng = rng;
+  rngStep = step;
+  rngIndex = index;
+}
+
 /**
  * Update Vehicle dengan 4 Aturan Nagel-Schreckenberg
  *
@@ -54,16 +62,27 @@ void NaSchMovement::update(Vehicle &vehicle) {
  * Logic: Cek apakah ada vehicle lain di depan dalam jarak secepatatnya.
  * Gunakan grid untuk O(1) lookup (bukan O(n) loop).
  *
+ * Grid menandai SELURUH panjang tiap kendaraan (dari ekor sampai kepala),
+ * jadi cell terisi pertama di depan = EKOR (tail) kendaraan di depan.
+ * Gap bersih = j - 1, tidak perlu buffer carSize yang di-hardcode.
+ *
  * Contoh:
  * - Vehicle di posisi 100 dengan v = 5
  * - Cek: pos 101 (j=1), pos 102 (j=2), pos 103 (j=3)
- * - Kalau grid[103] != -1 → Ada vehicle! → v = 3 - 1 = 2
+ * - Kalau grid[103] != -1 → Ada ekor vehicle! → v = 3 - 1 = 2
  *
  * @param vehicle Reference ke Vehicle
  */
 void NaSchMovement::brake(Vehicle &vehicle) {
-  // Pastikan grid sudah di-set!
+  // Tanpa grid: jarak ke cell terisi pertama dari SparseOccupancy, sama
+  // dengan hasil scan di bawah
   if (grid == nullptr) {
+    if (leaderDistance > 0) {
+      if (leaderDistance <= (int)vehicle.getVelocity() + 1) {
+        vehicle.setVelocity(leaderDistance - 1);
+      }
+      return;
+    }
     MovementStrategy::brake(vehicle);
     return;
   }
@@ -71,13 +90,9 @@ void NaSchMovement::brake(Vehicle &vehicle) {
   float currentV = vehicle.getVelocity();
   int currentDist = (int)vehicle.getDistance();
 
-  // Car size dalam grid cells untuk collision detection
-  // Ini adalah jarak aman minimum antar mobil (braking distance buffer)
-  int carSize = 45;
-
-  // Kita check sejauh: Velocity + Ukuran Mobil
-  // Tujuannya: Supaya kita berhenti SEBELUM menabrak mobil di depan
-  int lookAhead = (int)currentV + carSize;
+  // Kita check sejauh: Velocity + 1
+  // Tujuannya: Supaya kita berhenti SEBELUM menabrak ekor mobil di depan
+  int lookAhead = (int)currentV + 1;
 
   for (int j = 1; j <= lookAhead; j++) {
     // Hitung posisi yang akan dicek dengan WRAPPING
@@ -87,20 +102,12 @@ void NaSchMovement::brake(Vehicle &vehicle) {
     if (checkPos >= 0 && checkPos < gridSize) {
       // Cek apakah ada vehicle di posisi ini
       if (grid[checkPos] != -1) {
-        // ADA VEHICLE DI DEPAN!
-
-        // Hitung jarak bersih (gap)
-        // gap = j - 1.
-        // Tapi kita butuh gap sebesar `carSize` supaya tidak overlap visually.
-        // Jadi effective gap = j - carSize.
-
-        int effectiveGap = j - carSize;
+        // ADA EKOR VEHICLE DI DEPAN!
 
-        // Velocity tidak boleh melebihi effective gap
-        // Jika effectiveGap < 0, berarti sudah nabrak/overlap -> stop (0)
-        if (effectiveGap < 0)
-          effectiveGap = 0;
+        // Hitung jarak bersih (gap) ke ekor kendaraan depan
+        int effectiveGap = j - 1;
 
+        // Velocity tidak boleh melebihi gap
         vehicle.setVelocity(effectiveGap);
 
         // Stop checking, kita sudah cari kendaraan terdekat
@@ -149,7 +156,8 @@ void NaSchMovement::move(Vehicle &vehicle) {
  */
 void NaSchMovement::randomize(Vehicle &vehicle) {
   if (vehicle.getVelocity() > 0) {
-    if (ofRandom(1.0f) < probSlow) {
+    float r = rng ? rng->uniform(CounterRng::STREAM_RANDOMIZE, rngStep, rngIndex) : ofRandom(1.0f);
+    if (r < probSlow) {
       vehicle.setVelocity(vehicle.getVelocity() - .02f);
     }
   }
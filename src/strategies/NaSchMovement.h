@@ -1,5 +1,7 @@
 ﻿#pragma once
 #include "MovementStrategy.h"
+#include "../simulation/CounterRng.h"
+#include <cstdint>
 
 /**
  * NaSchMovement - Concrete Strategy untuk Nagel-Schreckenberg Model
@@ -51,7 +53,8 @@ public:
  * Set grid array untuk lookup O(1)
  *
  * Grid adalah array 1D yang mapping posisi → indeks vehicle
- * grid[i] = j  → Vehicle indeks j ada di posisi i
+ * grid[i] = j  → Vehicle indeks j menempati posisi i
+ *                (seluruh panjang kendaraan ditandai, bukan cuma kepala)
  * grid[i] = -1 → Posisi i kosong
  *
  * @param gridPtr Pointer ke array grid
@@ -59,6 +62,28 @@ public:
  */
     void setGrid(const int* gridPtr, int gridSize);
 
+    /**
+ * Tanpa grid (track dengan SparseOccupancy): jarak ke cell terisi pertama
+ * di depan, dihitung track sebelum update(). brake() memakainya persis
+ * seperti scan grid. 0 = tidak di-set (brake() dasar MovementStrategy)
+ *
+ * @param cells Jarak dari head (>= 1)
+ */
+    void setLeaderDistance(int cells) { leaderDistance = cells; }
+
+    /**
+ * Sumber random untuk randomize() step ini
+ *
+ * Angka random = rng->uniform(STREAM_RANDOMIZE, step, index), jadi hasil
+ * simulasi hanya bergantung pada seed track (bisa diulang persis).
+ * Tanpa rng (nullptr) randomize() memakai ofRandom().
+ *
+ * @param rng Random generator track (tidak own, hanya borrow)
+ * @param step Nomor step simulasi track
+ * @param index Indeks kendaraan di track
+ */
+    void setRandom(const CounterRng* rng, uint64_t step, uint32_t index);
+
     void setMaxCells(int cells) { maxCells = cells; }
     void setMaxV(float v) { this->maxV = v; }
     void setProbSlow(float prob) { probSlow = prob; }
@@ -74,10 +99,12 @@ protected:
  * Logic: Cek apakah ada vehicle lain di depan dalam jarak secepatatnya.
  * Gunakan grid untuk O(1) lookup.
  *
+ * Cell terisi pertama di depan = ekor kendaraan depan.
+ *
  * Contoh:
  * - Vehicle di posisi 100 dengan v = 5
  * - Cek: pos 101 (j=1), pos 102 (j=2), pos 103 (j=3)
- * - Kalau di pos 103 ada vehicle lain → v = 3 - 1 = 2
+ * - Kalau di pos 103 ada ekor vehicle lain → v = 3 - 1 = 2
  */
     void brake(Vehicle& vehicle) override;
 
@@ -104,5 +131,11 @@ private:
     // Grid untuk O(1) lookup
     const int* grid;   // Pointer ke array grid (tidak own, hanya borrow)
     int gridSize;      // Ukuran grid array
+    int leaderDistance = 0;  // Tanpa grid: jarak ke cell terisi di depan
+
+    // Random berbasis counter (di-set tiap step oleh track)
+    const CounterRng* rng;
+    uint64_t rngStep;
+    uint32_t rngIndex;
 };
 
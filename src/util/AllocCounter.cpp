@@ -0,0 +1,127 @@
+#include "AllocCounter.h"
+
+#ifndef TJ_ALLOC_CHECK
+
+namespace alloc_counter {
+
+uint64_t threadAllocations() { return 0; }
+
+}  // namespace alloc_counter
+
+#else
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/**
+ * Pengganti global operator new / delete
+ *
+ * Semua bentuk (biasa, array, nothrow, aligned C++17) diarahkan ke
+ * malloc / aligned alloc dan dihitung. Counter per thread berupa POD
+ * thread_local supaya aman dipakai sebelum main() dan saat thread baru
+ * dibuat.
+ */
+namespace {
+
+thread_local uint64_t threadCount = 0;
+
+inline void count() {
+  threadCount++;
+}
+
+void* allocate(std::size_t size) {
+  count();
+  if (size == 0) size = 1;
+  for (;;) {
+    if (void* p = std::malloc(size)) return p;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void* allocateAligned(std::size_t size, std::size_t align) {
+  count();
+  if (size == 0) size = 1;
+#ifdef _WIN32
+  void* p = _aligned_malloc(size, align);
+#else
+  // aligned_alloc butuh size kelipatan alignment
+  if (align < sizeof(void*)) align = sizeof(void*);
+  void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void releaseAligned(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+
+}  // namespace
+
+namespace alloc_counter {
+
+uint64_t threadAllocations() { return threadCount; }
+
+}  // namespace alloc_counter
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void* operator new(std::size_t size, std::align_val_t align) { return allocateAligned(size, (std::size_t)align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocateAligned(size, (std::size_t)align); }
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+  try {
+    return allocateAligned(size, (std::size_t)align);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+  try {
+    return allocateAligned(size, (std::size_t)align);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+#endif  // TJ_ALLOC_CHECK
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * alloc_counter - Hitung alokasi heap per thread
+ *
+ * Dengan TJ_ALLOC_CHECK (build Debug), AllocCounter.cpp mengganti global
+ * operator new (semua bentuk), jadi SEMUA alokasi lewat new / std::vector /
+ * std::string / std::function ikut terhitung. Dipakai untuk memastikan
+ * frame steady state tidak alokasi sama sekali: baca threadAllocations()
+ * sebelum dan sesudah, selisihnya harus 0.
+ *
+ * Biayanya satu increment thread_local per new, tanpa state bersama antar
+ * thread. Tanpa TJ_ALLOC_CHECK (Release) allocator bawaan tidak diganti,
+ * threadAllocations() selalu 0 dan SteadyStateCheck tidak pernah melapor.
+ */
+namespace alloc_counter {
+
+// Jumlah operator new di thread pemanggil sejak thread dimulai (0 tanpa TJ_ALLOC_CHECK)
+uint64_t threadAllocations();
+
+/**
+ * SteadyStateCheck - Awasi satu loop (frame / step) yang harus bebas alokasi
+ *
+ * Frame yang tidak steady (tombol ditekan, mode berganti) memulai ulang
+ * warm-up: vector boleh tumbuh sampai kapasitasnya cukup. Setelah
+ * warmupFrames frame steady berturut-turut, alokasi apapun = pelanggaran.
+ */
+class SteadyStateCheck {
+public:
+  explicit SteadyStateCheck(int warmupFrames = 120) : warmupFrames(warmupFrames), warmupLeft(warmupFrames) {}
+
+  // Return true kalau frame ini melanggar (steady, lewat warm-up, dan alokasi > 0)
+  bool frame(bool steady, uint64_t allocations) {
+    if (!steady) {
+      warmupLeft = warmupFrames;
+      return false;
+    }
+    if (warmupLeft > 0) {
+      warmupLeft--;
+      return false;
+    }
+    if (allocations == 0) return false;
+    violations++;
+    return true;
+  }
+
+  uint64_t getViolations() const { return violations; }
+
+  // Log hanya pelanggaran ke 1, 2, 4, 8, ... supaya tidak membanjiri console
+  bool shouldReport() const { return violations > 0 && (violations & (violations - 1)) == 0; }
+
+private:
+  int warmupFrames;
+  int warmupLeft;
+  uint64_t violations = 0;
+};
+
+}  // namespace alloc_counter
@@ -0,0 +1,227 @@
+#include "ChildProcess.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+extern char** environ;
+#endif
+
+ChildProcess::~ChildProcess() {
+  if (started && !exited) wait();
+#ifdef _WIN32
+  if (processHandle) CloseHandle((HANDLE)processHandle);
+#endif
+}
+
+ChildProcess::ChildProcess(ChildProcess&& other) noexcept {
+  *this = std::move(other);
+}
+
+ChildProcess& ChildProcess::operator=(ChildProcess&& other) noexcept {
+  if (this != &other) {
+    std::swap(started, other.started);
+    std::swap(exited, other.exited);
+    std::swap(exitCode, other.exitCode);
+#ifdef _WIN32
+    std::swap(processHandle, other.processHandle);
+#else
+    std::swap(pid, other.pid);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+namespace {
+
+// Quote satu argumen supaya CommandLineToArgvW mengembalikannya persis
+void appendQuoted(std::string& cmd, const std::string& arg) {
+  if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos) {
+    cmd += arg;
+    return;
+  }
+  cmd += '"';
+  for (size_t i = 0;; i++) {
+    size_t backslashes = 0;
+    while (i < arg.size() && arg[i] == '\\') {
+      i++;
+      backslashes++;
+    }
+    if (i == arg.size()) {
+      cmd.append(backslashes * 2, '\\');
+      break;
+    }
+    if (arg[i] == '"') {
+      cmd.append(backslashes * 2 + 1, '\\');
+    } else {
+      cmd.append(backslashes, '\\');
+    }
+    cmd += arg[i];
+  }
+  cmd += '"';
+}
+
+}  // namespace
+
+bool ChildProcess::start(const std::string& executable, const std::vector<std::string>& args) {
+  if (started) return false;
+
+  std::string cmd;
+  appendQuoted(cmd, executable);
+  for (const std::string& arg : args) {
+    cmd += ' ';
+    appendQuoted(cmd, arg);
+  }
+
+  STARTUPINFOA si = {};
+  si.cb = sizeof(si);
+  PROCESS_INFORMATION pi = {};
+  if (!CreateProcessA(executable.c_str(), &cmd[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi)) {
+    return false;
+  }
+  CloseHandle(pi.hThread);
+
+  processHandle = pi.hProcess;
+  started = true;
+  exited = false;
+  return true;
+}
+
+bool ChildProcess::isRunning() {
+  if (!started || exited) return false;
+  if (WaitForSingleObject((HANDLE)processHandle, 0) != WAIT_OBJECT_0) return true;
+  wait();
+  return false;
+}
+
+int ChildProcess::wait() {
+  if (!started) return -1;
+  if (!exited) {
+    WaitForSingleObject((HANDLE)processHandle, INFINITE);
+    DWORD code = (DWORD)-1;
+    GetExitCodeProcess((HANDLE)processHandle, &code);
+    exitCode = (int)code;
+    exited = true;
+  }
+  return exitCode;
+}
+
+void ChildProcess::kill() {
+  if (started && !exited) {
+    TerminateProcess((HANDLE)processHandle, (UINT)-1);
+    wait();
+  }
+}
+
+std::string ChildProcess::currentExecutable(const char* argv0) {
+  char path[MAX_PATH];
+  DWORD n = GetModuleFileNameA(nullptr, path, MAX_PATH);
+  if (n == 0 || n == MAX_PATH) return argv0 ? argv0 : "";
+  return std::string(path, n);
+}
+
+uint64_t ChildProcess::currentProcessId() {
+  return GetCurrentProcessId();
+}
+
+bool ChildProcess::isProcessAlive(uint64_t processId) {
+  HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)processId);
+  if (process == nullptr) return false;
+  bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+  CloseHandle(process);
+  return alive;
+}
+
+#else
+
+bool ChildProcess::start(const std::string& executable, const std::vector<std::string>& args) {
+  if (started) return false;
+
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(executable.c_str()));
+  for (const std::string& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid_t child;
+  if (posix_spawn(&child, executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+    return false;
+  }
+
+  pid = child;
+  started = true;
+  exited = false;
+  return true;
+}
+
+bool ChildProcess::isRunning() {
+  if (!started || exited) return false;
+
+  int status = 0;
+  pid_t r = waitpid(pid, &status, WNOHANG);
+  if (r == 0) return true;
+  exitCode = (r == pid && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+  exited = true;
+  return false;
+}
+
+int ChildProcess::wait() {
+  if (!started) return -1;
+  if (!exited) {
+    int status = 0;
+    pid_t r;
+    do {
+      r = waitpid(pid, &status, 0);
+    } while (r < 0 && errno == EINTR);
+    exitCode = (r == pid && WIFEXITED(status)) ? WEXITSTATUS(status) : -1;
+    exited = true;
+  }
+  return exitCode;
+}
+
+void ChildProcess::kill() {
+  if (started && !exited) {
+    ::kill(pid, SIGKILL);
+    wait();
+  }
+}
+
+std::string ChildProcess::currentExecutable(const char* argv0) {
+#if defined(__APPLE__)
+  char path[4096];
+  uint32_t size = sizeof(path);
+  if (_NSGetExecutablePath(path, &size) == 0) return path;
+#elif defined(__linux__)
+  char path[4096];
+  ssize_t n = readlink("/proc/self/exe", path, sizeof(path) - 1);
+  if (n > 0) return std::string(path, (size_t)n);
+#endif
+  return argv0 ? argv0 : "";
+}
+
+uint64_t ChildProcess::currentProcessId() {
+  return (uint64_t)getpid();
+}
+
+bool ChildProcess::isProcessAlive(uint64_t processId) {
+  return ::kill((pid_t)processId, 0) == 0 || errno == EPERM;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * ChildProcess - Proses anak (executable + argumen), tanpa shell
+ *
+ * stdout / stderr diwarisi dari proses ini. Destructor menunggu proses
+ * selesai kalau belum di-wait(), jadi tidak ada zombie / handle bocor.
+ *
+ * Implementasi:
+ * - Windows: CreateProcess (argumen di-quote sesuai CommandLineToArgvW)
+ * - POSIX:   posix_spawn + waitpid
+ */
+class ChildProcess {
+public:
+  ChildProcess() = default;
+  ~ChildProcess();
+
+  ChildProcess(const ChildProcess&) = delete;
+  ChildProcess& operator=(const ChildProcess&) = delete;
+  ChildProcess(ChildProcess&& other) noexcept;
+  ChildProcess& operator=(ChildProcess&& other) noexcept;
+
+  // Jalankan executable dengan argumen (tanpa argv[0])
+  bool start(const std::string& executable, const std::vector<std::string>& args);
+
+  // true selama proses belum keluar (tidak blocking)
+  bool isRunning();
+
+  // Tunggu proses selesai. Exit code, -1 kalau tidak pernah jalan / dibunuh sinyal
+  int wait();
+
+  // Hentikan paksa (lalu wait())
+  void kill();
+
+  // Path executable proses ini (untuk menjalankan dirinya sendiri sebagai worker)
+  static std::string currentExecutable(const char* argv0);
+
+  static uint64_t currentProcessId();
+
+  // Proses pid masih hidup (worker memantau proses koordinator)
+  static bool isProcessAlive(uint64_t pid);
+
+private:
+  bool started = false;
+  bool exited = false;
+  int exitCode = -1;
+
+#ifdef _WIN32
+  void* processHandle = nullptr;  // HANDLE
+#else
+  int pid = -1;
+#endif
+};
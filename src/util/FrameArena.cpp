@@ -0,0 +1,46 @@
+#include "FrameArena.h"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t capacity)
+    : buffer(new uint8_t[capacity]), capacity(capacity), offset(0), used(0), peak(0) {}
+
+void* FrameArena::allocBytes(size_t bytes, size_t align) {
+  if (bytes == 0) bytes = 1;
+
+  // Blok aktif = blok overflow terakhir, atau blok utama kalau belum ada
+  uint8_t* base = overflow.empty() ? buffer.get() : overflow.back().data.get();
+  size_t size = overflow.empty() ? capacity : overflow.back().size;
+
+  uintptr_t addr = reinterpret_cast<uintptr_t>(base) + offset;
+  size_t pad = (align - (addr & (align - 1))) & (align - 1);
+
+  if (offset + pad + bytes > size) {
+    // Penuh: blok baru minimal dua kali lipat (warm-up saja, lihat reset)
+    size_t blockSize = std::max(bytes + align, std::max(size, capacity) * 2);
+    overflow.push_back({std::unique_ptr<uint8_t[]>(new uint8_t[blockSize]), blockSize});
+    base = overflow.back().data.get();
+    offset = 0;
+    addr = reinterpret_cast<uintptr_t>(base);
+    pad = (align - (addr & (align - 1))) & (align - 1);
+  }
+
+  void* out = base + offset + pad;
+  offset += pad + bytes;
+  used += pad + bytes;
+  return out;
+}
+
+void FrameArena::reset() {
+  peak = std::max(peak, used);
+
+  // Frame ini butuh blok tambahan → ganti blok utama dengan satu blok
+  // yang cukup untuk pemakaian puncak (alokasi hanya terjadi di sini)
+  if (!overflow.empty()) {
+    overflow.clear();
+    capacity = std::max(capacity * 2, peak + peak / 4);
+    buffer.reset(new uint8_t[capacity]);
+  }
+
+  offset = 0;
+  used = 0;
+}
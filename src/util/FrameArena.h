@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * FrameArena - Bump allocator untuk data sementara satu frame / step
+ *
+ * alloc() hanya menggeser pointer di dalam satu blok besar, jadi tidak
+ * ada malloc, lock allocator, atau page fault baru di steady state.
+ * Semua isi dibuang sekaligus oleh reset() di awal frame berikutnya:
+ * pointer dari alloc() TIDAK boleh disimpan melewati reset().
+ *
+ * Kalau blok penuh, alloc() mengambil blok tambahan dari heap (hanya
+ * saat warm-up). reset() berikutnya menggabungkan semua blok menjadi
+ * satu blok sebesar total pemakaian puncak, jadi frame selanjutnya
+ * kembali tanpa alokasi.
+ *
+ * Hanya untuk tipe trivially destructible (destructor tidak pernah
+ * dipanggil). Tidak thread-safe: satu arena per thread.
+ */
+class FrameArena {
+public:
+  explicit FrameArena(size_t capacity = 1 << 20);
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // Array count elemen T (tidak diinisialisasi)
+  template <typename T>
+  T* alloc(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "FrameArena tidak memanggil destructor");
+    return static_cast<T*>(allocBytes(count * sizeof(T), alignof(T)));
+  }
+
+  // Buang semua alokasi frame ini (blok tetap dipakai ulang)
+  void reset();
+
+  size_t getUsed() const { return used; }          // Byte terpakai frame ini
+  size_t getCapacity() const { return capacity; }  // Byte blok utama
+  size_t getPeak() const { return peak; }          // Pemakaian terbesar satu frame
+
+private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+  };
+
+  std::unique_ptr<uint8_t[]> buffer;  // Blok utama
+  size_t capacity;
+  size_t offset;  // Posisi bump di blok aktif
+  size_t used;
+  size_t peak;
+
+  std::vector<Block> overflow;  // Blok tambahan saat blok utama penuh
+
+  void* allocBytes(size_t bytes, size_t align);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * RingBuffer - Buffer kapasitas tetap, item baru menimpa yang paling lama
+ *
+ * Tidak thread-safe (satu pemilik). Alokasi hanya di constructor /
+ * reset(), push() tidak pernah alokasi. Indeks [0, size()) berurutan
+ * dari paling lama ke paling baru.
+ */
+template <typename T>
+class RingBuffer {
+public:
+  explicit RingBuffer(size_t capacity = 0) { reset(capacity); }
+
+  void reset(size_t capacity) {
+    items.assign(capacity, T());
+    next = 0;
+    pushed = 0;
+  }
+
+  void push(const T& item) {
+    if (items.empty()) return;
+    items[next] = item;
+    next = (next + 1) % items.size();
+    pushed++;
+  }
+
+  size_t size() const { return pushed < items.size() ? (size_t)pushed : items.size(); }
+  size_t capacity() const { return items.size(); }
+  bool empty() const { return size() == 0; }
+
+  // Total item yang pernah di-push (termasuk yang sudah tertimpa)
+  uint64_t getPushed() const { return pushed; }
+
+  const T& operator[](size_t i) const {
+    size_t oldest = (pushed < items.size()) ? 0 : next;
+    return items[(oldest + i) % items.size()];
+  }
+
+  const T& back() const { return (*this)[size() - 1]; }
+
+private:
+  std::vector<T> items;
+  size_t next = 0;
+  uint64_t pushed = 0;
+};
@@ -0,0 +1,197 @@
+#include "SharedMemory.h"
+#include <atomic>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SharedMemory::~SharedMemory() {
+  close();
+}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept {
+  *this = std::move(other);
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept {
+  if (this != &other) {
+    close();
+    std::swap(ptr, other.ptr);
+    std::swap(length, other.length);
+    std::swap(owner, other.owner);
+    std::swap(name, other.name);
+#ifdef _WIN32
+    std::swap(mappingHandle, other.mappingHandle);
+#endif
+  }
+  return *this;
+}
+
+std::string SharedMemory::uniqueName(const std::string& prefix) {
+  static std::atomic<uint32_t> counter{0};
+#ifdef _WIN32
+  const unsigned long pid = GetCurrentProcessId();
+#else
+  const unsigned long pid = (unsigned long)getpid();
+#endif
+  return prefix + "-" + std::to_string(pid) + "-" + std::to_string(counter.fetch_add(1));
+}
+
+#ifdef _WIN32
+
+bool SharedMemory::create(const std::string& regionName, size_t size) {
+  close();
+  if (size == 0) return false;
+
+  const std::string fullName = "Local\\" + regionName;
+  HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      (DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xffffffffu),
+                                      fullName.c_str());
+  if (mapping == nullptr) return false;
+  if (GetLastError() == ERROR_ALREADY_EXISTS) {
+    CloseHandle(mapping);
+    return false;
+  }
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    return false;
+  }
+
+  mappingHandle = mapping;
+  ptr = static_cast<uint8_t*>(view);
+  length = size;
+  owner = true;
+  name = regionName;
+  return true;
+}
+
+bool SharedMemory::open(const std::string& regionName) {
+  close();
+
+  const std::string fullName = "Local\\" + regionName;
+  HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, fullName.c_str());
+  if (mapping == nullptr) return false;
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    return false;
+  }
+
+  // Ukuran view dibulatkan ke halaman; pemakai menyimpan ukuran aslinya sendiri
+  MEMORY_BASIC_INFORMATION info;
+  VirtualQuery(view, &info, sizeof(info));
+
+  mappingHandle = mapping;
+  ptr = static_cast<uint8_t*>(view);
+  length = info.RegionSize;
+  owner = false;
+  name = regionName;
+  return true;
+}
+
+void SharedMemory::close() {
+  // Page file mapping hilang sendiri saat handle terakhir ditutup
+  if (ptr) UnmapViewOfFile(ptr);
+  if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+  ptr = nullptr;
+  length = 0;
+  owner = false;
+  name.clear();
+  mappingHandle = nullptr;
+}
+
+void SharedMemory::unlink() {
+  // Nama hilang bersama handle terakhir, tidak ada yang perlu dihapus
+  owner = false;
+}
+
+void SharedMemory::remove(const std::string&) {}
+
+#else
+
+bool SharedMemory::create(const std::string& regionName, size_t size) {
+  close();
+  if (size == 0) return false;
+
+  const std::string fullName = "/" + regionName;
+  int fd = shm_open(fullName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) return false;
+
+  if (ftruncate(fd, (off_t)size) != 0) {
+    ::close(fd);
+    shm_unlink(fullName.c_str());
+    return false;
+  }
+
+  void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);  // Mapping tetap hidup tanpa fd
+  if (view == MAP_FAILED) {
+    shm_unlink(fullName.c_str());
+    return false;
+  }
+
+  ptr = static_cast<uint8_t*>(view);
+  length = size;
+  owner = true;
+  name = regionName;
+  return true;
+}
+
+bool SharedMemory::open(const std::string& regionName) {
+  close();
+
+  const std::string fullName = "/" + regionName;
+  int fd = shm_open(fullName.c_str(), O_RDWR, 0600);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED) return false;
+
+  ptr = static_cast<uint8_t*>(view);
+  length = (size_t)st.st_size;
+  owner = false;
+  name = regionName;
+  return true;
+}
+
+void SharedMemory::close() {
+  if (ptr) munmap(ptr, length);
+  if (owner) shm_unlink(("/" + name).c_str());
+  ptr = nullptr;
+  length = 0;
+  owner = false;
+  name.clear();
+}
+
+void SharedMemory::unlink() {
+  if (owner) shm_unlink(("/" + name).c_str());
+  owner = false;
+}
+
+void SharedMemory::remove(const std::string& regionName) {
+  shm_unlink(("/" + regionName).c_str());
+}
+
+#endif
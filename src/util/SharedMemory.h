@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * SharedMemory - Region memori bernama yang bisa di-map beberapa proses
+ *
+ * Pembuat (create) memiliki nama: region dihapus saat close(). Proses lain
+ * membuka dengan nama yang sama (open) dan melihat byte yang sama; isi
+ * awal region nol. Sinkronisasi antar proses memakai std::atomic yang
+ * lock-free di dalam region (lihat SharedMemoryTransport).
+ *
+ * Implementasi:
+ * - Windows: CreateFileMapping (page file) + MapViewOfFile, nama "Local\\..."
+ * - POSIX:   shm_open + ftruncate + mmap(MAP_SHARED), nama "/..."
+ *
+ * Tidak bisa di-copy (pemilik tunggal mapping), tapi bisa di-move.
+ */
+class SharedMemory {
+public:
+  SharedMemory() = default;
+  ~SharedMemory();
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+  SharedMemory(SharedMemory&& other) noexcept;
+  SharedMemory& operator=(SharedMemory&& other) noexcept;
+
+  /**
+   * Buat region baru (read-write, isi nol)
+   * @param name Nama tanpa prefix platform (huruf, angka, '-', '_')
+   * @return false kalau nama sudah dipakai atau gagal dialokasi
+   */
+  bool create(const std::string& name, size_t size);
+
+  // Buka region yang sudah dibuat proses lain (read-write, ukuran dari pembuat)
+  bool open(const std::string& name);
+
+  // Unmap (+ hapus nama kalau pembuat). Aman dipanggil berkali-kali
+  void close();
+
+  // Pembuat: hapus nama sekarang (region tetap ter-map di semua proses),
+  // supaya tidak tertinggal kalau proses ini dibunuh sebelum close()
+  void unlink();
+
+  bool isOpen() const { return ptr != nullptr; }
+  uint8_t* data() const { return ptr; }
+  size_t size() const { return length; }
+
+  // Nama unik per proses: prefix-<pid>-<counter>
+  static std::string uniqueName(const std::string& prefix);
+
+  // Hapus nama yang tertinggal (pembuat mati sebelum close()). Windows:
+  // tidak perlu, mapping hilang bersama handle terakhir
+  static void remove(const std::string& name);
+
+private:
+  uint8_t* ptr = nullptr;
+  size_t length = 0;
+  bool owner = false;
+  std::string name;
+
+#ifdef _WIN32
+  void* mappingHandle = nullptr;  // HANDLE
+#endif
+};
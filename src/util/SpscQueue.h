@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * SpscQueue - Antrian lock-free single-producer single-consumer
+ *
+ * Ring buffer dengan kapasitas tetap (dibulatkan ke pangkat 2).
+ * Tepat SATU thread boleh push() dan tepat SATU thread lain boleh pop().
+ * Tidak ada mutex dan tidak ada alokasi setelah constructor, jadi aman
+ * dipanggil dari loop update/draw tanpa risiko stall.
+ *
+ * head dan tail ada di cache line berbeda supaya producer dan consumer
+ * tidak saling invalidasi (false sharing).
+ */
+template <typename T>
+class SpscQueue {
+public:
+  explicit SpscQueue(size_t capacity = 1024) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    slots.resize(cap);
+    mask = cap - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer: false kalau antrian penuh (item tidak dipindah)
+  bool push(T&& item) {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) > mask) return false;
+    slots[t & mask] = std::move(item);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool push(const T& item) {
+    T copy(item);
+    return push(std::move(copy));
+  }
+
+  // Consumer: false kalau antrian kosong
+  bool pop(T& out) {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    out = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Perkiraan jumlah item (bisa sudah basi saat dibaca)
+  size_t size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return mask + 1; }
+
+private:
+  std::vector<T> slots;
+  size_t mask = 0;
+
+  alignas(64) std::atomic<size_t> head{0};  // Ditulis consumer
+  alignas(64) std::atomic<size_t> tail{0};  // Ditulis producer
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+/**
+ * TripleBuffer - Serah terima state terbaru dari SATU producer ke SATU
+ * consumer tanpa lock dan tanpa saling menunggu
+ *
+ * Tiga slot: producer memegang "back", consumer memegang "front", dan
+ * slot ketiga ("middle") ada di atomic. publish() menukar back dengan
+ * middle, acquire() menukar front dengan middle kalau ada data baru.
+ * Producer tidak pernah menyentuh slot yang sedang dibaca consumer, jadi
+ * isi front tetap immutable selama consumer memakainya.
+ *
+ * Kalau producer lebih cepat, state di middle yang belum dibaca ditimpa
+ * (consumer selalu dapat yang TERBARU, bukan antrian). Slot dipakai ulang,
+ * jadi T dengan std::vector di dalamnya tidak alokasi lagi setelah
+ * kapasitasnya cukup.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer() : middle(1), back(0), front(2) {}
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // Producer: slot untuk diisi (isinya sisa state lama, timpa seluruhnya)
+  T& writeBuffer() { return slots[back]; }
+
+  // Producer: terbitkan writeBuffer(), lalu dapat slot baru untuk ditulis
+  void publish() {
+    uint8_t prev = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel);
+    back = prev & INDEX_MASK;
+  }
+
+  // Consumer: ambil state terbaru kalau ada. Return false kalau belum ada yang baru
+  bool acquire() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+    uint8_t prev = middle.exchange(front, std::memory_order_acq_rel);
+    front = prev & INDEX_MASK;
+    return true;
+  }
+
+  // Consumer: state terakhir yang di-acquire()
+  const T& readBuffer() const { return slots[front]; }
+
+private:
+  static const uint8_t INDEX_MASK = 0x3;
+  static const uint8_t FRESH = 0x4;  // Middle berisi state yang belum dibaca
+
+  T slots[3];
+  std::atomic<uint8_t> middle;
+  uint8_t back;   // Hanya disentuh producer
+  uint8_t front;  // Hanya disentuh consumer
+};
@@ -0,0 +1,85 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cstdint>
+
+WorkerPool::WorkerPool(int count)
+    : job(nullptr), jobContext(nullptr), jobCount(0), jobChunks(0), generation(0), pending(0), stopping(false) {
+  if (count < 0) {
+    count = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+  }
+  threads.reserve(count);
+  for (int i = 0; i < count; i++) {
+    threads.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
+void WorkerPool::runChunk(int worker) const {
+  if (worker >= jobChunks) return;
+
+  // Chunk k = [count * k / chunks, count * (k + 1) / chunks)
+  int begin = (int)((int64_t)jobCount * worker / jobChunks);
+  int end = (int)((int64_t)jobCount * (worker + 1) / jobChunks);
+  if (begin < end) {
+    job(jobContext, worker, begin, end);
+  }
+}
+
+void WorkerPool::run(int count, int minChunk, ChunkFn fn, const void* ctx) {
+  if (count <= 0) return;
+
+  int chunks = std::min(getWorkerCount(), (count + std::max(1, minChunk) - 1) / std::max(1, minChunk));
+  if (chunks <= 1) {
+    fn(ctx, 0, 0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = fn;
+    jobContext = ctx;
+    jobCount = count;
+    jobChunks = chunks;
+    pending = (int)threads.size();
+    generation++;
+  }
+  wake.notify_all();
+
+  // Main thread = worker 0
+  runChunk(0);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return pending == 0; });
+  job = nullptr;
+  jobContext = nullptr;
+}
+
+void WorkerPool::workerLoop(int worker) {
+  unsigned seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+    }
+
+    // Worker tanpa chunk (count kecil) tetap lapor selesai
+    runChunk(worker);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0) {
+      done.notify_one();
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool - Thread pool kecil dengan parallelFor() partisi statis
+ *
+ * Thread dibuat sekali di constructor dan tidur di condition variable
+ * sampai ada pekerjaan. parallelFor() membagi [0, count) menjadi chunk
+ * BERURUTAN (chunk k = worker k), main thread ikut mengerjakan chunk 0,
+ * lalu menunggu semua chunk selesai.
+ *
+ * Partisi statis (bukan work stealing) sengaja dipilih: isi buffer per
+ * worker selalu mewakili range indeks yang sama, jadi hasil gabungan
+ * berurutan worker 0..N-1 identik dengan loop serial.
+ *
+ * Callback TIDAK boleh memanggil API GL / ofSetColor dsb (hanya main
+ * thread yang punya GL context).
+ */
+class WorkerPool {
+public:
+  // threads < 0: hardware_concurrency - 1 (main thread dihitung sebagai worker 0)
+  explicit WorkerPool(int threads = -1);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Jumlah worker termasuk main thread (= jumlah buffer per-thread yang dibutuhkan)
+  int getWorkerCount() const { return (int)threads.size() + 1; }
+
+  /**
+   * Jalankan fn(worker, begin, end) di semua chunk dan tunggu sampai selesai
+   * @param minChunk Ukuran chunk minimal; workload kecil tidak dipecah
+   *                 (overhead bangunkan thread > kerjanya)
+   *
+   * fn dipanggil lewat pointer fungsi + pointer ke lambda (bukan
+   * std::function), jadi lambda dengan banyak capture pun tidak alokasi.
+   */
+  template <typename Fn>
+  void parallelFor(int count, int minChunk, const Fn& fn) {
+    run(count, minChunk, &invokeRange<Fn>, &fn);
+  }
+
+private:
+  using ChunkFn = void (*)(const void* ctx, int worker, int begin, int end);
+
+  template <typename Fn>
+  static void invokeRange(const void* ctx, int worker, int begin, int end) {
+    (*static_cast<const Fn*>(ctx))(worker, begin, end);
+  }
+
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  // Job aktif (dibaca worker setelah generation berubah)
+  ChunkFn job;
+  const void* jobContext;
+  int jobCount;
+  int jobChunks;
+  unsigned generation;
+  int pending;  // Chunk yang belum selesai (di luar chunk main thread)
+  bool stopping;
+
+  void run(int count, int minChunk, ChunkFn fn, const void* ctx);
+  void workerLoop(int worker);
+  void runChunk(int worker) const;
+};